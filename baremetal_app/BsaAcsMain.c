@@ -56,8 +56,7 @@ createPeInfoTable(
   uint32_t Status;
   uint64_t *PeInfoTable;
 
-  PeInfoTable = val_aligned_alloc(SIZE_4K, sizeof(HART_INFO_TABLE) +
-                                (PLATFORM_OVERRIDE_PE_CNT * sizeof(HART_INFO_ENTRY)));
+  PeInfoTable = val_aligned_alloc(SIZE_4K, val_hart_get_info_table_size());
 
   Status = val_hart_create_info_table(PeInfoTable);
 
@@ -72,13 +71,8 @@ createGicInfoTable(
 {
   uint32_t Status;
   uint64_t *GicInfoTable;
-  uint32_t gic_info_end_index = 1; //Additional index for mem alloc to store the end value(0xff)
 
-  GicInfoTable = val_aligned_alloc(SIZE_4K, sizeof(GIC_INFO_TABLE)
-                  + ((PLATFORM_OVERRIDE_GICITS_COUNT
-                  + PLATFORM_OVERRIDE_GICC_GICRD_COUNT + PLATFORM_OVERRIDE_GICR_GICRD_COUNT
-                  + PLATFORM_OVERRIDE_GICC_COUNT + PLATFORM_OVERRIDE_GICD_COUNT
-                  + gic_info_end_index) * sizeof(GIC_INFO_ENTRY)));
+  GicInfoTable = val_aligned_alloc(SIZE_4K, val_gic_get_info_table_size());
 
   Status = val_gic_create_info_table(GicInfoTable);
 
@@ -92,8 +86,7 @@ createTimerInfoTable(
 {
   uint64_t   *TimerInfoTable;
 
-  TimerInfoTable = val_aligned_alloc(SIZE_4K, sizeof(TIMER_INFO_TABLE)
-                   + (PLATFORM_OVERRIDE_TIMER_COUNT * sizeof(TIMER_INFO_GTBLOCK)));
+  TimerInfoTable = val_aligned_alloc(SIZE_4K, val_timer_get_info_table_size());
 
   val_timer_create_info_table(TimerInfoTable);
 }
@@ -104,8 +97,7 @@ createWatchdogInfoTable(
 {
   uint64_t *WdInfoTable;
 
-  WdInfoTable = val_aligned_alloc(SIZE_4K, sizeof(WD_INFO_TABLE)
-                + (PLATFORM_OVERRIDE_WD_TIMER_COUNT * sizeof(WD_INFO_BLOCK)));
+  WdInfoTable = val_aligned_alloc(SIZE_4K, val_wd_get_info_table_size());
 
   val_wd_create_info_table(WdInfoTable);
 }
@@ -118,8 +110,7 @@ createPcieVirtInfoTable(
   uint64_t   *PcieInfoTable;
   uint64_t   *IoVirtInfoTable;
 
-  PcieInfoTable = val_aligned_alloc(SIZE_4K, (sizeof(PCIE_INFO_TABLE)
-                  + (PLATFORM_OVERRIDE_NUM_ECAM * sizeof(PCIE_INFO_BLOCK))));
+  PcieInfoTable = val_aligned_alloc(SIZE_4K, val_pcie_get_info_table_size());
   val_pcie_create_info_table(PcieInfoTable);
 
   IoVirtInfoTable = val_aligned_alloc(SIZE_4K, (sizeof(IOVIRT_INFO_TABLE)
@@ -140,8 +131,7 @@ createPeripheralInfoTable(
                         + (PLATFORM_OVERRIDE_PERIPHERAL_COUNT * sizeof(PERIPHERAL_INFO_BLOCK)));
   val_peripheral_create_info_table(PeripheralInfoTable);
 
-  MemoryInfoTable = val_aligned_alloc(SIZE_4K, sizeof(MEMORY_INFO_TABLE)
-                    + (PLATFORM_OVERRIDE_MEMORY_ENTRY_COUNT * sizeof(MEM_INFO_BLOCK)));
+  MemoryInfoTable = val_aligned_alloc(SIZE_4K, val_memory_get_info_table_size());
   val_memory_create_info_table(MemoryInfoTable);
 }
 
@@ -227,6 +217,8 @@ ShellAppMainbsa(
       g_execute_modules = &g_module_array[0];
   }
 
+  val_test_select_init();
+
   val_print(ACS_PRINT_TEST, " Creating Platform Information Tables\n", 0);
   Status = createPeInfoTable();
   if (Status)
@@ -287,6 +279,9 @@ print_test_status:
   val_print(ACS_PRINT_TEST, "  Tests Failed = %4d\n", g_bsa_tests_fail);
   val_print(ACS_PRINT_TEST, "     -------------------------------------------------------\n", 0);
 
+  val_profile_report(VAL_PROFILE_NUM_SLOWEST);
+  val_result_close();
+
   freeBsaAcsMem();
 
   val_print(ACS_PRINT_TEST, "\n      *** BSA tests complete. Reset the system. ***\n\n", 0);
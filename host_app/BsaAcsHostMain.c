@@ -0,0 +1,558 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+/*
+ * Host simulation entry point. Builds the VAL info tables from the mock PAL
+ * in platform/pal_host and drives the VAL hot paths (PCIe config access,
+ * memory map lookup, page table creation and multi HART dispatch) so that
+ * they can be profiled on a Linux host, for example with perf record.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "val/include/val_interface.h"
+#include "val/include/bsa_acs_val.h"
+#include "val/include/bsa_acs_common.h"
+#include "val/include/bsa_acs_pcie.h"
+#include "val/include/bsa_acs_memory.h"
+#include "val/include/bsa_acs_pgt.h"
+#include "platform/pal_host/include/pal_host.h"
+
+#define HOST_DEFAULT_ITERATIONS   10
+#define HOST_MEM_LOOKUPS_PER_ITER 100000
+#define HOST_DISPATCH_TEST_NUM    1
+#define HOST_TEST_PAYLOAD_US      200
+#define HOST_TBL_ALIGN            0x1000
+
+uint32_t g_pcie_p2p;
+uint32_t g_pcie_cache_present;
+
+uint32_t  g_print_level;
+uint32_t  g_sw_view[3] = {1, 1, 1}; //Operating System, Hypervisor, Platform Security
+uint32_t  *g_skip_test_num;
+uint32_t  g_num_skip;
+uint32_t  g_bsa_tests_total;
+uint32_t  g_bsa_tests_pass;
+uint32_t  g_bsa_tests_fail;
+uint64_t  g_stack_pointer;
+uint64_t  g_exception_ret_addr;
+uint64_t  g_ret_addr;
+uint32_t  g_wakeup_timeout;
+uint32_t  g_build_sbsa = 0;
+uint32_t  g_print_mmio;
+uint32_t  g_curr_module;
+uint32_t  g_enable_module;
+uint32_t  *g_execute_tests;
+uint32_t  g_num_tests = 0;
+uint32_t  *g_execute_modules;
+uint32_t  g_num_modules = 0;
+uint32_t  g_el1physkip = FALSE;
+uint32_t  g_perf_mode = FALSE;
+uint32_t  g_hart_park = TRUE;
+
+static uint32_t g_host_iterations = HOST_DEFAULT_ITERATIONS;
+static uint32_t g_host_test_num;
+
+/*
+ * Exception vector hooks of val/sys_arch_src/gic, which is not part of the
+ * host build. VAL only calls them on DT and bare-metal targets, and the
+ * host PAL reports neither.
+ */
+void
+val_gic_bsa_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void *))
+{
+  (void)exception_type;
+  (void)esr;
+}
+
+uint32_t
+bsa_gic_update_elr(uint64_t elr_value)
+{
+  (void)elr_value;
+  return 0;
+}
+
+static uint64_t
+host_elapsed_us(uint64_t start)
+{
+  return val_timer_ticks_to_us(val_timer_get_counter() - start);
+}
+
+uint32_t
+createHartInfoTable(void)
+{
+  uint64_t *HartInfoTable;
+
+  HartInfoTable = val_aligned_alloc(HOST_TBL_ALIGN, val_hart_get_info_table_size());
+  if (HartInfoTable == NULL)
+      return ACS_STATUS_ERR;
+
+  return val_hart_create_info_table(HartInfoTable);
+}
+
+uint32_t
+createPcieInfoTable(void)
+{
+  uint64_t *PcieInfoTable;
+
+  PcieInfoTable = val_aligned_alloc(HOST_TBL_ALIGN, val_pcie_get_info_table_size());
+  if (PcieInfoTable == NULL)
+      return ACS_STATUS_ERR;
+
+  val_pcie_create_info_table(PcieInfoTable);
+  return ACS_STATUS_PASS;
+}
+
+uint32_t
+createMemoryInfoTable(void)
+{
+  uint64_t *MemoryInfoTable;
+
+  MemoryInfoTable = val_aligned_alloc(HOST_TBL_ALIGN, val_memory_get_info_table_size());
+  if (MemoryInfoTable == NULL)
+      return ACS_STATUS_ERR;
+
+  val_memory_create_info_table(MemoryInfoTable);
+  return ACS_STATUS_PASS;
+}
+
+void
+freeBsaAcsMem(void)
+{
+  val_free_shared_mem();
+  val_memory_free_info_table();
+  val_pcie_free_info_table();
+  val_hart_free_info_table();
+  pal_host_pcie_free_ecam();
+}
+
+/**
+  @brief  Walk every function of every ECAM region the way enumeration
+          does: probe the vendor ID and, for populated functions, look up
+          the PCIe capability and an extended capability.
+
+  @param  None
+
+  @return None
+**/
+static void
+host_run_pcie_sweep(void)
+{
+  uint32_t iter, ecam, bus, dev, func;
+  uint32_t num_ecam, seg, end_bus;
+  uint32_t bdf, reg_value, cid_offset;
+  uint32_t num_func = 0;
+  uint32_t num_pcie = 0;
+  uint64_t start;
+  uint64_t elapsed_us;
+
+  num_ecam = (uint32_t)val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0);
+  if (num_ecam == 0)
+      return;
+
+  start = val_timer_get_counter();
+  for (iter = 0; iter < g_host_iterations; iter++) {
+      num_func = 0;
+      num_pcie = 0;
+      for (ecam = 0; ecam < num_ecam; ecam++) {
+          seg = (uint32_t)val_pcie_get_info(PCIE_INFO_SEGMENT, ecam);
+          end_bus = (uint32_t)val_pcie_get_info(PCIE_INFO_END_BUS, ecam);
+
+          for (bus = (uint32_t)val_pcie_get_info(PCIE_INFO_START_BUS, ecam); bus <= end_bus; bus++)
+              for (dev = 0; dev < PCIE_MAX_DEV; dev++)
+                  for (func = 0; func < PCIE_MAX_FUNC; func++) {
+                      bdf = PCIE_CREATE_BDF(seg, bus, dev, func);
+                      val_pcie_read_cfg(bdf, TYPE01_VIDR, &reg_value);
+                      if (reg_value == PCIE_UNKNOWN_RESPONSE)
+                          continue;
+
+                      num_func++;
+                      if (val_pcie_find_capability(bdf, PCIE_CAP, CID_PCIECS, &cid_offset) ==
+                          PCIE_SUCCESS)
+                          num_pcie++;
+                      val_pcie_find_capability(bdf, PCIE_ECAP, ECID_DPC, &cid_offset);
+                  }
+      }
+  }
+  elapsed_us = host_elapsed_us(start);
+
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: PCIe sweep functions found   : %d", num_func);
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: PCIe sweep with PCIe cap     : %d", num_pcie);
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: PCIe sweep per pass (us)     : %ld",
+            elapsed_us / g_host_iterations);
+}
+
+/**
+  @brief  Look up pseudo random addresses spread over the memory map and
+          one region beyond it
+
+  @param  None
+
+  @return None
+**/
+static void
+host_run_memory_lookup(void)
+{
+  uint64_t i, num_lookup;
+  uint64_t span, addr, attr;
+  uint64_t seed = 0x2545F4914F6CDD1DULL;
+  uint64_t num_normal = 0;
+  uint64_t start;
+  uint64_t elapsed_us;
+
+  span = (uint64_t)(g_pal_host_cfg.num_mem_region + 1) * g_pal_host_cfg.mem_region_size;
+  num_lookup = (uint64_t)g_host_iterations * HOST_MEM_LOOKUPS_PER_ITER;
+
+  start = val_timer_get_counter();
+  for (i = 0; i < num_lookup; i++) {
+      seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+      addr = g_pal_host_cfg.mem_base + ((seed >> 16) % span);
+      if (val_memory_get_info(addr, &attr) == MEMORY_TYPE_NORMAL)
+          num_normal++;
+  }
+  elapsed_us = host_elapsed_us(start);
+
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Memory map lookups           : %ld", num_lookup);
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Memory map normal hits       : %ld", num_normal);
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Memory map lookups (us)      : %ld", elapsed_us);
+}
+
+/**
+  @brief  Build an identity stage 1 page table covering every normal
+          memory region of the memory map, then tear it down
+
+  @param  None
+
+  @return None
+**/
+static void
+host_run_pgt(void)
+{
+  uint32_t iter, i;
+  uint32_t status = 0;
+  uint64_t start;
+  uint64_t elapsed_us;
+  uint64_t num_pages = 0;
+  uint64_t num_entries = 0;
+  pgt_descriptor_t pgt_desc;
+  pgt_stats_t pgt_stats;
+  memory_region_descriptor_t mem_desc[2];
+
+  if (g_pal_host_cfg.num_mem_region == 0)
+      return;
+
+  start = val_timer_get_counter();
+  for (iter = 0; (iter < g_host_iterations) && !status; iter++) {
+      val_memory_set(&pgt_desc, sizeof(pgt_desc), 0);
+      pgt_desc.ias = MMU_PGT_IAS;
+      pgt_desc.oas = MMU_PGT_OAS;
+      pgt_desc.stage = PGT_STAGE1;
+
+      /* One region per call, the table is extended after the first one */
+      for (i = 0; i < g_pal_host_cfg.num_mem_region; i += 2) {
+          val_memory_set(mem_desc, sizeof(mem_desc), 0);
+          mem_desc[0].physical_address = g_pal_host_cfg.mem_base +
+                                         ((uint64_t)i * g_pal_host_cfg.mem_region_size);
+          mem_desc[0].virtual_address = mem_desc[0].physical_address;
+          mem_desc[0].length = g_pal_host_cfg.mem_region_size;
+
+          status = val_pgt_create(mem_desc, &pgt_desc);
+          if (status)
+              break;
+
+          val_pgt_get_stats(&pgt_stats);
+          num_pages += pgt_stats.pages_used;
+          num_entries += pgt_stats.entries_written;
+      }
+
+      if (pgt_desc.pgt_base)
+          val_pgt_destroy(pgt_desc);
+  }
+  elapsed_us = host_elapsed_us(start);
+
+  if (status) {
+      val_print(ACS_PRINT_ERR, "\n HOST_PERF: Page table creation failed", 0);
+      return;
+  }
+
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Page table build per pass (us): %ld",
+            elapsed_us / g_host_iterations);
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Page table pages per pass     : %ld",
+            num_pages / g_host_iterations);
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Page table entries per pass   : %ld",
+            num_entries / g_host_iterations);
+}
+
+static void
+host_dispatch_payload(void)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+
+  val_set_status(index, RESULT_PASS(HOST_DISPATCH_TEST_NUM, 1));
+}
+
+/**
+  @brief  Run a trivial payload on every HART through val_run_test_payload
+
+  @param  None
+
+  @return None
+**/
+static void
+host_run_dispatch(void)
+{
+  uint32_t iter, i;
+  uint32_t num_hart = val_hart_get_num();
+  uint32_t num_fail = 0;
+  uint64_t start;
+  uint64_t elapsed_us;
+
+  start = val_timer_get_counter();
+  for (iter = 0; iter < g_host_iterations; iter++) {
+      for (i = 0; i < num_hart; i++)
+          val_set_status(i, RESULT_PENDING(HOST_DISPATCH_TEST_NUM));
+
+      val_run_test_payload(HOST_DISPATCH_TEST_NUM, num_hart, host_dispatch_payload, 0);
+
+      for (i = 0; i < num_hart; i++)
+          if (!IS_TEST_PASS(val_get_status(i)))
+              num_fail++;
+  }
+  elapsed_us = host_elapsed_us(start);
+
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Dispatch HARTs               : %d", num_hart);
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Dispatch failed HART runs    : %d", num_fail);
+  val_print(ACS_PRINT_TEST, "\n HOST_PERF: Dispatch per pass (us)       : %ld",
+            elapsed_us / g_host_iterations);
+}
+
+/**
+  @brief  Test payload which keeps each HART busy for a time that grows
+          with its index, so that the slowest HART stands out
+
+  @param  None
+
+  @return None
+**/
+static void
+host_test_payload(void)
+{
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint64_t start = val_timer_get_counter();
+
+  while (host_elapsed_us(start) < (uint64_t)HOST_TEST_PAYLOAD_US * (index + 1))
+      ;
+
+  val_set_status(index, RESULT_PASS(g_host_test_num, 1));
+}
+
+/**
+  @brief  Run a few tests through the same flow as the test pool, from
+          val_check_skip_module and val_initialize_test to
+          val_check_for_error, to feed the test profile
+
+  @param  None
+
+  @return None
+**/
+static void
+host_run_tests(void)
+{
+  uint32_t num_hart = val_hart_get_num();
+
+  val_print(ACS_PRINT_TEST, "\n\n", 0);
+
+  if (val_check_skip_module_id(ACS_HOST_TEST_NUM_BASE) || val_check_skip_module(ACS_HOST_TEST_NUM_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Host tests\n", 0);
+  } else {
+      g_host_test_num = ACS_HOST_TEST_NUM_BASE + 1;
+      if (val_initialize_test(g_host_test_num, "Host single HART test        ", 1) != ACS_STATUS_SKIP)
+          val_run_test_payload(g_host_test_num, 1, host_test_payload, 0);
+      val_check_for_error(g_host_test_num, 1, "HOST_1");
+
+      g_host_test_num = ACS_HOST_TEST_NUM_BASE + 2;
+      if (val_initialize_test(g_host_test_num, "Host all HART test           ", num_hart) != ACS_STATUS_SKIP)
+          val_run_test_payload(g_host_test_num, num_hart, host_test_payload, 0);
+      val_check_for_error(g_host_test_num, num_hart, "HOST_2");
+
+      g_host_test_num = ACS_HOST_TEST_NUM_BASE + 3;
+      if (val_initialize_test(g_host_test_num, "Host concurrent HART test    ", num_hart) != ACS_STATUS_SKIP)
+          val_run_test_payload_concurrent(g_host_test_num, num_hart, host_test_payload, 0);
+      val_check_for_error(g_host_test_num, num_hart, "HOST_3");
+  }
+
+  val_profile_report(VAL_PROFILE_NUM_SLOWEST);
+  val_result_close();
+}
+
+static void
+HelpMsg(const char *name)
+{
+  printf("\nUsage: %s [-c <config>] [-v <n>] [-n <n>] [-perf] [-nopark]\n"
+         "       [-json <file>] [-junit <file>] [-skip <list>] [-t <list>] [-m <list>]\n"
+         "Options:\n"
+         "-c      Simulated platform config file, see platform/pal_host/host_sim.cfg\n"
+         "-v      Verbosity of the Prints\n"
+         "        1 shows all prints, 5 shows Errors\n"
+         "-n      Number of passes of each workload, default %d\n"
+         "-perf   Also run the VAL micro benchmarks\n"
+         "-nopark Power secondary HARTs off after every payload instead of parking them\n"
+         "-json   Write one JSON line per test result to the file\n"
+         "-junit  Write the test results to the file as JUnit XML\n"
+         "-skip   Tests or modules to skip\n"
+         "-t      Only run these tests\n"
+         "-m      Only run the tests of these modules, given by module ID\n"
+         "        Lists are comma separated and take ranges, e.g. -t 1901,1902-1903\n"
+         "        A module ID skips or runs the whole module only as a single entry\n",
+         name, HOST_DEFAULT_ITERATIONS);
+}
+
+/**
+  @brief  Parse a comma separated list of test or module numbers and
+          ranges, e.g. "801,805-810,901", into a test selection list.
+
+  @param  arg   option value
+  @param  list  VAL_SELECT_SKIP, VAL_SELECT_TEST or VAL_SELECT_MODULE
+
+  @return 0 on success, 1 if the list is malformed
+**/
+static uint32_t
+host_parse_test_list(const char *arg, uint32_t list)
+{
+  char          *end;
+  unsigned long first;
+  unsigned long last;
+
+  while (*arg != '\0') {
+      if (!isdigit((unsigned char)*arg))
+          return 1;
+
+      first = strtoul(arg, &end, 10);
+      last = first;
+      if (*end == '-') {
+          if (!isdigit((unsigned char)end[1]))
+              return 1;
+          last = strtoul(end + 1, &end, 10);
+      }
+
+      if ((first >= VAL_TEST_NUM_MAX) || (last >= VAL_TEST_NUM_MAX) ||
+          val_test_select_add(list, (uint32_t)first, (uint32_t)last) != ACS_STATUS_PASS)
+          return 1;
+
+      if (*end == ',')
+          end++;
+      else if (*end != '\0')
+          return 1;
+      arg = end;
+  }
+
+  return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+  int      i;
+  uint32_t Status;
+
+  g_print_level = ACS_PRINT_TEST;
+
+  for (i = 1; i < argc; i++) {
+      if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc)) {
+          if (pal_host_cfg_load(argv[++i]))
+              return 1;
+      } else if ((strcmp(argv[i], "-v") == 0) && (i + 1 < argc)) {
+          g_print_level = (uint32_t)strtoul(argv[++i], NULL, 0);
+      } else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc)) {
+          g_host_iterations = (uint32_t)strtoul(argv[++i], NULL, 0);
+      } else if (strcmp(argv[i], "-perf") == 0) {
+          g_perf_mode = TRUE;
+      } else if (strcmp(argv[i], "-nopark") == 0) {
+          g_hart_park = FALSE;
+      } else if ((strcmp(argv[i], "-json") == 0) && (i + 1 < argc)) {
+          if (pal_host_result_open(ACS_RESULT_JSON, argv[++i]))
+              return 1;
+      } else if ((strcmp(argv[i], "-junit") == 0) && (i + 1 < argc)) {
+          if (pal_host_result_open(ACS_RESULT_JUNIT, argv[++i]))
+              return 1;
+      } else if ((strcmp(argv[i], "-skip") == 0) && (i + 1 < argc)) {
+          if (host_parse_test_list(argv[++i], VAL_SELECT_SKIP)) {
+              printf("Invalid parameter passed for -skip\n");
+              return 1;
+          }
+      } else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc)) {
+          if (host_parse_test_list(argv[++i], VAL_SELECT_TEST)) {
+              printf("Invalid parameter passed for -t\n");
+              return 1;
+          }
+      } else if ((strcmp(argv[i], "-m") == 0) && (i + 1 < argc)) {
+          if (host_parse_test_list(argv[++i], VAL_SELECT_MODULE)) {
+              printf("Invalid parameter passed for -m\n");
+              return 1;
+          }
+      } else {
+          HelpMsg(argv[0]);
+          return (strcmp(argv[i], "-h") == 0) ? 0 : 1;
+      }
+  }
+
+  if (g_print_level < ACS_PRINT_INFO)
+      g_print_level = ACS_PRINT_INFO;
+  else if (g_print_level > ACS_PRINT_ERR)
+      g_print_level = ACS_PRINT_ERR;
+
+  if (g_host_iterations == 0)
+      g_host_iterations = 1;
+
+  val_print(ACS_PRINT_TEST, "\n\n BSA Architecture Compliance Suite - Host Simulation\n\n", 0);
+  pal_host_cfg_print();
+
+  val_print(ACS_PRINT_TEST, "\n Creating Platform Information Tables\n", 0);
+  Status = createHartInfoTable();
+  if (Status) {
+      val_print_flush();
+      return 1;
+  }
+
+  if (createPcieInfoTable() || createMemoryInfoTable()) {
+      val_print(ACS_PRINT_ERR, " Info table allocation failed\n", 0);
+      val_print_flush();
+      return 1;
+  }
+
+  val_allocate_shared_mem();
+  if (g_perf_mode) {
+      val_shared_mem_benchmark(VAL_MAILBOX_BENCH_ITERATIONS);
+      val_dispatch_benchmark(VAL_DISPATCH_BENCH_ITERATIONS);
+  }
+
+  host_run_pcie_sweep();
+  host_run_memory_lookup();
+  host_run_pgt();
+  host_run_dispatch();
+  host_run_tests();
+  val_print(ACS_PRINT_TEST, "\n", 0);
+
+  freeBsaAcsMem();
+  val_print_flush();
+  pal_host_result_close();
+
+  return 0;
+}
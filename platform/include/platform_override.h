@@ -41,6 +41,12 @@
 #define PLATFORM_OVERRIDE_TIMEOUT_MEDIUM 0x1000
 #define PLATFORM_OVERRIDE_TIMEOUT_SMALL  0x10
 
+/* Change OVERRIDE to 1 and define the wall clock Timeout values (microseconds) */
+#define PLATFORM_OVERRIDE_TIMEOUT_US        0
+#define PLATFORM_OVERRIDE_TIMEOUT_LARGE_US  10000000
+#define PLATFORM_OVERRIDE_TIMEOUT_MEDIUM_US 1000000
+#define PLATFORM_OVERRIDE_TIMEOUT_SMALL_US  1000
+
 #define PLATFORM_OVERRIDE_EL2_VIR_TIMER_GSIV  28
 
 
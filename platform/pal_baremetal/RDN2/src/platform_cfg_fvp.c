@@ -50,6 +50,12 @@ uint32_t  g_num_modules      = sizeof(g_module_array)/sizeof(g_module_array[0]);
    purpose to complete BSA run on these systems */
 uint32_t  g_el1physkip       = FALSE;
 
+/* Set to TRUE to run the performance micro-benchmarks and report timing */
+uint32_t  g_perf_mode        = FALSE;
+
+/* Set to FALSE to power secondary HARTs off after every payload instead of parking them */
+uint32_t  g_hart_park        = TRUE;
+
 HART_INFO_TABLE platform_hart_cfg = {
 
     .header.num_of_hart = PLATFORM_OVERRIDE_PE_CNT,
@@ -37,6 +37,15 @@ extern uint32_t g_enable_module;
 #define ACS_PRINT_DEBUG 2      /* For Debug statements. contains register dumps etc */
 #define ACS_PRINT_INFO  1      /* Print all statements. Do not use unless really needed */
 
+/* Structured result streams. Each is kept in a memory buffer of
+   PAL_RESULT_BUFFER_SIZE bytes, g_pal_result_buffer, which can be dumped
+   after the run. With PAL_RESULT_UART defined, the JSON lines are sent to
+   the UART instead, one record per line. */
+#define ACS_RESULT_JSON        0
+#define ACS_RESULT_JUNIT       1
+#define ACS_RESULT_NUM_STREAM  2
+#define PAL_RESULT_BUFFER_SIZE 0x10000
+
 #define MEM_ALIGN_4K       0x1000
 #define MEM_ALIGN_8K       0x2000
 #define MEM_ALIGN_16K      0x4000
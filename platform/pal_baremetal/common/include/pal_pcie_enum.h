@@ -30,6 +30,7 @@
 #define TYPE01_RIDR        0x8
 
 #define PCIE_HEADER_TYPE(header_value) ((header_value >> 16) & 0x3)
+#define PCIE_HEADER_MFD(header_value)  ((header_value >> 16) & 0x80)
 #define BUS_NUM_REG_CFG(sub_bus, sec_bus, pri_bus) (sub_bus << 16 | sec_bus << 8 | bus)
 
 #define DEVICE_ID_OFFSET   16
@@ -56,6 +57,26 @@
 #define BAR_INCREMENT            0x100000
 
 #define PRI_BUS_CLEAR_MASK       0xFFFFFF00
+
+/* Device and function number as one 8-bit field, as ARI interprets it */
+#define PCIE_DEVFN(dev, func)    ((dev << 3) | func)
+#define PCIE_DEVFN_DEV(devfn)    (devfn >> 3)
+#define PCIE_DEVFN_FUNC(devfn)   (devfn & 0x7)
+#define PCIE_MAX_DEVFN           (PCIE_MAX_DEV * PCIE_MAX_FUNC)
+
+/* ARI extended capability and ARI forwarding in the parent port */
+#define ECID_ARI                 0x000E
+#define ARI_CAPR_OFFSET          0x4
+#define ARI_NFN_SHIFT            8
+#define ARI_NFN_MASK             0xFF
+#define DCAP2R_ARI_FWD           (1 << 5)
+#define DCTL2R_ARI_FWD_EN        (1 << 5)
+
+/* Bookkeeping of the single enumeration pass */
+#define PCIE_ENUM_NO_PARENT      0xFFFFFFFF
+#define PCIE_ENUM_MAX_BRIDGE     (PCIE_MAX_BUS + 1)
+#define PCIE_ENUM_MAX_CAP        48
+#define PCIE_ENUM_BDF_TABLE_SZ   8192   /* Same size as the VAL BDF table */
 #define BAR_REG(bar_reg_value) ((bar_reg_value >> 2) & 0x1)
 #define BAR_MEM(bar_reg_value) ((bar_reg_value & 0xF) >> 3)
 #define REG_MASK_SHIFT(bar_value) ((bar_value & MEM_BASE32_LIM_MASK) >> 16)
@@ -96,4 +117,6 @@ uint32_t pal_pci_cfg_read(uint32_t bus, uint32_t dev, uint32_t func, uint32_t of
 
 uint32_t pal_pcie_read_cfg(uint32_t seg, uint32_t bus, uint32_t dev, uint32_t func, uint32_t offset, uint32_t *value);
 
+uint32_t pal_pcie_check_device_valid(uint32_t bdf);
+
 #endif
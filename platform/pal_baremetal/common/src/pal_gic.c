@@ -20,6 +20,24 @@
 
 extern PLATFORM_OVERRIDE_GIC_INFO_TABLE platform_gic_cfg;
 
+/**
+  @brief  Count the IIC info entries described by the baremetal platform IIC
+          configuration, so that the caller can size the IIC info table.
+
+  @param  None
+
+  @return Number of IIC info entries, including the end marker, that
+          pal_gic_create_info_table will fill
+**/
+uint32_t
+pal_gic_get_info_entry_count(void)
+{
+  return platform_gic_cfg.num_gicc + platform_gic_cfg.num_gicc_rd +
+         platform_gic_cfg.num_gicr_rd + platform_gic_cfg.num_gicd +
+         platform_gic_cfg.num_gicits + platform_gic_cfg.num_gich +
+         platform_gic_cfg.num_msiframes + 1;
+}
+
 /**
   @brief  Populate information about the IIC sub-system at the input address.
 
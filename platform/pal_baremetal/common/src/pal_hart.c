@@ -103,6 +103,20 @@ PalAllocateSecondaryStack(uint64_t mpidr)
   }
 }
 
+/**
+  @brief  This API returns the number of HARTs in the baremetal platform HART
+          configuration, so that the caller can size the HART_INFO Table.
+
+  @param  None
+
+  @return  Number of HART_INFO entries pal_hart_create_info_table will fill
+**/
+uint32_t
+pal_hart_get_info_entry_count(void)
+{
+  return platform_hart_cfg.header.num_of_hart;
+}
+
 /**
   @brief  This API fills in the HART_INFO Table with information about the PEs in the
           system. This is achieved by parsing the ACPI - MADT table.
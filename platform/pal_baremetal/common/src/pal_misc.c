@@ -656,6 +656,70 @@ void pal_uart_print(int log, const char *fmt, ...)
         (void) log;
 }
 
+uint8_t  g_pal_result_buffer[ACS_RESULT_NUM_STREAM][PAL_RESULT_BUFFER_SIZE];
+uint32_t g_pal_result_used[ACS_RESULT_NUM_STREAM];
+
+/**
+  @brief  Checks whether a structured result stream is written. Both are
+          always kept.
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+
+  @return 1 if the stream is written, 0 otherwise
+**/
+uint32_t
+pal_result_stream_enabled(uint32_t stream)
+{
+  return (stream < ACS_RESULT_NUM_STREAM);
+}
+
+/**
+  @brief  Appends data to the memory buffer of a structured result stream,
+          or sends the JSON lines to the UART when PAL_RESULT_UART is
+          defined. Data that does not fit in the buffer is dropped.
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+  @param  data    bytes to write
+  @param  len     number of bytes
+
+  @return None
+**/
+void
+pal_result_write(uint32_t stream, char8_t *data, uint32_t len)
+{
+  uint32_t i;
+
+  if (stream >= ACS_RESULT_NUM_STREAM)
+      return;
+
+#ifdef PAL_RESULT_UART
+  if (stream == ACS_RESULT_JSON) {
+      for (i = 0; i < len; i++) {
+          (void)pal_uart_putc(data[i]);
+          if (data[i] == '\n')
+              (void)pal_uart_putc('\r');
+      }
+      return;
+  }
+#endif
+
+  for (i = 0; (i < len) && (g_pal_result_used[stream] < PAL_RESULT_BUFFER_SIZE); i++)
+      g_pal_result_buffer[stream][g_pal_result_used[stream]++] = data[i];
+}
+
+/**
+  @brief  Flushes the structured result streams. The memory buffers and the
+          UART need no flush.
+
+  @param  None
+
+  @return None
+**/
+void
+pal_result_flush(void)
+{
+}
+
 /**
   @brief Dump DTB to file
 
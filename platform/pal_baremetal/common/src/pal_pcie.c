@@ -24,6 +24,20 @@ extern PCIE_INFO_TABLE platform_pcie_cfg;
 extern PCIE_READ_TABLE platform_pcie_device_hierarchy;
 extern PERIPHERAL_INFO_TABLE  *g_peripheral_info_table;
 
+/**
+  @brief  Returns the number of ECAM regions in the baremetal platform PCIe
+          configuration, so that the caller can size the PCIe info table.
+
+  @param  None
+
+  @return Number of PCIE_INFO_BLOCK entries pal_pcie_create_info_table will fill
+**/
+uint32_t
+pal_pcie_get_info_entry_count(void)
+{
+  return platform_pcie_cfg.num_entries;
+}
+
 uint64_t
 pal_pcie_get_mcfg_ecam()
 {
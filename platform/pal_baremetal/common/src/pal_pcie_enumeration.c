@@ -19,6 +19,7 @@
 #include "platform_override_struct.h"
 
 extern PCIE_INFO_TABLE *g_pcie_info_table;
+extern pcie_device_bdf_table *g_pcie_bdf_table;
 
 uint32_t pcie_index = 0, enumerate = 1;
 /*64-bit address initialisation*/
@@ -36,6 +37,11 @@ uint32_t g_bar32_p_max;
 uint32_t g_np_bar_size = 0, g_p_bar_size = 0;
 uint32_t g_np_bus = 0, g_p_bus = 0;
 
+/*Bridges found by the enumeration pass, in seg/bus/dev/func format*/
+static uint32_t g_pcie_enum_bridge[PCIE_ENUM_MAX_BRIDGE];
+static uint32_t g_pcie_enum_num_bridge;
+static uint32_t g_pcie_bdf_max_entries;
+
 /**
   @brief   This API reads 32-bit data from PCIe config space pointed by Bus,
            Device, Function and register offset.
@@ -427,18 +433,198 @@ void pal_pcie_program_bar_reg(uint32_t bus, uint32_t dev, uint32_t func)
 }
 
 /**
-  @brief   This API performs the PCIe bus enumeration
+  @brief   This API walks the capability list or the extended capability list
+           of a function during enumeration and returns the offset of the
+           requested capability.
+  @param   bus,dev,func - Bus(8-bits), device(8-bits) & function(8-bits)
+  @param   cid          - Capability ID to look for
+  @param   ext          - 0 for the capability list, 1 for the extended list
+  @param   *cid_offset  - Offset of the capability in config space
+  @return  0 if found, PCIE_CAP_NOT_FOUND otherwise
+**/
+static uint32_t
+pal_pcie_enum_find_cap(uint32_t bus, uint32_t dev, uint32_t func, uint32_t cid,
+                       uint32_t ext, uint32_t *cid_offset)
+{
+  uint32_t reg_value;
+  uint32_t next_cap_offset;
+  uint32_t count = 0;
+
+  if (ext)
+      next_cap_offset = PCIE_ECAP_START;
+  else
+  {
+      pal_pci_cfg_read(bus, dev, func, TYPE01_CPR, &reg_value);
+      next_cap_offset = reg_value & TYPE01_CPR_MASK;
+  }
+
+  while (next_cap_offset && (count++ < PCIE_ENUM_MAX_CAP))
+  {
+      pal_pci_cfg_read(bus, dev, func, next_cap_offset, &reg_value);
+      if ((reg_value == 0) || (reg_value == 0xFFFFFFFF))
+          break;
+
+      if (ext)
+      {
+          if (((reg_value >> PCIE_ECAP_CIDR_SHIFT) & PCIE_ECAP_CIDR_MASK) == cid)
+          {
+              *cid_offset = next_cap_offset;
+              return 0;
+          }
+          next_cap_offset = (reg_value >> PCIE_ECAP_NCPR_SHIFT) & PCIE_ECAP_NCPR_MASK;
+      }
+      else
+      {
+          if ((reg_value & PCIE_CIDR_MASK) == cid)
+          {
+              *cid_offset = next_cap_offset;
+              return 0;
+          }
+          next_cap_offset = (reg_value >> PCIE_NCPR_SHIFT) & PCIE_NCPR_MASK;
+      }
+  }
+
+  return PCIE_CAP_NOT_FOUND;
+}
+
+/**
+  @brief   This API decides whether the functions of a bus are discovered
+           through the ARI Next Function Number chain. It is the case when
+           function 0 of the bus has the ARI capability and the port above
+           supports ARI forwarding, which is then enabled so that function
+           numbers above 7 are routed.
+  @param   bus    - Bus(8-bits) whose function 0 has been found
+  @param   parent - Bus/Dev/Func of the port above, PCIE_ENUM_NO_PARENT on the root bus
+  @return  1 if the bus is enumerated through ARI, 0 otherwise
+**/
+static uint32_t
+pal_pcie_enum_ari_enable(uint32_t bus, uint32_t parent)
+{
+  uint32_t p_bus, p_dev, p_func;
+  uint32_t cid_offset;
+  uint32_t reg_value;
+
+  if (parent == PCIE_ENUM_NO_PARENT)
+      return 0;
+
+  if (pal_pcie_enum_find_cap(bus, 0, 0, ECID_ARI, 1, &cid_offset))
+      return 0;
+
+  p_bus  = PCIE_EXTRACT_BDF_BUS(parent);
+  p_dev  = PCIE_EXTRACT_BDF_DEV(parent);
+  p_func = PCIE_EXTRACT_BDF_FUNC(parent);
+
+  if (pal_pcie_enum_find_cap(p_bus, p_dev, p_func, CID_PCIECS, 0, &cid_offset))
+      return 0;
+
+  pal_pci_cfg_read(p_bus, p_dev, p_func, cid_offset + DCAP2R_OFFSET, &reg_value);
+  if (!(reg_value & DCAP2R_ARI_FWD))
+      return 0;
+
+  pal_pci_cfg_read(p_bus, p_dev, p_func, cid_offset + DCTL2R_OFFSET, &reg_value);
+  pal_pci_cfg_write(p_bus, p_dev, p_func, cid_offset + DCTL2R_OFFSET,
+                    reg_value | DCTL2R_ARI_FWD_EN);
+
+  print(ACS_PRINT_INFO, "ARI forwarding enabled for bus %x\n", bus);
+  return 1;
+}
+
+/**
+  @brief   This API returns the next device/function number to probe on a bus.
+           Without ARI, functions 1-7 are only probed when function 0 is
+           present and has the multi-function bit set. With ARI, the Next
+           Function Number of the present function gives the next one.
+  @param   bus          - Bus(8-bits)
+  @param   devfn        - Device/function number just probed
+  @param   present      - 1 if a function answered at devfn
+  @param   header_value - Header type register of the function, if present
+  @param   ari          - 1 if the bus is enumerated through ARI
+  @return  Next device/function number, PCIE_MAX_DEVFN when the bus is done
+**/
+static uint32_t
+pal_pcie_enum_next_devfn(uint32_t bus, uint32_t devfn, uint32_t present,
+                         uint32_t header_value, uint32_t ari)
+{
+  uint32_t cid_offset;
+  uint32_t reg_value;
+  uint32_t next_fn;
+
+  if (ari)
+  {
+      if (!present ||
+          pal_pcie_enum_find_cap(bus, PCIE_DEVFN_DEV(devfn), PCIE_DEVFN_FUNC(devfn),
+                                 ECID_ARI, 1, &cid_offset))
+          return PCIE_MAX_DEVFN;
+
+      pal_pci_cfg_read(bus, PCIE_DEVFN_DEV(devfn), PCIE_DEVFN_FUNC(devfn),
+                       cid_offset + ARI_CAPR_OFFSET, &reg_value);
+      next_fn = (reg_value >> ARI_NFN_SHIFT) & ARI_NFN_MASK;
+
+      /* The chain ends at 0, anything not moving forward ends it as well */
+      return (next_fn > devfn) ? next_fn : PCIE_MAX_DEVFN;
+  }
+
+  if ((PCIE_DEVFN_FUNC(devfn) == 0) && (!present || !PCIE_HEADER_MFD(header_value)))
+      return devfn + PCIE_MAX_FUNC;
+
+  return devfn + 1;
+}
+
+/**
+  @brief   This API records a function found during enumeration in the BDF
+           table, applying the same filters as the VAL BDF table creation.
+  @param   bus,dev,func - Bus(8-bits), device(8-bits) & function(8-bits)
+  @return  None
+**/
+static void
+pal_pcie_enum_record_bdf(uint32_t bus, uint32_t dev, uint32_t func)
+{
+  uint32_t bdf;
+  uint32_t seg;
+  uint32_t cid_offset;
+
+  if (g_pcie_bdf_table == NULL)
+      return;
+
+  /* Skip PCI legacy functions */
+  if (pal_pcie_enum_find_cap(bus, dev, func, CID_PCIECS, 0, &cid_offset))
+      return;
+
+  seg = g_pcie_info_table->block[pcie_index].segment_num;
+  bdf = PCIE_CREATE_BDF(seg, bus, dev, func);
+  if (pal_pcie_check_device_valid(bdf))
+      return;
+
+  if (g_pcie_bdf_table->num_entries >= g_pcie_bdf_max_entries)
+  {
+      print(ACS_PRINT_WARN, "BDF table full, 0x%x not recorded\n", bdf);
+      return;
+  }
+
+  g_pcie_bdf_table->device[g_pcie_bdf_table->num_entries].bdf = bdf;
+  g_pcie_bdf_table->device[g_pcie_bdf_table->num_entries].rp_bdf = 0;
+  g_pcie_bdf_table->num_entries++;
+}
+
+/**
+  @brief   This API performs the PCIe bus enumeration of one bus and,
+           recursively, of the buses below its bridges
   @param   bus,sec_bus - Bus(8-bits), secondary bus (8-bits)
+  @param   parent      - Bus/Dev/Func of the port above, PCIE_ENUM_NO_PARENT on the root bus
   @return  sub_bus - Subordinate bus
 **/
-uint32_t pal_pcie_enumerate_device(uint32_t bus, uint32_t sec_bus)
+static uint32_t
+pal_pcie_enumerate_bus(uint32_t bus, uint32_t sec_bus, uint32_t parent)
 {
 
   uint32_t vendor_id;
-  uint32_t header_value;
+  uint32_t header_value = 0;
   uint32_t sub_bus = bus;
   uint32_t dev;
   uint32_t func;
+  uint32_t devfn;
+  uint32_t present;
+  uint32_t ari = 0;
   uint32_t class_code;
   uint32_t com_reg_value;
   uint32_t bar32_p_limit;
@@ -451,69 +637,90 @@ uint32_t pal_pcie_enumerate_device(uint32_t bus, uint32_t sec_bus)
   uint32_t bar32_np_base = g_bar32_np_start;
   uint64_t bar64_p_base = g_bar64_p_start;
 
-  for (dev = 0; dev < PCIE_MAX_DEV; dev++)
+  for (devfn = 0; devfn < PCIE_MAX_DEVFN;
+       devfn = pal_pcie_enum_next_devfn(bus, devfn, present, header_value, ari))
   {
-    for (func = 0; func < PCIE_MAX_FUNC; func++)
-    {
-        pal_pci_cfg_read(bus, dev, func, 0, &vendor_id);
-        if ((vendor_id == 0x0) || (vendor_id == 0xFFFFFFFF))
-                continue;
+    dev  = PCIE_DEVFN_DEV(devfn);
+    func = PCIE_DEVFN_FUNC(devfn);
 
-        /*Skip Hostbridge configuration*/
-        pal_pci_cfg_read(bus, dev, func, TYPE01_RIDR, &class_code);
-        if ((((class_code >> CC_BASE_SHIFT) & CC_BASE_MASK) == HB_BASE_CLASS) &&
-             (((class_code >> CC_SUB_SHIFT) & CC_SUB_MASK)) == HB_SUB_CLASS)
-                continue;
+    pal_pci_cfg_read(bus, dev, func, 0, &vendor_id);
+    present = !((vendor_id == 0x0) || (vendor_id == 0xFFFFFFFF));
+    if (!present)
+        continue;
 
-        print(ACS_PRINT_INFO, "The Vendor id read is %x\n", vendor_id);
-        print(ACS_PRINT_INFO, "Valid PCIe device found at %x %x %x\n ", bus, dev, func);
-        pal_pci_cfg_read(bus, dev, func, HEADER_OFFSET, &header_value);
-        if (PCIE_HEADER_TYPE(header_value) == TYPE1_HEADER)
-        {
-            print(ACS_PRINT_INFO, "TYPE1 HEADER found\n", 0);
+    pal_pci_cfg_read(bus, dev, func, HEADER_OFFSET, &header_value);
+    if (devfn == 0)
+        ari = pal_pcie_enum_ari_enable(bus, parent);
 
-            /* Enable memory access, Bus master enable and I/O access*/
-            pal_pci_cfg_read(bus, dev, func, COMMAND_REG_OFFSET, &com_reg_value);
-            pal_pci_cfg_write(bus, dev, func, COMMAND_REG_OFFSET, (com_reg_value | REG_ACC_DATA));
+    /*Skip Hostbridge configuration*/
+    pal_pci_cfg_read(bus, dev, func, TYPE01_RIDR, &class_code);
+    if ((((class_code >> CC_BASE_SHIFT) & CC_BASE_MASK) == HB_BASE_CLASS) &&
+         (((class_code >> CC_SUB_SHIFT) & CC_SUB_MASK)) == HB_SUB_CLASS)
+            continue;
 
-            pal_pci_cfg_write(bus, dev, func, BUS_NUM_REG_OFFSET, BUS_NUM_REG_CFG(0xFF, sec_bus, bus));
-            pal_pci_cfg_write(bus, dev, func, NON_PRE_FET_OFFSET, ((g_bar32_np_start >> 16) & 0xFFF0));
-            pal_pci_cfg_write(bus, dev, func, PRE_FET_OFFSET, ((g_bar32_p_start >> 16) & 0xFFF0));
-            sub_bus = pal_pcie_enumerate_device(sec_bus, (sec_bus+1));
-            pal_pci_cfg_write(bus, dev, func, BUS_NUM_REG_OFFSET, BUS_NUM_REG_CFG(sub_bus, sec_bus, bus));
-            sec_bus = sub_bus + 1;
+    print(ACS_PRINT_INFO, "The Vendor id read is %x\n", vendor_id);
+    print(ACS_PRINT_INFO, "Valid PCIe device found at %x %x %x\n ", bus, dev, func);
+    pal_pcie_enum_record_bdf(bus, dev, func);
 
-            /*Obtain the start memory base address and the final memory base address of 32 bit BAR*/
-            bar32_p_limit = g_bar32_p_max;
-            bar32_np_limit = g_bar32_np_max;
-            get_resource_base_32(bus, dev, func, bar32_p_base, bar32_np_base, bar32_p_limit, bar32_np_limit);
+    if (PCIE_HEADER_TYPE(header_value) == TYPE1_HEADER)
+    {
+        print(ACS_PRINT_INFO, "TYPE1 HEADER found\n", 0);
 
-            /*Obtain the start memory base address and the final memory base address of 64 bit BAR*/
-            get_resource_base_64(bus, dev, func, bar64_p_base, g_bar64_p_max);
+        /* Remember the bridge so that its primary bus is cleared without a rescan */
+        if (g_pcie_enum_num_bridge < PCIE_ENUM_MAX_BRIDGE)
+            g_pcie_enum_bridge[g_pcie_enum_num_bridge++] = PCIE_CREATE_BDF(0, bus, dev, func);
 
+        /* Enable memory access, Bus master enable and I/O access*/
+        pal_pci_cfg_read(bus, dev, func, COMMAND_REG_OFFSET, &com_reg_value);
+        pal_pci_cfg_write(bus, dev, func, COMMAND_REG_OFFSET, (com_reg_value | REG_ACC_DATA));
 
-            pal_pcie_rp_program_bar(bus, dev, func);
-            /*Update the base and limit values*/
-            bar32_p_base = g_bar32_p_start;
-            bar32_np_base = g_bar32_np_start;
-            bar64_p_base = g_bar64_p_start;
-        }
+        pal_pci_cfg_write(bus, dev, func, BUS_NUM_REG_OFFSET, BUS_NUM_REG_CFG(0xFF, sec_bus, bus));
+        pal_pci_cfg_write(bus, dev, func, NON_PRE_FET_OFFSET, ((g_bar32_np_start >> 16) & 0xFFF0));
+        pal_pci_cfg_write(bus, dev, func, PRE_FET_OFFSET, ((g_bar32_p_start >> 16) & 0xFFF0));
+        sub_bus = pal_pcie_enumerate_bus(sec_bus, (sec_bus+1), PCIE_CREATE_BDF(0, bus, dev, func));
+        pal_pci_cfg_write(bus, dev, func, BUS_NUM_REG_OFFSET, BUS_NUM_REG_CFG(sub_bus, sec_bus, bus));
+        sec_bus = sub_bus + 1;
 
-        if (PCIE_HEADER_TYPE(header_value) == TYPE0_HEADER)
-        {
-            print(ACS_PRINT_INFO, "END POINT found\n", 0);
-            pal_pcie_program_bar_reg(bus, dev, func);
-            sub_bus = sec_bus - 1;
-        }
-      }
+        /*Obtain the start memory base address and the final memory base address of 32 bit BAR*/
+        bar32_p_limit = g_bar32_p_max;
+        bar32_np_limit = g_bar32_np_max;
+        get_resource_base_32(bus, dev, func, bar32_p_base, bar32_np_base, bar32_p_limit, bar32_np_limit);
+
+        /*Obtain the start memory base address and the final memory base address of 64 bit BAR*/
+        get_resource_base_64(bus, dev, func, bar64_p_base, g_bar64_p_max);
+
+
+        pal_pcie_rp_program_bar(bus, dev, func);
+        /*Update the base and limit values*/
+        bar32_p_base = g_bar32_p_start;
+        bar32_np_base = g_bar32_np_start;
+        bar64_p_base = g_bar64_p_start;
+    }
+
+    if (PCIE_HEADER_TYPE(header_value) == TYPE0_HEADER)
+    {
+        print(ACS_PRINT_INFO, "END POINT found\n", 0);
+        pal_pcie_program_bar_reg(bus, dev, func);
+        sub_bus = sec_bus - 1;
     }
+  }
 
-    return sub_bus;
+  return sub_bus;
+}
+
+/**
+  @brief   This API performs the PCIe bus enumeration
+  @param   bus,sec_bus - Bus(8-bits), secondary bus (8-bits)
+  @return  sub_bus - Subordinate bus
+**/
+uint32_t pal_pcie_enumerate_device(uint32_t bus, uint32_t sec_bus)
+{
+  return pal_pcie_enumerate_bus(bus, sec_bus, PCIE_ENUM_NO_PARENT);
 }
 
 /**
     @brief   This API clears the primary bus number configured in the
-             Type1 Header.
+             Type1 Header of the bridges found by the last enumeration pass.
              Note: This is done to make sure the hardware is compatible
                    with Linux enumeration.
     @param:  None
@@ -522,35 +729,32 @@ uint32_t pal_pcie_enumerate_device(uint32_t bus, uint32_t sec_bus)
 void
 pal_clear_pri_bus()
 {
+    uint32_t index;
     uint32_t bus;
     uint32_t dev;
     uint32_t func;
     uint32_t bus_value;
-    uint32_t header_value;
-    uint32_t vendor_id;
 
-    for (bus = 0; bus <= g_pcie_info_table->block[pcie_index].end_bus_num; bus++)
+    for (index = 0; index < g_pcie_enum_num_bridge; index++)
     {
-        for (dev = 0; dev < PCIE_MAX_DEV; dev++)
-        {
-            for (func = 0; func < PCIE_MAX_FUNC; func++)
-            {
-                pal_pci_cfg_read(bus, dev, func, 0, &vendor_id);
-                if ((vendor_id == 0x0) || (vendor_id == 0xFFFFFFFF))
-                        continue;
-
-                pal_pci_cfg_read(bus, dev, func, HEADER_OFFSET, &header_value);
-                if (PCIE_HEADER_TYPE(header_value) == TYPE1_HEADER)
-                {
-                    pal_pci_cfg_read(bus, dev, func, BUS_NUM_REG_OFFSET, &bus_value);
-                    bus_value = bus_value & PRI_BUS_CLEAR_MASK;
-                    pal_pci_cfg_write(bus, dev, func, BUS_NUM_REG_OFFSET, bus_value);
-                }
-            }
-         }
-     }
+        bus  = PCIE_EXTRACT_BDF_BUS(g_pcie_enum_bridge[index]);
+        dev  = PCIE_EXTRACT_BDF_DEV(g_pcie_enum_bridge[index]);
+        func = PCIE_EXTRACT_BDF_FUNC(g_pcie_enum_bridge[index]);
+
+        pal_pci_cfg_read(bus, dev, func, BUS_NUM_REG_OFFSET, &bus_value);
+        bus_value = bus_value & PRI_BUS_CLEAR_MASK;
+        pal_pci_cfg_write(bus, dev, func, BUS_NUM_REG_OFFSET, bus_value);
+    }
+
+    g_pcie_enum_num_bridge = 0;
 }
 
+/**
+    @brief   This API enumerates every ECAM region in a single pass per bus
+             and fills the PCIe BDF table with the functions found.
+    @param:  None
+    @return: None
+**/
 void pal_pcie_enumerate(void)
 {
     uint32_t pri_bus, sec_bus;
@@ -560,6 +764,19 @@ void pal_pcie_enumerate(void)
          return;
     }
 
+    if (g_pcie_bdf_table == NULL)
+        g_pcie_bdf_table = pal_aligned_alloc(MEM_ALIGN_8K, PCIE_ENUM_BDF_TABLE_SZ);
+
+    if (g_pcie_bdf_table == NULL) {
+        print(ACS_PRINT_ERR, "\nPCIe BDF table allocation failed", 0);
+    } else {
+        g_pcie_bdf_table->num_entries = 0;
+        g_pcie_bdf_max_entries = (PCIE_ENUM_BDF_TABLE_SZ - sizeof(pcie_device_bdf_table)) /
+                                 sizeof(pcie_device_attr);
+    }
+
+    g_pcie_enum_num_bridge = 0;
+
     print(ACS_PRINT_INFO, "\nStarting Enumeration\n", 0);
     while (pcie_index < g_pcie_info_table->num_entries)
     {
@@ -571,6 +788,10 @@ void pal_pcie_enumerate(void)
     }
     enumerate = 0;
     pcie_index = 0;
+
+    if (g_pcie_bdf_table) {
+        print(ACS_PRINT_INFO, "\nNumber of BDFs found : %d\n", g_pcie_bdf_table->num_entries);
+    }
 }
 
 /**
@@ -189,6 +189,21 @@ uint32_t pal_peripheral_is_pcie(uint32_t seg, uint32_t bus, uint32_t dev, uint32
   return 0;
 }
 
+/**
+  @brief  This API returns the number of memory regions in the baremetal platform
+          memory configuration, so that the caller can size the MEMORY_INFO_TABLE.
+
+  @param  None
+
+  @return  Number of MEM_INFO_BLOCK entries, including the last entry marker,
+           pal_memory_create_info_table will fill
+**/
+uint32_t
+pal_memory_get_info_entry_count(void)
+{
+  return platform_mem_cfg.count + 1;
+}
+
 /**
   @brief  This API fills in the MEMORY_INFO_TABLE with information about memory in the
           system.
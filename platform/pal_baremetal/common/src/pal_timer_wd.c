@@ -22,6 +22,21 @@ extern PLATFORM_OVERRIDE_TIMER_INFO_TABLE platform_timer_cfg;
 extern WD_INFO_TABLE platform_wd_cfg;
 
 
+/**
+  @brief  This API returns the number of timer blocks in the baremetal platform
+          timer configuration, so that the caller can size the TIMER_INFO_TABLE.
+
+  @param  None
+
+  @return  Number of TIMER_INFO_GTBLOCK entries pal_timer_create_info_table will fill
+**/
+uint32_t
+pal_timer_get_info_entry_count(void)
+{
+  /* The platform configuration describes a single timer block */
+  return 1;
+}
+
 /**
   @brief  This API fills in the TIMER_INFO_TABLE with information about local and
           system timers in the system from baremetal platform timer configuration
@@ -82,6 +97,36 @@ pal_timer_get_counter_frequency(void)
   return PLATFORM_BM_TIMER_CNTFRQ;
 }
 
+/**
+  @brief  This API returns the current value of the physical system counter
+
+  @param  None
+
+  @return System counter value
+**/
+uint64_t
+pal_timer_get_counter(void)
+{
+  uint64_t count;
+
+  __asm__ volatile ("mrs %0, cntpct_el0" : "=r" (count));
+  return count;
+}
+
+
+/**
+  @brief  This API returns the number of Watchdogs in the baremetal platform
+          watchdog configuration, so that the caller can size the WD_INFO_TABLE.
+
+  @param  None
+
+  @return  Number of WD_INFO_BLOCK entries pal_wd_create_info_table will fill
+**/
+uint32_t
+pal_wd_get_info_entry_count(void)
+{
+  return platform_wd_cfg.header.num_wd;
+}
 
 /**
   @brief  This API fills in the WD_INFO_TABLE with information about Watchdogs
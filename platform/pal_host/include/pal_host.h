@@ -0,0 +1,68 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#ifndef __PAL_HOST_H__
+#define __PAL_HOST_H__
+
+#include <stdint.h>
+
+/* Limits of the simulated platform, enforced when the config file is loaded */
+#define PAL_HOST_MAX_HART        1024
+#define PAL_HOST_MAX_ECAM        64
+#define PAL_HOST_MAX_CAP         12    /* 16 byte capabilities between 0x40 and 0xFF */
+#define PAL_HOST_MAX_EXT_CAP     60    /* 64 byte capabilities between 0x100 and 0xFFF */
+#define PAL_HOST_MAX_MEM_REGION  4096
+
+/* ECAM space decoded per bus: 32 devices x 8 functions x 4KB */
+#define PAL_HOST_ECAM_BUS_SIZE   (32 * 8 * 0x1000)
+#define PAL_HOST_ECAM_FUNC_SIZE  0x1000
+
+#define PAL_HOST_VENDOR_ID       0x1AB4
+#define PAL_HOST_TIMER_FREQ      1000000000ULL  /* time counter runs in nanoseconds */
+
+/**
+  @brief  Shape of the simulated platform. Filled with defaults and then
+          overridden from the key = value config file given to the host
+          application, see platform/pal_host/host_sim.cfg.
+**/
+typedef struct {
+  uint32_t num_hart;          ///< Number of simulated HARTs
+  uint32_t hart_id_stride;    ///< Hart ID of HART n is n * hart_id_stride
+  uint32_t cache_line_size;   ///< Zicbom block size reported for every HART
+  uint32_t num_ecam;          ///< Number of ECAM regions, one per PCIe segment
+  uint32_t ecam_num_bus;      ///< Buses decoded by each ECAM region, starting at bus 0
+  uint32_t num_dev;           ///< Populated devices on each bus, device 0 is a root port
+  uint32_t num_func;          ///< Functions implemented by each populated device
+  uint32_t num_cap;           ///< Capabilities in each function's capability list
+  uint32_t num_ext_cap;       ///< Extended capabilities in each function's list
+  uint32_t num_mem_region;    ///< Entries in the memory map, alternating normal and device
+  uint64_t mem_base;          ///< Address of the first memory map entry
+  uint64_t mem_region_size;   ///< Size of each memory map entry
+} PAL_HOST_CFG;
+
+extern PAL_HOST_CFG g_pal_host_cfg;
+
+/* Hart ID of the simulated HART running on the calling thread */
+extern __thread uint64_t g_pal_host_hart_id;
+
+uint32_t pal_host_cfg_load(const char *path);
+void     pal_host_cfg_print(void);
+void     pal_host_pcie_free_ecam(void);
+uint32_t pal_host_result_open(uint32_t stream, const char *path);
+void     pal_host_result_close(void);
+
+#endif
@@ -0,0 +1,48 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+/** Begin config **/
+
+/* Compile time limits for the host simulation build. The simulated platform
+   itself (HART count, ECAM space, memory map) is sized at run time from the
+   configuration file passed to the host application, see pal_host.h */
+
+/* Settings */
+#define PLATFORM_OVERRIDE_PRINT_LEVEL  0x3     //The permissible levels are 1,2,3,4 and 5
+
+/* MMU PGT config parameters */
+#define PLATFORM_PAGE_SIZE              0x1000
+#define PLATFORM_OVERRIDE_MMU_PGT_IAS   48
+#define PLATFORM_OVERRIDE_MMU_PGT_OAS   48
+
+/* PCIe limits, the simulated ECAM may use any bus range below the maximum */
+#define PLATFORM_BM_OVERRIDE_PCIE_MAX_BUS      256
+#define PLATFORM_BM_OVERRIDE_PCIE_MAX_DEV      32
+#define PLATFORM_BM_OVERRIDE_PCIE_MAX_FUNC     8
+
+// This value is arbitrary and may have to be adjusted
+#define PLATFORM_BM_OVERRIDE_MAX_IRQ_CNT       0xFFFF
+
+#define PLATFORM_OVERRIDE_MAX_SID              32
+
+#define PLATFORM_OVERRIDE_TIMEOUT              0
+/* Define the Timeout values to be used */
+#define PLATFORM_BM_OVERRIDE_TIMEOUT_LARGE         0x1000000
+#define PLATFORM_BM_OVERRIDE_TIMEOUT_MEDIUM        0x100000
+#define PLATFORM_BM_OVERRIDE_TIMEOUT_SMALL         0x1000
+
+/** End config **/
@@ -0,0 +1,36 @@
+## @file
+ # Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ # SPDX-License-Identifier : Apache-2.0
+ #
+ # Licensed under the Apache License, Version 2.0 (the "License");
+ # you may not use this file except in compliance with the License.
+ # You may obtain a copy of the License at
+ #
+ #  http://www.apache.org/licenses/LICENSE-2.0
+ #
+ # Unless required by applicable law or agreed to in writing, software
+ # distributed under the License is distributed on an "AS IS" BASIS,
+ # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ # See the License for the specific language governing permissions and
+ # limitations under the License.
+ ##
+
+ set(PAL_SRC
+ ${ROOT_DIR}/platform/pal_host/src/pal_host_cfg.c
+ ${ROOT_DIR}/platform/pal_host/src/pal_host_hart.c
+ ${ROOT_DIR}/platform/pal_host/src/pal_host_memory.c
+ ${ROOT_DIR}/platform/pal_host/src/pal_host_misc.c
+ ${ROOT_DIR}/platform/pal_host/src/pal_host_pcie.c
+ ${ROOT_DIR}/platform/pal_host/src/pal_host_sysreg.c
+)
+
+# Create PAL library
+add_library(${PAL_LIB} STATIC ${PAL_SRC})
+
+target_include_directories(${PAL_LIB} PRIVATE
+ ${ROOT_DIR}/
+ ${ROOT_DIR}/val/include/
+ ${ROOT_DIR}/platform/pal_host/include/
+)
+
+unset(PAL_SRC)
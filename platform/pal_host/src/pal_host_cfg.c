@@ -0,0 +1,209 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "pal_host.h"
+
+#define PAL_HOST_CFG_LINE_MAX  256
+
+/* Default platform, used as is when no config file is given */
+PAL_HOST_CFG g_pal_host_cfg = {
+  .num_hart        = 8,
+  .hart_id_stride  = 1,
+  .cache_line_size = 64,
+  .num_ecam        = 2,
+  .ecam_num_bus    = 16,
+  .num_dev         = 4,
+  .num_func        = 2,
+  .num_cap         = 4,
+  .num_ext_cap     = 4,
+  .num_mem_region  = 64,
+  .mem_base        = 0x80000000ULL,
+  .mem_region_size = 0x10000000ULL,
+};
+
+typedef struct {
+  const char *name;
+  void       *field;
+  uint32_t   width;     ///< Size of the field in bytes
+  uint64_t   min;
+  uint64_t   max;
+} PAL_HOST_CFG_KEY;
+
+#define CFG_KEY(member, lo, hi) \
+  { #member, &g_pal_host_cfg.member, sizeof(g_pal_host_cfg.member), lo, hi }
+
+static const PAL_HOST_CFG_KEY cfg_keys[] = {
+  CFG_KEY(num_hart,        1, PAL_HOST_MAX_HART),
+  CFG_KEY(hart_id_stride,  1, 0x10000),
+  CFG_KEY(cache_line_size, 16, 4096),
+  CFG_KEY(num_ecam,        0, PAL_HOST_MAX_ECAM),
+  CFG_KEY(ecam_num_bus,    1, 256),
+  CFG_KEY(num_dev,         0, 32),
+  CFG_KEY(num_func,        1, 8),
+  CFG_KEY(num_cap,         0, PAL_HOST_MAX_CAP),
+  CFG_KEY(num_ext_cap,     0, PAL_HOST_MAX_EXT_CAP),
+  CFG_KEY(num_mem_region,  0, PAL_HOST_MAX_MEM_REGION),
+  CFG_KEY(mem_base,        0, 0xFFFFFFFFFFFFULL),
+  CFG_KEY(mem_region_size, 0x1000, 0x10000000000ULL),
+};
+
+#define CFG_NUM_KEYS  (sizeof(cfg_keys) / sizeof(cfg_keys[0]))
+
+/**
+  @brief  Strip leading and trailing white space from a string in place
+
+  @param  str  string to trim
+
+  @return pointer to the first non blank character
+**/
+static char *
+pal_host_cfg_trim(char *str)
+{
+  char *end;
+
+  while (isspace((unsigned char)*str))
+      str++;
+
+  end = str + strlen(str);
+  while ((end > str) && isspace((unsigned char)end[-1]))
+      end--;
+  *end = '\0';
+
+  return str;
+}
+
+/**
+  @brief  Set one configuration key from its string value
+
+  @param  name   key name
+  @param  value  value string, decimal or 0x prefixed hex
+  @param  line   line number, for error messages
+
+  @return 0 on success, 1 if the key or value is invalid
+**/
+static uint32_t
+pal_host_cfg_set(const char *name, const char *value, uint32_t line)
+{
+  uint32_t i;
+  uint64_t data;
+  char     *end;
+
+  for (i = 0; i < CFG_NUM_KEYS; i++) {
+      if (strcmp(cfg_keys[i].name, name) != 0)
+          continue;
+
+      data = strtoull(value, &end, 0);
+      if ((*value == '\0') || (*end != '\0')) {
+          fprintf(stderr, " HOST_CFG: line %d: bad value '%s' for %s\n", line, value, name);
+          return 1;
+      }
+
+      if ((data < cfg_keys[i].min) || (data > cfg_keys[i].max)) {
+          fprintf(stderr, " HOST_CFG: line %d: %s must be within 0x%llx - 0x%llx\n", line, name,
+                  (unsigned long long)cfg_keys[i].min, (unsigned long long)cfg_keys[i].max);
+          return 1;
+      }
+
+      if (cfg_keys[i].width == sizeof(uint32_t))
+          *(uint32_t *)cfg_keys[i].field = (uint32_t)data;
+      else
+          *(uint64_t *)cfg_keys[i].field = data;
+
+      return 0;
+  }
+
+  fprintf(stderr, " HOST_CFG: line %d: unknown key '%s'\n", line, name);
+  return 1;
+}
+
+/**
+  @brief  Load the simulated platform description from a config file.
+          Each line holds one "key = value" pair, '#' starts a comment.
+          Keys not present in the file keep their default value.
+
+  @param  path  config file path
+
+  @return 0 on success, 1 if the file cannot be read or has an invalid line
+**/
+uint32_t
+pal_host_cfg_load(const char *path)
+{
+  FILE     *fp;
+  char     buf[PAL_HOST_CFG_LINE_MAX];
+  char     *line;
+  char     *sep;
+  uint32_t line_num = 0;
+  uint32_t status = 0;
+
+  fp = fopen(path, "r");
+  if (fp == NULL) {
+      fprintf(stderr, " HOST_CFG: cannot open %s\n", path);
+      return 1;
+  }
+
+  while (fgets(buf, sizeof(buf), fp) != NULL) {
+      line_num++;
+
+      sep = strchr(buf, '#');
+      if (sep != NULL)
+          *sep = '\0';
+
+      line = pal_host_cfg_trim(buf);
+      if (*line == '\0')
+          continue;
+
+      sep = strchr(line, '=');
+      if (sep == NULL) {
+          fprintf(stderr, " HOST_CFG: line %d: expected key = value\n", line_num);
+          status = 1;
+          continue;
+      }
+
+      *sep = '\0';
+      status |= pal_host_cfg_set(pal_host_cfg_trim(line), pal_host_cfg_trim(sep + 1), line_num);
+  }
+
+  fclose(fp);
+  return status;
+}
+
+/**
+  @brief  Print the simulated platform description in use
+
+  @param  None
+
+  @return None
+**/
+void
+pal_host_cfg_print(void)
+{
+  uint32_t i;
+
+  printf(" HOST_CFG: Simulated platform\n");
+  for (i = 0; i < CFG_NUM_KEYS; i++) {
+      if (cfg_keys[i].width == sizeof(uint32_t))
+          printf("   %-16s : %d\n", cfg_keys[i].name, *(uint32_t *)cfg_keys[i].field);
+      else
+          printf("   %-16s : 0x%llx\n", cfg_keys[i].name,
+                 (unsigned long long)*(uint64_t *)cfg_keys[i].field);
+  }
+}
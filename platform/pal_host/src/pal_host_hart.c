@@ -0,0 +1,298 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "pal_interface.h"
+#include "bsa_std_smc.h"
+#include "pal_host.h"
+
+#define PAL_HOST_HART_OFF  0
+#define PAL_HOST_HART_ON   1
+
+__thread uint64_t g_pal_host_hart_id;
+
+/* Power state of each simulated HART, indexed by HART number */
+static uint32_t *g_hart_state;
+
+/* Secondary HART entry point in VAL, reached through the PAL assembly entry on hardware */
+void val_test_entry(void);
+
+/**
+  @brief  Return the number of simulated HARTs the HART info table is filled with
+
+  @param  None
+
+  @return Number of HART info entries
+**/
+uint32_t
+pal_hart_get_info_entry_count(void)
+{
+  return g_pal_host_cfg.num_hart;
+}
+
+/**
+  @brief  Fill the HART info table with the simulated HARTs. The calling
+          thread becomes HART 0, the primary HART.
+
+  @param  HartTable  address where the HART information needs to be filled
+
+  @return None
+**/
+void
+pal_hart_create_info_table(HART_INFO_TABLE *HartTable)
+{
+  uint32_t         i;
+  HART_INFO_ENTRY  *Ptr;
+  HART_INFO_DETAIL *Detail;
+
+  if (HartTable == NULL) {
+      printf(" Input HART Table Pointer is NULL. Cannot create HART INFO\n");
+      return;
+  }
+
+  free(g_hart_state);
+  g_hart_state = calloc(g_pal_host_cfg.num_hart, sizeof(uint32_t));
+  if (g_hart_state == NULL) {
+      printf(" HART state allocation failed\n");
+      HartTable->header.num_of_hart = 0;
+      return;
+  }
+
+  HartTable->header.num_of_hart = g_pal_host_cfg.num_hart;
+  Detail = HART_INFO_DETAIL_BASE(HartTable);
+
+  for (i = 0; i < g_pal_host_cfg.num_hart; i++) {
+      Ptr = &HartTable->hart_info[i];
+      memset(Ptr, 0, sizeof(HART_INFO_ENTRY));
+      Ptr->hart_num           = i;
+      Ptr->hart_id            = (uint64_t)i * g_pal_host_cfg.hart_id_stride;
+      Ptr->acpi_processor_uid = i;
+      Ptr->cbom_block_size    = g_pal_host_cfg.cache_line_size;
+      snprintf(Detail[i].isa_string, sizeof(Detail[i].isa_string),
+               "rv64imafdch_zicbom_zicbop_zicboz_zicsr_zifencei_ssaia_svpbmt");
+  }
+
+  g_hart_state[0] = PAL_HOST_HART_ON;
+  g_pal_host_hart_id = HartTable->hart_info[0].hart_id;
+}
+
+/**
+  @brief  The host simulation emulates PSCI calls in this PAL
+
+  @param  None
+
+  @return CONDUIT_SBI
+**/
+int32_t
+pal_psci_get_conduit(void)
+{
+  return CONDUIT_SBI;
+}
+
+/**
+  @brief  Convert a hart ID to the index of the simulated HART
+
+  @param  hart_id  hart ID passed in the PSCI call
+
+  @return HART index, or num_hart if the hart ID is not simulated
+**/
+static uint32_t
+pal_host_hart_index(uint64_t hart_id)
+{
+  uint64_t index;
+
+  if (hart_id % g_pal_host_cfg.hart_id_stride)
+      return g_pal_host_cfg.num_hart;
+
+  index = hart_id / g_pal_host_cfg.hart_id_stride;
+  if (index >= g_pal_host_cfg.num_hart)
+      return g_pal_host_cfg.num_hart;
+
+  return (uint32_t)index;
+}
+
+/**
+  @brief  Thread body of a simulated secondary HART
+
+  @param  arg  hart ID of the HART that was powered on
+
+  @return NULL
+**/
+static void *
+pal_host_hart_thread(void *arg)
+{
+  g_pal_host_hart_id = (uint64_t)(uintptr_t)arg;
+  val_test_entry();
+
+  return NULL;
+}
+
+/**
+  @brief  Emulate PSCI CPU_ON by starting a thread that runs the VAL
+          secondary HART entry with its hart ID set.
+
+  @param  ArmSmcArgs  PSCI arguments, Arg1 is the target hart ID. Arg0
+                      returns the PSCI status.
+
+  @return None
+**/
+static void
+pal_host_cpu_on(ARM_SMC_ARGS *ArmSmcArgs)
+{
+  pthread_t      thread;
+  pthread_attr_t attr;
+  uint32_t       index;
+  uint32_t       expected = PAL_HOST_HART_OFF;
+
+  index = pal_host_hart_index(ArmSmcArgs->Arg1);
+  if (index >= g_pal_host_cfg.num_hart) {
+      ArmSmcArgs->Arg0 = (uint64_t)ARM_SMC_PSCI_RET_INVALID_PARAMS;
+      return;
+  }
+
+  if (!__atomic_compare_exchange_n(&g_hart_state[index], &expected, PAL_HOST_HART_ON, 0,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      ArmSmcArgs->Arg0 = (uint64_t)ARM_SMC_PSCI_RET_ALREADY_ON;
+      return;
+  }
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  if (pthread_create(&thread, &attr, pal_host_hart_thread, (void *)(uintptr_t)ArmSmcArgs->Arg1)) {
+      __atomic_store_n(&g_hart_state[index], PAL_HOST_HART_OFF, __ATOMIC_RELEASE);
+      ArmSmcArgs->Arg0 = (uint64_t)ARM_SMC_PSCI_RET_INTERN_FAIL;
+  } else {
+      ArmSmcArgs->Arg0 = ARM_SMC_PSCI_RET_SUCCESS;
+  }
+  pthread_attr_destroy(&attr);
+}
+
+/**
+  @brief  Emulate the PSCI calls used by VAL. CPU_ON starts a simulated
+          HART, CPU_OFF marks the calling HART off and returns so that its
+          thread can exit. Other calls are not supported.
+
+  @param  ArmSmcArgs  PSCI arguments, Arg0 returns the status
+  @param  Conduit     unused
+
+  @return None
+**/
+void
+pal_hart_call_smc(ARM_SMC_ARGS *ArmSmcArgs, int32_t Conduit)
+{
+  uint32_t index;
+
+  (void)Conduit;
+
+  switch (ArmSmcArgs->Arg0) {
+      case ARM_SMC_ID_PSCI_CPU_ON_AARCH64:
+          pal_host_cpu_on(ArmSmcArgs);
+          break;
+      case ARM_SMC_ID_PSCI_CPU_OFF:
+          index = pal_host_hart_index(g_pal_host_hart_id);
+          if (index < g_pal_host_cfg.num_hart)
+              __atomic_store_n(&g_hart_state[index], PAL_HOST_HART_OFF, __ATOMIC_RELEASE);
+          ArmSmcArgs->Arg0 = ARM_SMC_PSCI_RET_SUCCESS;
+          break;
+      default:
+          ArmSmcArgs->Arg0 = (uint64_t)ARM_SMC_PSCI_RET_NOT_SUPPORTED;
+          break;
+  }
+}
+
+/**
+  @brief  Start a payload on a secondary HART through PSCI CPU_ON
+
+  @param  ArmSmcArgs  PSCI arguments
+
+  @return None
+**/
+void
+pal_hart_execute_payload(ARM_SMC_ARGS *ArmSmcArgs)
+{
+  pal_hart_call_smc(ArmSmcArgs, CONDUIT_SBI);
+}
+
+/**
+  @brief  Host memory is coherent across threads, a full barrier gives the
+          ordering a cache maintenance operation gives on hardware.
+
+  @param  addr  address of the line, unused
+  @param  type  cache operation, unused
+
+  @return None
+**/
+void
+pal_hart_data_cache_ops_by_va(uint64_t addr, uint32_t type)
+{
+  (void)addr;
+  (void)type;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/**
+  @brief  Exceptions are not simulated on the host
+
+  @param  exception_type  exception type, unused
+  @param  esr             handler, unused
+
+  @return 0
+**/
+uint32_t
+pal_hart_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void *))
+{
+  (void)exception_type;
+  (void)esr;
+  return 0;
+}
+
+void
+pal_hart_update_elr(void *context, uint64_t offset)
+{
+  (void)context;
+  (void)offset;
+}
+
+uint64_t
+pal_hart_get_esr(void *context)
+{
+  (void)context;
+  return 0;
+}
+
+uint64_t
+pal_hart_get_far(void *context)
+{
+  (void)context;
+  return 0;
+}
+
+uint64_t
+pal_hart_get_hstatus(void)
+{
+  return 0;
+}
+
+void
+pal_hart_set_hstatus(uint64_t val)
+{
+  (void)val;
+}
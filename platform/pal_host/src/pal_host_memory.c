@@ -0,0 +1,125 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <stdio.h>
+
+#include "pal_interface.h"
+#include "pal_host.h"
+
+/**
+  @brief  Return the number of memory info entries, including the
+          MEMORY_TYPE_LAST_ENTRY terminator
+
+  @param  None
+
+  @return Number of memory info blocks
+**/
+uint32_t
+pal_memory_get_info_entry_count(void)
+{
+  return g_pal_host_cfg.num_mem_region + 1;
+}
+
+/**
+  @brief  Fill the memory info table with num_mem_region back to back
+          regions of mem_region_size bytes from mem_base. Even entries are
+          normal memory and odd entries are device memory, so lookups see
+          a map with many small entries like a fragmented UEFI memory map.
+
+  @param  memoryInfoTable  address where the memory information needs to be filled
+
+  @return None
+**/
+void
+pal_memory_create_info_table(MEMORY_INFO_TABLE *memoryInfoTable)
+{
+  uint32_t       i;
+  MEM_INFO_BLOCK *Ptr;
+
+  if (memoryInfoTable == NULL) {
+      printf(" Input Memory Table Pointer is NULL. Cannot create Memory INFO\n");
+      return;
+  }
+
+  Ptr = memoryInfoTable->info;
+  memoryInfoTable->dram_base = g_pal_host_cfg.mem_base;
+  memoryInfoTable->dram_size = 0;
+
+  for (i = 0; i < g_pal_host_cfg.num_mem_region; i++, Ptr++) {
+      Ptr->type      = (i & 1) ? MEMORY_TYPE_DEVICE : MEMORY_TYPE_NORMAL;
+      Ptr->phy_addr  = g_pal_host_cfg.mem_base + ((uint64_t)i * g_pal_host_cfg.mem_region_size);
+      Ptr->virt_addr = Ptr->phy_addr;
+      Ptr->size      = g_pal_host_cfg.mem_region_size;
+      Ptr->flags     = 0;
+
+      if (Ptr->type == MEMORY_TYPE_NORMAL)
+          memoryInfoTable->dram_size += Ptr->size;
+  }
+
+  Ptr->type = MEMORY_TYPE_LAST_ENTRY;
+}
+
+/**
+  @brief  Maps the physical memory region into the virtual address space.
+          Simulated memory is identity mapped.
+
+  @param  ptr   Pointer to physical memory region
+  @param  size  Size
+  @param  attr  Attributes
+
+  @return Pointer to mapped virtual address space
+**/
+uint64_t
+pal_memory_ioremap(void *ptr, uint32_t size, uint32_t attr)
+{
+  (void)size;
+  (void)attr;
+
+  return (uint64_t)ptr;
+}
+
+/**
+  @brief  Removes the physical memory to virtual address space mapping
+
+  @param  ptr  Pointer to mapped space
+
+  @return None
+**/
+void
+pal_memory_unmap(void *ptr)
+{
+  (void)ptr;
+}
+
+/**
+  @brief  Return the address of unpopulated memory of requested instance.
+          Everything above the last memory map entry is unpopulated, and
+          each instance is one region size further up.
+
+  @param  addr      - Address of the unpopulated memory
+  @param  instance  - Instance of memory
+
+  @return 0 on success
+**/
+uint64_t
+pal_memory_get_unpopulated_addr(uint64_t *addr, uint32_t instance)
+{
+  *addr = g_pal_host_cfg.mem_base +
+          ((uint64_t)(g_pal_host_cfg.num_mem_region + instance) * g_pal_host_cfg.mem_region_size);
+
+  return 0;
+}
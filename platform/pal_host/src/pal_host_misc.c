@@ -0,0 +1,729 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pal_interface.h"
+#include "pal_host.h"
+
+extern uint32_t g_print_mmio;
+extern uint32_t g_curr_module;
+extern uint32_t g_enable_module;
+
+static uint8_t *gSharedMemory;
+
+/**
+  @brief  Provides a single point of abstraction to read from all
+          Memory Mapped IO address
+
+  @param  addr 64-bit address
+
+  @return 8-bit data read from the input address
+**/
+uint8_t
+pal_mmio_read8(uint64_t addr)
+{
+  uint8_t data;
+
+  data = (*(volatile uint8_t *)addr);
+  if (g_print_mmio || (g_curr_module & g_enable_module))
+      printf(" pal_mmio_read8 Address = %llx  Data = %x\n", (unsigned long long)addr, data);
+
+  return data;
+}
+
+/**
+  @brief  Provides a single point of abstraction to read from all
+          Memory Mapped IO address
+
+  @param  addr 64-bit address
+
+  @return 16-bit data read from the input address
+**/
+uint16_t
+pal_mmio_read16(uint64_t addr)
+{
+  uint16_t data;
+
+  data = (*(volatile uint16_t *)addr);
+  if (g_print_mmio || (g_curr_module & g_enable_module))
+      printf(" pal_mmio_read16 Address = %llx  Data = %x\n", (unsigned long long)addr, data);
+
+  return data;
+}
+
+/**
+  @brief  Provides a single point of abstraction to read from all
+          Memory Mapped IO address
+
+  @param  addr 64-bit address
+
+  @return 64-bit data read from the input address
+**/
+uint64_t
+pal_mmio_read64(uint64_t addr)
+{
+  uint64_t data;
+
+  data = (*(volatile uint64_t *)addr);
+  if (g_print_mmio || (g_curr_module & g_enable_module))
+      printf(" pal_mmio_read64 Address = %llx  Data = %llx\n", (unsigned long long)addr,
+             (unsigned long long)data);
+
+  return data;
+}
+
+/**
+  @brief  Provides a single point of abstraction to read from all
+          Memory Mapped IO address
+
+  @param  addr 64-bit address
+
+  @return 32-bit data read from the input address
+**/
+uint32_t
+pal_mmio_read(uint64_t addr)
+{
+  uint32_t data;
+
+  data = (*(volatile uint32_t *)addr);
+  if (g_print_mmio || (g_curr_module & g_enable_module))
+      printf(" pal_mmio_read Address = %llx  Data = %x\n", (unsigned long long)addr, data);
+
+  return data;
+}
+
+/**
+  @brief  Provides a single point of abstraction to write to all
+          Memory Mapped IO address
+
+  @param  addr  64-bit address
+  @param  data  8-bit data to write to address
+
+  @return None
+**/
+void
+pal_mmio_write8(uint64_t addr, uint8_t data)
+{
+  if (g_print_mmio || (g_curr_module & g_enable_module))
+      printf(" pal_mmio_write8 Address = %llx  Data = %x\n", (unsigned long long)addr, data);
+
+  *(volatile uint8_t *)addr = data;
+}
+
+/**
+  @brief  Provides a single point of abstraction to write to all
+          Memory Mapped IO address
+
+  @param  addr  64-bit address
+  @param  data  16-bit data to write to address
+
+  @return None
+**/
+void
+pal_mmio_write16(uint64_t addr, uint16_t data)
+{
+  if (g_print_mmio || (g_curr_module & g_enable_module))
+      printf(" pal_mmio_write16 Address = %llx  Data = %x\n", (unsigned long long)addr, data);
+
+  *(volatile uint16_t *)addr = data;
+}
+
+/**
+  @brief  Provides a single point of abstraction to write to all
+          Memory Mapped IO address
+
+  @param  addr  64-bit address
+  @param  data  64-bit data to write to address
+
+  @return None
+**/
+void
+pal_mmio_write64(uint64_t addr, uint64_t data)
+{
+  if (g_print_mmio || (g_curr_module & g_enable_module))
+      printf(" pal_mmio_write64 Address = %llx  Data = %llx\n", (unsigned long long)addr,
+             (unsigned long long)data);
+
+  *(volatile uint64_t *)addr = data;
+}
+
+/**
+  @brief  Provides a single point of abstraction to write to all
+          Memory Mapped IO address
+
+  @param  addr  64-bit address
+  @param  data  32-bit data to write to address
+
+  @return None
+**/
+void
+pal_mmio_write(uint64_t addr, uint32_t data)
+{
+  if (addr & 0x3) {
+      printf("\n  Error-Input address is not aligned. Masking the last 2 bits\n");
+      addr = addr & ~(0x3ULL);  //make sure addr is aligned to 4 bytes
+  }
+
+  if (g_print_mmio || (g_curr_module & g_enable_module))
+      printf(" pal_mmio_write Address = %llx  Data = %x\n", (unsigned long long)addr, data);
+
+  *(volatile uint32_t *)addr = data;
+}
+
+/**
+  @brief  Sends a formatted string to stdout
+
+  @param  string  An ASCII string
+  @param  data    data for the formatted output
+
+  @return None
+**/
+void
+pal_print(char8_t *string, uint64_t data)
+{
+  printf(string, data);
+}
+
+/**
+  @brief  Writes out buffered console output
+
+  @param  None
+
+  @return None
+**/
+void
+pal_print_flush(void)
+{
+  fflush(stdout);
+}
+
+static FILE *g_host_result_file[ACS_RESULT_NUM_STREAM];
+
+/**
+  @brief  Open the file a structured result stream is written to
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+  @param  path    file to create
+
+  @return 0 on success, 1 if the file could not be opened
+**/
+uint32_t
+pal_host_result_open(uint32_t stream, const char *path)
+{
+  if (stream >= ACS_RESULT_NUM_STREAM)
+      return 1;
+
+  g_host_result_file[stream] = fopen(path, "w");
+  if (g_host_result_file[stream] == NULL) {
+      printf(" Failed to open result file %s\n", path);
+      return 1;
+  }
+
+  return 0;
+}
+
+/**
+  @brief  Close the files of all structured result streams
+
+  @param  None
+
+  @return None
+**/
+void
+pal_host_result_close(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < ACS_RESULT_NUM_STREAM; i++) {
+      if (g_host_result_file[i] != NULL)
+          fclose(g_host_result_file[i]);
+      g_host_result_file[i] = NULL;
+  }
+}
+
+/**
+  @brief  Checks whether a structured result stream has a file to go to
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+
+  @return 1 if the stream is written, 0 otherwise
+**/
+uint32_t
+pal_result_stream_enabled(uint32_t stream)
+{
+  return (stream < ACS_RESULT_NUM_STREAM) && (g_host_result_file[stream] != NULL);
+}
+
+/**
+  @brief  Appends data to a structured result stream
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+  @param  data    bytes to write
+  @param  len     number of bytes
+
+  @return None
+**/
+void
+pal_result_write(uint32_t stream, char8_t *data, uint32_t len)
+{
+  if (!pal_result_stream_enabled(stream))
+      return;
+
+  fwrite(data, 1, len, g_host_result_file[stream]);
+}
+
+/**
+  @brief  Writes out buffered structured result output
+
+  @param  None
+
+  @return None
+**/
+void
+pal_result_flush(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < ACS_RESULT_NUM_STREAM; i++)
+      if (g_host_result_file[i] != NULL)
+          fflush(g_host_result_file[i]);
+}
+
+/**
+  @brief  Sends a string to the output console without using the buffered
+          print path. The host has no UART, so this goes to stdout as well.
+
+  @param  addr    UART address, unused
+  @param  string  An ASCII string
+  @param  data    data for the formatted output
+
+  @return None
+**/
+void
+pal_print_raw(uint64_t addr, char8_t *string, uint64_t data)
+{
+  (void)addr;
+  printf(string, data);
+}
+
+/**
+  @brief  Device tree dump is not available on the host
+
+  @param  None
+
+  @return None
+**/
+void
+pal_dump_dtb(void)
+{
+}
+
+/**
+  @brief  The host simulation describes the platform through info tables
+          built by this PAL, neither through DT nor through baremetal config.
+
+  @param  None
+
+  @return 0
+**/
+uint32_t
+pal_target_is_dt(void)
+{
+  return 0;
+}
+
+/**
+  @brief  Checks if System information is passed using Baremetal (BM)
+
+  @param  None
+
+  @return 0
+**/
+uint32_t
+pal_target_is_bm(void)
+{
+  return 0;
+}
+
+/**
+  @brief  Allocates requested buffer size in bytes in a contiguous memory
+          and returns the base address of the range.
+
+  @param  Size         allocation size in bytes
+  @retval if SUCCESS   pointer to allocated memory
+  @retval if FAILURE   NULL
+**/
+void *
+pal_mem_alloc(uint32_t Size)
+{
+  return malloc(Size);
+}
+
+/**
+  @brief  Allocates requested buffer size in bytes with zeros in a contiguous memory
+          and returns the base address of the range.
+
+  @param  num          number of elements
+  @param  Size         element size in bytes
+  @retval if SUCCESS   pointer to allocated memory
+  @retval if FAILURE   NULL
+**/
+void *
+pal_mem_calloc(uint32_t num, uint32_t Size)
+{
+  return calloc(num, Size);
+}
+
+/**
+  @brief  Allocates cacheable memory for DMA. Host memory is always
+          cacheable and its physical address is its virtual address.
+
+  @param  bdf   BDF of the device the memory is for, unused
+  @param  Size  allocation size in bytes
+  @param  pa    returns the physical address of the buffer
+
+  @return pointer to the allocated memory, NULL on failure
+**/
+void *
+pal_mem_alloc_cacheable(uint32_t bdf, uint32_t Size, void **pa)
+{
+  void *buffer;
+
+  (void)bdf;
+  buffer = malloc(Size);
+  *pa = buffer;
+
+  return buffer;
+}
+
+/**
+  @brief  Frees memory allocated by pal_mem_alloc_cacheable
+
+  @param  bdf   BDF of the device, unused
+  @param  Size  allocation size in bytes, unused
+  @param  va    virtual address of the buffer
+  @param  pa    physical address of the buffer, unused
+
+  @return None
+**/
+void
+pal_mem_free_cacheable(uint32_t bdf, unsigned int Size, void *va, void *pa)
+{
+  (void)bdf;
+  (void)Size;
+  (void)pa;
+  free(va);
+}
+
+/**
+  @brief  Free the memory allocated by the PAL allocators
+  @param  Buffer the base address of the memory range to be freed
+
+  @return None
+**/
+void
+pal_mem_free(void *Buffer)
+{
+  free(Buffer);
+}
+
+/**
+  @brief  Allocates memory with the given alignment
+
+  @param  alignment  required alignment, a power of two
+  @param  size       allocation size in bytes
+
+  @return pointer to the allocated memory, NULL on failure
+**/
+void *
+pal_aligned_alloc(uint32_t alignment, uint32_t size)
+{
+  void *buffer;
+
+  if (alignment < sizeof(void *))
+      alignment = sizeof(void *);
+
+  if (posix_memalign(&buffer, alignment, size))
+      return NULL;
+
+  return buffer;
+}
+
+/**
+  @brief  Frees memory allocated by pal_aligned_alloc
+
+  @param  buffer  base address of the allocation
+
+  @return None
+**/
+void
+pal_mem_free_aligned(void *buffer)
+{
+  free(buffer);
+}
+
+/**
+  @brief  Returns the page size used for page table and page allocations
+
+  @param  None
+
+  @return page size in bytes
+**/
+uint32_t
+pal_mem_page_size(void)
+{
+  return PLATFORM_PAGE_SIZE;
+}
+
+/**
+  @brief  Allocates page aligned memory
+
+  @param  num_pages  number of pages to allocate
+
+  @return pointer to the allocated pages, NULL on failure
+**/
+void *
+pal_mem_alloc_pages(uint32_t num_pages)
+{
+  return pal_aligned_alloc(PLATFORM_PAGE_SIZE, num_pages * PLATFORM_PAGE_SIZE);
+}
+
+/**
+  @brief  Frees memory allocated by pal_mem_alloc_pages
+
+  @param  page_base  base address of the allocation
+  @param  num_pages  number of pages, unused
+
+  @return None
+**/
+void
+pal_mem_free_pages(void *page_base, uint32_t num_pages)
+{
+  (void)num_pages;
+  free(page_base);
+}
+
+/**
+  @brief  Host memory is identity mapped for the simulated platform
+
+  @param  va  virtual address
+
+  @return physical address
+**/
+void *
+pal_mem_virt_to_phys(void *va)
+{
+  return va;
+}
+
+/**
+  @brief  Host memory is identity mapped for the simulated platform
+
+  @param  pa  physical address
+
+  @return virtual address
+**/
+void *
+pal_mem_phys_to_virt(uint64_t pa)
+{
+  return (void *)pa;
+}
+
+/**
+  @brief  Adding MMIO mappings is not needed on the host
+
+  @param  Address  base of the MMIO region
+  @param  Length   size of the MMIO region
+
+  @return None
+**/
+void
+pal_mem_map_add_mmio(uint64_t Address, uint64_t Length)
+{
+  (void)Address;
+  (void)Length;
+}
+
+/**
+  @brief  Allocate memory which is to be used to share data across PEs
+
+  @param  num_hart    - Number of PEs in the system
+  @param  sizeofentry - Size of memory region allocated to each HART
+
+  @return None
+**/
+void
+pal_mem_allocate_shared(uint32_t num_hart, uint32_t sizeofentry)
+{
+  gSharedMemory = pal_mem_alloc(num_hart * sizeofentry);
+  pal_hart_data_cache_ops_by_va((uint64_t)&gSharedMemory, CLEAN_AND_INVALIDATE);
+}
+
+/**
+  @brief  Returns the base address of the shared memory region
+
+  @param  None
+
+  @return shared memory base address
+**/
+uint64_t
+pal_mem_get_shared_addr(void)
+{
+  return (uint64_t)gSharedMemory;
+}
+
+/**
+  @brief  Free the shared memory region allocated above
+
+  @param  None
+
+  @return  None
+**/
+void
+pal_mem_free_shared(void)
+{
+  free(gSharedMemory);
+  gSharedMemory = NULL;
+}
+
+/**
+  @brief  Compares two buffers
+
+  @param  src   first buffer
+  @param  dest  second buffer
+  @param  len   number of bytes to compare
+
+  @return 0 if the buffers match, non zero otherwise
+**/
+int
+pal_mem_compare(void *src, void *dest, uint32_t len)
+{
+  return memcmp(src, dest, len);
+}
+
+/**
+  @brief  Fills a buffer with a value
+
+  @param  buf    buffer to fill
+  @param  size   number of bytes to fill
+  @param  value  fill value
+
+  @return None
+**/
+void
+pal_mem_set(void *buf, uint32_t size, uint8_t value)
+{
+  memset(buf, value, size);
+}
+
+/**
+  @brief  Copies a source buffer to a destination buffer
+
+  @param  dest_buffer  destination buffer
+  @param  src_buffer   source buffer
+  @param  len          number of bytes to copy
+
+  @return destination buffer
+**/
+void *
+pal_memcpy(void *dest_buffer, void *src_buffer, uint32_t len)
+{
+  return memcpy(dest_buffer, src_buffer, len);
+}
+
+/**
+  @brief  Compares two strings
+
+  @param  str1  first string
+  @param  str2  second string
+  @param  len   maximum number of characters to compare
+
+  @return 0 if the strings match
+**/
+uint32_t
+pal_strncmp(char8_t *str1, char8_t *str2, uint32_t len)
+{
+  return (uint32_t)strncmp(str1, str2, len);
+}
+
+/**
+  @brief  Finds the first occurrence of a string in another
+
+  @param  str1  string to search
+  @param  str2  string to find
+
+  @return pointer to the match in str1, NULL if not found
+**/
+char8_t *
+pal_strstr(char8_t *str1, char8_t *str2)
+{
+  return strstr(str1, str2);
+}
+
+/**
+  @brief  Returns the time counter, which on the host is the monotonic
+          clock in nanoseconds.
+
+  @param  None
+
+  @return counter value in ticks of pal_timer_get_counter_frequency
+**/
+uint64_t
+pal_timer_get_counter(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * PAL_HOST_TIMER_FREQ) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+  @brief  Returns the frequency of the time counter
+
+  @param  None
+
+  @return counter frequency in Hz
+**/
+uint64_t
+pal_timer_get_counter_frequency(void)
+{
+  return PAL_HOST_TIMER_FREQ;
+}
+
+/**
+  @brief  Stalls the caller for the given number of milliseconds
+
+  @param  time_ms  delay in milliseconds
+
+  @return the delay requested
+**/
+uint64_t
+pal_time_delay_ms(uint64_t time_ms)
+{
+  struct timespec ts;
+
+  ts.tv_sec = time_ms / 1000;
+  ts.tv_nsec = (time_ms % 1000) * 1000000;
+  nanosleep(&ts, NULL);
+
+  return time_ms;
+}
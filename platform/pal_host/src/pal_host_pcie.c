@@ -0,0 +1,237 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pal_interface.h"
+#include "pal_host.h"
+
+/* Config space layout used to build the synthetic functions */
+#define HOST_CFG_VIDR          0x00
+#define HOST_CFG_CR            0x04
+#define HOST_CFG_RIDR          0x08
+#define HOST_CFG_HTR           0x0E
+#define HOST_CFG_PBN           0x18
+#define HOST_CFG_CPR           0x34
+#define HOST_CFG_CAP_START     0x40
+#define HOST_CFG_CAP_STRIDE    0x10
+#define HOST_CFG_ECAP_START    0x100
+#define HOST_CFG_ECAP_STRIDE   0x40
+
+#define HOST_SR_CAP_LIST       (1 << 20)  /* Capabilities List bit of the status register */
+#define HOST_HTR_MFD           0x80
+#define HOST_CLASS_BRIDGE_P2P  0x060400
+#define HOST_CLASS_NETWORK     0x020000
+
+#define HOST_CID_PCIECS        0x10
+#define HOST_PCIECR_RP         (0x4 << 4)
+#define HOST_PCIECR_EP         (0x0 << 4)
+#define HOST_PCIECR_VER        0x2
+
+/* Capabilities placed ahead of the PCIe capability, which is always last */
+static const uint8_t host_cap_ids[] = { 0x01, 0x05, 0x11, 0x09 };
+
+/* Extended capabilities cycled through the extended capability list */
+static const uint16_t host_ecap_ids[] = { 0x0001, 0x000D, 0x000F, 0x001B, 0x001D, 0x000E };
+
+static uint8_t *g_host_ecam[PAL_HOST_MAX_ECAM];
+
+static void
+host_cfg_write32(uint8_t *cfg, uint32_t offset, uint32_t data)
+{
+  memcpy(cfg + offset, &data, sizeof(data));
+}
+
+/**
+  @brief  Fill the config space of one populated function. Device 0 of each
+          bus is a root port with a type 1 header, the others are endpoints.
+          The PCIe capability closes the capability list so that finding it
+          walks the whole list.
+
+  @param  cfg   4KB config space of the function
+  @param  bus   bus number
+  @param  dev   device number
+  @param  func  function number
+
+  @return None
+**/
+static void
+pal_host_pcie_fill_function(uint8_t *cfg, uint32_t bus, uint32_t dev, uint32_t func)
+{
+  uint32_t i;
+  uint32_t offset;
+  uint32_t next;
+  uint32_t is_rp = (dev == 0);
+  uint8_t  htr;
+
+  memset(cfg, 0, PAL_HOST_ECAM_FUNC_SIZE);
+
+  host_cfg_write32(cfg, HOST_CFG_VIDR, PAL_HOST_VENDOR_ID | ((is_rp ? 0x0001 : 0x0002) << 16));
+  host_cfg_write32(cfg, HOST_CFG_RIDR,
+                   0x01 | ((is_rp ? HOST_CLASS_BRIDGE_P2P : HOST_CLASS_NETWORK) << 8));
+
+  htr = is_rp ? 0x1 : 0x0;
+  if ((func == 0) && (g_pal_host_cfg.num_func > 1))
+      htr |= HOST_HTR_MFD;
+  cfg[HOST_CFG_HTR] = htr;
+
+  if (is_rp)
+      host_cfg_write32(cfg, HOST_CFG_PBN, bus | (((bus + 1) & 0xFF) << 8) |
+                                          (((bus + 1) & 0xFF) << 16));
+
+  if (g_pal_host_cfg.num_cap) {
+      host_cfg_write32(cfg, HOST_CFG_CR, HOST_SR_CAP_LIST);
+      cfg[HOST_CFG_CPR] = HOST_CFG_CAP_START;
+
+      for (i = 0; i < g_pal_host_cfg.num_cap; i++) {
+          offset = HOST_CFG_CAP_START + (i * HOST_CFG_CAP_STRIDE);
+          next = (i + 1 < g_pal_host_cfg.num_cap) ? (offset + HOST_CFG_CAP_STRIDE) : 0;
+
+          if (i + 1 == g_pal_host_cfg.num_cap) {
+              host_cfg_write32(cfg, offset, HOST_CID_PCIECS | (next << 8) |
+                               ((HOST_PCIECR_VER | (is_rp ? HOST_PCIECR_RP : HOST_PCIECR_EP)) << 16));
+          } else {
+              host_cfg_write32(cfg, offset, host_cap_ids[i % sizeof(host_cap_ids)] | (next << 8));
+          }
+      }
+  }
+
+  for (i = 0; i < g_pal_host_cfg.num_ext_cap; i++) {
+      offset = HOST_CFG_ECAP_START + (i * HOST_CFG_ECAP_STRIDE);
+      next = (i + 1 < g_pal_host_cfg.num_ext_cap) ? (offset + HOST_CFG_ECAP_STRIDE) : 0;
+      host_cfg_write32(cfg, offset, host_ecap_ids[i % (sizeof(host_ecap_ids) / sizeof(uint16_t))] |
+                                    (0x1 << 16) | (next << 20));
+  }
+}
+
+/**
+  @brief  Allocate and populate the ECAM space of one region. Functions that
+          are not populated read as all ones, like an unsupported request.
+
+  @param  index  ECAM region index
+
+  @return ECAM base, 0 if the allocation failed
+**/
+static uint64_t
+pal_host_pcie_create_ecam(uint32_t index)
+{
+  uint8_t  *ecam;
+  uint32_t bus;
+  uint32_t dev;
+  uint32_t func;
+  uint64_t size;
+
+  size = (uint64_t)g_pal_host_cfg.ecam_num_bus * PAL_HOST_ECAM_BUS_SIZE;
+  ecam = pal_aligned_alloc(PAL_HOST_ECAM_FUNC_SIZE, (uint32_t)size);
+  if (ecam == NULL)
+      return 0;
+
+  memset(ecam, 0xFF, size);
+
+  for (bus = 0; bus < g_pal_host_cfg.ecam_num_bus; bus++)
+      for (dev = 0; dev < g_pal_host_cfg.num_dev; dev++)
+          for (func = 0; func < g_pal_host_cfg.num_func; func++)
+              pal_host_pcie_fill_function(ecam + (bus * PAL_HOST_ECAM_BUS_SIZE) +
+                                          (((dev * 8) + func) * PAL_HOST_ECAM_FUNC_SIZE),
+                                          bus, dev, func);
+
+  g_host_ecam[index] = ecam;
+  return (uint64_t)ecam;
+}
+
+/**
+  @brief  Free the ECAM space of all regions
+
+  @param  None
+
+  @return None
+**/
+void
+pal_host_pcie_free_ecam(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < PAL_HOST_MAX_ECAM; i++) {
+      free(g_host_ecam[i]);
+      g_host_ecam[i] = NULL;
+  }
+}
+
+/**
+  @brief  Return the number of ECAM regions the PCIe info table is filled with
+
+  @param  None
+
+  @return Number of PCIe info blocks
+**/
+uint32_t
+pal_pcie_get_info_entry_count(void)
+{
+  return g_pal_host_cfg.num_ecam;
+}
+
+/**
+  @brief  Fill the PCIe info table with one ECAM region per segment, each
+          decoding ecam_num_bus buses from bus 0.
+
+  @param  PcieTable  address where the PCIe information needs to be filled
+
+  @return None
+**/
+void
+pal_pcie_create_info_table(PCIE_INFO_TABLE *PcieTable)
+{
+  uint32_t i;
+  uint64_t ecam_base;
+
+  if (PcieTable == NULL) {
+      printf(" Input PCIe Table Pointer is NULL. Cannot create PCIe INFO\n");
+      return;
+  }
+
+  pal_host_pcie_free_ecam();
+  PcieTable->num_entries = 0;
+
+  for (i = 0; i < g_pal_host_cfg.num_ecam; i++) {
+      ecam_base = pal_host_pcie_create_ecam(i);
+      if (ecam_base == 0) {
+          printf(" ECAM %d allocation failed\n", i);
+          break;
+      }
+
+      PcieTable->block[i].ecam_base     = ecam_base;
+      PcieTable->block[i].segment_num   = i;
+      PcieTable->block[i].start_bus_num = 0;
+      PcieTable->block[i].end_bus_num   = g_pal_host_cfg.ecam_num_bus - 1;
+      PcieTable->num_entries++;
+  }
+}
+
+/**
+  @brief  Returns the ECAM base of the first region, as the MCFG would
+
+  @param  None
+
+  @return ECAM base address, 0 if there is no ECAM
+**/
+uint64_t
+pal_pcie_get_mcfg_ecam(void)
+{
+  return (uint64_t)g_host_ecam[0];
+}
@@ -0,0 +1,230 @@
+/** @file
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+/*
+ * C stand-ins for the register accessors that the RISCV64 assembly sources
+ * in val/src/RISCV64 provide on target. The hart ID register returns the
+ * simulated HART of the calling thread and the counter registers follow the
+ * host monotonic clock. Every other register reads as zero and writes are
+ * dropped.
+ */
+
+#include <sched.h>
+
+#include "pal_interface.h"
+#include "pal_host.h"
+
+#define HOST_SYSREG_READ_ZERO(name)   uint64_t name(void) { return 0; }
+#define HOST_SYSREG_WRITE_DROP(name)  void name(uint64_t data) { (void)data; }
+#define HOST_SYSREG_NOP(name)         void name(void) { }
+
+uint64_t
+ArmReadMpidr(void)
+{
+  return g_pal_host_hart_id;
+}
+
+uint64_t
+AA64ReadCtr(void)
+{
+  /* DminLine, log2 of the number of words in the smallest cache line */
+  return (uint64_t)__builtin_ctz(g_pal_host_cfg.cache_line_size / 4) << 16;
+}
+
+uint64_t
+AA64ReadCurrentEL(void)
+{
+  return 0x1 << 2;
+}
+
+uint64_t
+ArmReadCntFrq(void)
+{
+  return PAL_HOST_TIMER_FREQ;
+}
+
+uint64_t
+ArmReadCntPct(void)
+{
+  return pal_timer_get_counter();
+}
+
+uint64_t
+ArmReadCntvCt(void)
+{
+  return pal_timer_get_counter();
+}
+
+uint64_t
+AA64WriteSp(uint64_t data)
+{
+  return data;
+}
+
+void
+SpeProgramUnderProfiling(uint64_t interval, uint64_t address)
+{
+  (void)interval;
+  (void)address;
+}
+
+/* Timer */
+HOST_SYSREG_READ_ZERO(ArmReadCntkCtl)
+HOST_SYSREG_WRITE_DROP(ArmWriteCntkCtl)
+HOST_SYSREG_READ_ZERO(ArmReadCntpTval)
+HOST_SYSREG_WRITE_DROP(ArmWriteCntpTval)
+HOST_SYSREG_READ_ZERO(ArmReadCntpCtl)
+HOST_SYSREG_WRITE_DROP(ArmWriteCntpCtl)
+HOST_SYSREG_READ_ZERO(ArmReadCntvTval)
+HOST_SYSREG_WRITE_DROP(ArmWriteCntvTval)
+HOST_SYSREG_READ_ZERO(ArmReadCntvCtl)
+HOST_SYSREG_WRITE_DROP(ArmWriteCntvCtl)
+HOST_SYSREG_READ_ZERO(ArmReadCntpCval)
+HOST_SYSREG_WRITE_DROP(ArmWriteCntpCval)
+HOST_SYSREG_READ_ZERO(ArmReadCntvCval)
+HOST_SYSREG_WRITE_DROP(ArmWriteCntvCval)
+HOST_SYSREG_READ_ZERO(ArmReadCntvOff)
+HOST_SYSREG_WRITE_DROP(ArmWriteCntvOff)
+HOST_SYSREG_READ_ZERO(ArmReadCnthpCtl)
+HOST_SYSREG_WRITE_DROP(ArmWriteCnthpCtl)
+HOST_SYSREG_READ_ZERO(ArmReadCnthpTval)
+HOST_SYSREG_WRITE_DROP(ArmWriteCnthpTval)
+HOST_SYSREG_READ_ZERO(ArmReadCnthvCtl)
+HOST_SYSREG_WRITE_DROP(ArmWriteCnthvCtl)
+HOST_SYSREG_READ_ZERO(ArmReadCnthvTval)
+HOST_SYSREG_WRITE_DROP(ArmWriteCnthvTval)
+
+/* Interrupt controller */
+HOST_SYSREG_READ_ZERO(GicReadIchHcr)
+HOST_SYSREG_WRITE_DROP(GicWriteIchHcr)
+HOST_SYSREG_READ_ZERO(GicReadIchMisr)
+HOST_SYSREG_WRITE_DROP(GicWriteIccIgrpen1)
+HOST_SYSREG_WRITE_DROP(GicWriteIccBpr1)
+HOST_SYSREG_WRITE_DROP(GicWriteIccPmr)
+HOST_SYSREG_NOP(GicClearDaif)
+HOST_SYSREG_WRITE_DROP(GicWriteHcr)
+HOST_SYSREG_NOP(TestExecuteBarrier)
+
+/* HART identification and control */
+HOST_SYSREG_READ_ZERO(ArmReadIdPfr0)
+HOST_SYSREG_READ_ZERO(ArmReadIdPfr1)
+HOST_SYSREG_READ_ZERO(AA64ReadMmfr0)
+HOST_SYSREG_READ_ZERO(AA64ReadMmfr1)
+HOST_SYSREG_READ_ZERO(AA64ReadMmfr2)
+HOST_SYSREG_READ_ZERO(AA64ReadIsar0)
+HOST_SYSREG_READ_ZERO(AA64ReadIsar1)
+HOST_SYSREG_READ_ZERO(AA64ReadSctlr3)
+HOST_SYSREG_READ_ZERO(AA64ReadSctlr2)
+HOST_SYSREG_READ_ZERO(AA64ReadSctlr1)
+HOST_SYSREG_READ_ZERO(AA64ReadPmcr)
+HOST_SYSREG_READ_ZERO(AA64ReadIdDfr0)
+HOST_SYSREG_READ_ZERO(AA64ReadIdDfr1)
+HOST_SYSREG_READ_ZERO(ArmReadHcr)
+HOST_SYSREG_READ_ZERO(AA64ReadIdMdrar)
+HOST_SYSREG_READ_ZERO(AA64ReadMdcr2)
+HOST_SYSREG_WRITE_DROP(AA64WriteMdcr2)
+HOST_SYSREG_READ_ZERO(AA64ReadVbar2)
+HOST_SYSREG_WRITE_DROP(AA64WriteVbar2)
+HOST_SYSREG_WRITE_DROP(AA64WritePmcr)
+HOST_SYSREG_WRITE_DROP(AA64WritePmovsset)
+HOST_SYSREG_WRITE_DROP(AA64WritePmintenset)
+HOST_SYSREG_WRITE_DROP(AA64WritePmovsclr)
+HOST_SYSREG_WRITE_DROP(AA64WritePmintenclr)
+HOST_SYSREG_READ_ZERO(AA64ReadCcsidr)
+HOST_SYSREG_READ_ZERO(AA64ReadCsselr)
+HOST_SYSREG_WRITE_DROP(AA64WriteCsselr)
+HOST_SYSREG_READ_ZERO(AA64ReadClidr)
+HOST_SYSREG_READ_ZERO(ArmReadDfr0)
+HOST_SYSREG_READ_ZERO(ArmReadIsar0)
+HOST_SYSREG_READ_ZERO(ArmReadIsar1)
+HOST_SYSREG_READ_ZERO(ArmReadIsar2)
+HOST_SYSREG_READ_ZERO(ArmReadIsar3)
+HOST_SYSREG_READ_ZERO(ArmReadIsar4)
+HOST_SYSREG_READ_ZERO(ArmReadIsar5)
+HOST_SYSREG_READ_ZERO(ArmReadMmfr0)
+HOST_SYSREG_READ_ZERO(ArmReadMmfr1)
+HOST_SYSREG_READ_ZERO(ArmReadMmfr2)
+HOST_SYSREG_READ_ZERO(ArmReadMmfr3)
+HOST_SYSREG_READ_ZERO(ArmReadMmfr4)
+HOST_SYSREG_READ_ZERO(ArmReadPfr0)
+HOST_SYSREG_READ_ZERO(ArmReadPfr1)
+HOST_SYSREG_READ_ZERO(ArmReadMidr)
+HOST_SYSREG_READ_ZERO(ArmReadMvfr0)
+HOST_SYSREG_READ_ZERO(ArmReadMvfr1)
+HOST_SYSREG_READ_ZERO(ArmReadMvfr2)
+HOST_SYSREG_READ_ZERO(AA64ReadPmceid0)
+HOST_SYSREG_READ_ZERO(AA64ReadPmceid1)
+HOST_SYSREG_READ_ZERO(AA64ReadVmpidr)
+HOST_SYSREG_READ_ZERO(AA64ReadVpidr)
+HOST_SYSREG_READ_ZERO(AA64ReadPmbidr)
+HOST_SYSREG_READ_ZERO(AA64ReadPmsidr)
+HOST_SYSREG_READ_ZERO(AA64ReadLorid)
+HOST_SYSREG_READ_ZERO(AA64ReadErridr)
+HOST_SYSREG_READ_ZERO(AA64ReadErr0fr)
+HOST_SYSREG_READ_ZERO(AA64ReadErr1fr)
+HOST_SYSREG_READ_ZERO(AA64ReadErr2fr)
+HOST_SYSREG_READ_ZERO(AA64ReadErr3fr)
+HOST_SYSREG_WRITE_DROP(AA64WritePmsirr)
+HOST_SYSREG_WRITE_DROP(AA64WritePmscr2)
+HOST_SYSREG_WRITE_DROP(AA64WritePmsfcr)
+HOST_SYSREG_WRITE_DROP(AA64WritePmbptr)
+HOST_SYSREG_WRITE_DROP(AA64WritePmblimitr)
+HOST_SYSREG_READ_ZERO(AA64ReadEsr2)
+HOST_SYSREG_READ_ZERO(AA64ReadSp)
+HOST_SYSREG_READ_ZERO(AA64ReadFar2)
+HOST_SYSREG_READ_ZERO(ArmRdvl)
+HOST_SYSREG_READ_ZERO(AA64ReadMair1)
+HOST_SYSREG_READ_ZERO(AA64ReadMair2)
+HOST_SYSREG_READ_ZERO(AA64ReadTcr1)
+HOST_SYSREG_READ_ZERO(AA64ReadTcr2)
+HOST_SYSREG_READ_ZERO(AA64ReadTtbr0El1)
+HOST_SYSREG_READ_ZERO(AA64ReadTtbr0El2)
+HOST_SYSREG_READ_ZERO(AA64ReadTtbr1El1)
+HOST_SYSREG_READ_ZERO(AA64ReadTtbr1El2)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr0El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr1El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr2El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr3El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr4El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr5El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr6El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr7El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr8El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr9El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr10El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr11El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr12El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr13El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr14El1)
+HOST_SYSREG_READ_ZERO(AA64ReadDbgbcr15El1)
+
+/* Barriers and power */
+HOST_SYSREG_NOP(ArmCallWFI)
+HOST_SYSREG_NOP(DisableSpe)
+
+void
+ArmCallPause(void)
+{
+  /* Let the other simulated HARTs run while this one polls */
+  sched_yield();
+}
+
+void
+ArmExecuteMemoryBarrier(void)
+{
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
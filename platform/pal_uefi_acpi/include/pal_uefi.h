@@ -19,6 +19,8 @@
 #define __PAL_UEFI_H__
 
 extern VOID* g_bsa_log_file_handle;
+extern VOID* g_bsa_json_file_handle;
+extern VOID* g_bsa_junit_file_handle;
 extern UINT32 g_print_level;
 extern UINT32 g_print_mmio;
 extern UINT32 g_curr_module;
@@ -32,6 +34,10 @@ extern UINT32 g_pcie_cache_present;
 #define ACS_PRINT_DEBUG 2      /* For Debug statements. contains register dumps etc */
 #define ACS_PRINT_INFO  1      /* Print all statements. Do not use unless really needed */
 
+#define ACS_RESULT_JSON        0   /* JSON lines, written to g_bsa_json_file_handle */
+#define ACS_RESULT_JUNIT       1   /* JUnit XML, written to g_bsa_junit_file_handle */
+#define ACS_RESULT_NUM_STREAM  2
+
 #define PCIE_SUCCESS            0x00000000  /* Operation completed successfully */
 #define PCIE_NO_MAPPING         0x10000001  /* A mapping to a Function does not exist */
 #define PCIE_CAP_NOT_FOUND      0x10000010  /* The specified capability was not found */
@@ -87,6 +93,8 @@ typedef struct {
 #define CONDUIT_UNKNOWN  -1
 #define CONDUIT_NONE     -2
 
+UINT64 pal_get_acpi_table_ptr(UINT32 Signature, UINT32 Instance);
+
 typedef struct {
   UINT32 num_of_hart;
 }HART_INFO_HDR;
@@ -95,20 +103,34 @@ typedef struct {
   @brief  structure instance for HART entry
 **/
 typedef struct {
-  UINT32   hart_num;          ///< HART Index
   UINT64   hart_id;         ///< Hart ID (mhartid) of the hart
+  UINT64   imsic_base;      ///< Physical base address of the Incoming MSI Controller (IMSIC) MMIO region of this hart.
+  UINT64   isa_ext;         ///< Bitmap of ISA extensions, parsed by VAL from the ISA string.
+  UINT32   hart_num;        ///< HART Index
   UINT32   acpi_processor_uid;
   UINT32   ext_intc_id;     ///< The unique ID of the external interrupts connected to this hart.
-  UINT64   imsic_base;      ///< Physical base address of the Incoming MSI Controller (IMSIC) MMIO region of this hart.
   UINT32   imsic_size;      ///< Size in bytes of the IMSIC MMIO region of this hart.
-  UINT8    isa_string[512]; ///< Null-terminated ASCII Instruction Set Architecture (ISA) string for this hart.
+  UINT32   cbom_block_size; ///< Zicbom cache block size in bytes, 0 if not reported.
 }HART_INFO_ENTRY;
 
+/**
+  @brief  Per HART data that is only read when a test asks for it
+**/
+typedef struct {
+  UINT8    isa_string[512]; ///< Null-terminated ASCII Instruction Set Architecture (ISA) string for this hart.
+}HART_INFO_DETAIL;
+
+/**
+  @brief  The HART_INFO_DETAIL array starts right after hart_info[num_of_hart - 1]
+**/
 typedef struct {
   HART_INFO_HDR    header;
   HART_INFO_ENTRY  hart_info[];
 }HART_INFO_TABLE;
 
+#define HART_INFO_DETAIL_BASE(table) \
+  ((HART_INFO_DETAIL *)&(table)->hart_info[(table)->header.num_of_hart])
+
 VOID     pal_hart_data_cache_ops_by_va(UINT64 addr, UINT32 type);
 
 #define CLEAN_AND_INVALIDATE  0x1
@@ -457,7 +479,7 @@ UINT32 pal_pcie_max_pasid_bits(UINT32 bdf);
 
 /* Memory INFO table */
 
-#define MEM_INFO_TBL_MAX_ENTRY  500 /* Maximum entries to be added in Mem info table*/
+#define MEM_INFO_TBL_SPARE_ENTRY 8  /* Room for map growth after the entries are counted */
 
 typedef enum {
   MEMORY_TYPE_DEVICE = 0x1000,
@@ -485,6 +507,7 @@ typedef struct {
 
 
 VOID  pal_memory_create_info_table(MEMORY_INFO_TABLE *memoryInfoTable);
+UINT32 pal_memory_get_info_entry_count(VOID);
 
 VOID    *pal_mem_alloc(UINT32 size);
 VOID    *pal_mem_calloc(UINT32 num, UINT32 size);
@@ -70,6 +70,23 @@ pal_target_is_bm()
   return 0;
 }
 
+/* Index of the tables listed in the XSDT, built by one walk of the XSDT */
+#define ACPI_TABLE_INDEX_MAX   128
+#define ACPI_TABLE_HASH_SLOTS  256   /* Power of 2, at least twice ACPI_TABLE_INDEX_MAX */
+#define ACPI_TABLE_HASH_MULT   0x9E3779B1
+
+typedef struct {
+  UINT32  Signature;
+  UINT32  First;     ///< Index in gAcpiTableList of instance 0
+  UINT32  Count;     ///< Number of instances, 0 for an empty slot
+} ACPI_TABLE_HASH_ENTRY;
+
+static UINT64                gXsdtPtr;
+static BOOLEAN               gAcpiIndexBuilt;
+static UINT64                gAcpiTableList[ACPI_TABLE_INDEX_MAX];
+static UINT32                gAcpiTableCount;
+static ACPI_TABLE_HASH_ENTRY gAcpiTableHash[ACPI_TABLE_HASH_SLOTS];
+
 /**
   @brief   Use UEFI System Table to look up Acpi20TableGuid and returns the Xsdt Address
 
@@ -83,6 +100,9 @@ pal_get_xsdt_ptr()
   EFI_ACPI_6_1_ROOT_SYSTEM_DESCRIPTION_POINTER *Rsdp;
   UINT32                        Index;
 
+  if (gXsdtPtr != 0)
+      return gXsdtPtr;
+
   for (Index = 0, Rsdp = NULL; Index < gST->NumberOfTableEntries; Index++) {
     if (CompareGuid (&(gST->ConfigurationTable[Index].VendorGuid), &gEfiAcpiTableGuid) ||
       CompareGuid (&(gST->ConfigurationTable[Index].VendorGuid), &gEfiAcpi20TableGuid)
@@ -95,182 +115,224 @@ pal_get_xsdt_ptr()
   if (Rsdp == NULL) {
       return 0;
   } else {
-      return((UINT64) (EFI_ACPI_6_1_ROOT_SYSTEM_DESCRIPTION_POINTER *) Rsdp->XsdtAddress);
+      gXsdtPtr = (UINT64) Rsdp->XsdtAddress;
+      return gXsdtPtr;
   }
 
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return MADT address
+  @brief  Returns the hash slot at which the probe for a signature starts
 
-  @param  None
+  @param  Signature  ACPI table signature
 
-  @return 64-bit MADT address
+  @return Slot index
 **/
-UINT64
-pal_get_madt_ptr()
+static UINT32
+pal_acpi_hash_slot(UINT32 Signature)
 {
+  return (Signature * ACPI_TABLE_HASH_MULT) >> 24 & (ACPI_TABLE_HASH_SLOTS - 1);
+}
 
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
+/**
+  @brief  Checks that the bytes of an ACPI table sum to zero
 
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
-      return 0;
-  }
+  @param  Table  ACPI table header
 
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
-    }
-  }
+  @return TRUE if the checksum is valid
+**/
+static BOOLEAN
+pal_acpi_checksum_valid(EFI_ACPI_DESCRIPTION_HEADER *Table)
+{
+  UINT8   *Byte = (UINT8 *)Table;
+  UINT8   Sum = 0;
+  UINT32  Idx;
 
-  return 0;
+  for (Idx = 0; Idx < Table->Length; Idx++)
+    Sum += Byte[Idx];
 
+  return (Sum == 0);
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return RIMT address
+  @brief  Walks the XSDT once and indexes every table it lists by signature.
+          Tables with the same signature are kept together in XSDT order, so
+          that instance N of a signature is found without another walk. The
+          checksum of each table is verified here, tables that fail are
+          reported and still indexed as before.
 
   @param  None
 
-  @return 64-bit RIMT address
+  @return None
 **/
-UINT64
-pal_get_rimt_ptr()
+static VOID
+pal_acpi_build_index(VOID)
 {
-
   EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
+  EFI_ACPI_DESCRIPTION_HEADER   *Table;
   UINT64                        *Entry64;
   UINT32                        Entry64Num;
   UINT32                        Idx;
+  UINT32                        Pos;
+  UINT32                        Slot;
+  UINT32                        Signature;
+  UINT64                        Current;
+
+  gAcpiIndexBuilt = TRUE;
+  gAcpiTableCount = 0;
+  SetMem(gAcpiTableHash, sizeof(gAcpiTableHash), 0);
 
   Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
   if (Xsdt == NULL) {
       bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
-      return 0;
+      return;
   }
 
+  if (!pal_acpi_checksum_valid(Xsdt))
+      bsa_print(ACS_PRINT_WARN, L" XSDT checksum is not valid\n");
+
   Entry64  = (UINT64 *)(Xsdt + 1);
   Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
+  if (Entry64Num > ACPI_TABLE_INDEX_MAX) {
+      bsa_print(ACS_PRINT_WARN, L" XSDT lists %d tables, indexing the first ", Entry64Num);
+      bsa_print(ACS_PRINT_WARN, L"%d\n", ACPI_TABLE_INDEX_MAX);
+      Entry64Num = ACPI_TABLE_INDEX_MAX;
+  }
+
   for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_5_RISC_V_IO_MAPPING_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Entry64[Idx];
+    if (Table == NULL)
+        continue;
+
+    if (!pal_acpi_checksum_valid(Table))
+        bsa_print(ACS_PRINT_WARN, L" ACPI table %.4a checksum is not valid\n", &Table->Signature);
+
+    /* Insert after the last table with the same signature, keeping XSDT order */
+    Current = (UINT64)(UINTN)Table;
+    Pos = gAcpiTableCount;
+    while ((Pos > 0) &&
+           (((EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)gAcpiTableList[Pos - 1])->Signature > Table->Signature)) {
+        gAcpiTableList[Pos] = gAcpiTableList[Pos - 1];
+        Pos--;
     }
+    gAcpiTableList[Pos] = Current;
+    gAcpiTableCount++;
   }
 
-  return 0;
+  for (Idx = 0; Idx < gAcpiTableCount; Idx++) {
+    Signature = ((EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)gAcpiTableList[Idx])->Signature;
+    Slot = pal_acpi_hash_slot(Signature);
+    while ((gAcpiTableHash[Slot].Count != 0) && (gAcpiTableHash[Slot].Signature != Signature))
+        Slot = (Slot + 1) & (ACPI_TABLE_HASH_SLOTS - 1);
+
+    if (gAcpiTableHash[Slot].Count == 0) {
+        gAcpiTableHash[Slot].Signature = Signature;
+        gAcpiTableHash[Slot].First = Idx;
+    }
+    gAcpiTableHash[Slot].Count++;
+  }
 
+  bsa_print(ACS_PRINT_INFO, L"  ACPI tables indexed : %d\n", gAcpiTableCount);
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return GTDT address
+  @brief  Returns the address of an ACPI table listed in the XSDT. The XSDT is
+          walked once, on the first call.
 
-  @param  None
+  @param  Signature  ACPI table signature
+  @param  Instance   0 based instance of the tables with this signature
 
-  @return 64-bit GTDT address
+  @return 64-bit table address, 0 if there is no such table
 **/
 UINT64
-pal_get_gtdt_ptr()
+pal_get_acpi_table_ptr(UINT32 Signature, UINT32 Instance)
 {
+  UINT32 Slot;
 
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
+  if (!gAcpiIndexBuilt)
+      pal_acpi_build_index();
 
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
-      return 0;
-  }
-
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_GENERIC_TIMER_DESCRIPTION_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
+  Slot = pal_acpi_hash_slot(Signature);
+  while (gAcpiTableHash[Slot].Count != 0) {
+    if (gAcpiTableHash[Slot].Signature == Signature) {
+        if (Instance >= gAcpiTableHash[Slot].Count)
+            return 0;
+        return gAcpiTableList[gAcpiTableHash[Slot].First + Instance];
     }
+    Slot = (Slot + 1) & (ACPI_TABLE_HASH_SLOTS - 1);
   }
 
   return 0;
-
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return RHCT address
+  @brief  Return MADT address from the ACPI table index
 
   @param  None
 
-  @return 64-bit GTDT address
+  @return 64-bit MADT address
 **/
 UINT64
-pal_get_rhct_ptr()
+pal_get_madt_ptr()
 {
+  return pal_get_acpi_table_ptr(EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_SIGNATURE, 0);
+}
 
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
+/**
+  @brief  Return RIMT address from the ACPI table index
 
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
-      return 0;
-  }
+  @param  None
 
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_5_RISC_V_HART_CAPABILITIES_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
-    }
-  }
+  @return 64-bit RIMT address
+**/
+UINT64
+pal_get_rimt_ptr()
+{
+  return pal_get_acpi_table_ptr(EFI_ACPI_6_5_RISC_V_IO_MAPPING_TABLE_SIGNATURE, 0);
+}
 
-  return 0;
+/**
+  @brief  Return GTDT address from the ACPI table index
+
+  @param  None
 
+  @return 64-bit GTDT address
+**/
+UINT64
+pal_get_gtdt_ptr()
+{
+  return pal_get_acpi_table_ptr(EFI_ACPI_6_1_GENERIC_TIMER_DESCRIPTION_TABLE_SIGNATURE, 0);
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return MCFG Table address
+  @brief  Return RHCT address from the ACPI table index
 
   @param  None
 
-  @return 64-bit MCFG address
+  @return 64-bit RHCT address
 **/
 UINT64
-pal_get_mcfg_ptr()
+pal_get_rhct_ptr()
 {
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
-
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
-      return 0;
-  }
+  return pal_get_acpi_table_ptr(EFI_ACPI_6_5_RISC_V_HART_CAPABILITIES_TABLE_SIGNATURE, 0);
+}
 
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_PCI_EXPRESS_MEMORY_MAPPED_CONFIGURATION_SPACE_BASE_ADDRESS_DESCRIPTION_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
-    }
-  }
+/**
+  @brief  Return MCFG Table address from the ACPI table index
 
-  return 0;
+  @param  None
 
+  @return 64-bit MCFG address
+**/
+UINT64
+pal_get_mcfg_ptr()
+{
+  return pal_get_acpi_table_ptr(
+           EFI_ACPI_6_1_PCI_EXPRESS_MEMORY_MAPPED_CONFIGURATION_SPACE_BASE_ADDRESS_DESCRIPTION_TABLE_SIGNATURE, 0);
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return SPCR Table address
+  @brief  Return SPCR Table address from the ACPI table index
 
   @param  None
 
@@ -279,31 +341,11 @@ pal_get_mcfg_ptr()
 UINT64
 pal_get_spcr_ptr()
 {
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
-
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
-      return 0;
-  }
-
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_2_0_SERIAL_PORT_CONSOLE_REDIRECTION_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
-    }
-  }
-
-  return 0;
-
+  return pal_get_acpi_table_ptr(EFI_ACPI_2_0_SERIAL_PORT_CONSOLE_REDIRECTION_TABLE_SIGNATURE, 0);
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return IORT Table address
+  @brief  Return IORT Table address from the ACPI table index
 
   @param  None
 
@@ -312,35 +354,15 @@ pal_get_spcr_ptr()
 UINT64
 pal_get_iort_ptr()
 {
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
-
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
-      return 0;
-  }
-
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
 #ifdef EFI_ACPI_6_1_IO_REMAPPING_TABLE_SIGNATURE
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_IO_REMAPPING_TABLE_SIGNATURE) {
+  return pal_get_acpi_table_ptr(EFI_ACPI_6_1_IO_REMAPPING_TABLE_SIGNATURE, 0);
 #else
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_INTERRUPT_SOURCE_OVERRIDE_SIGNATURE) {
+  return pal_get_acpi_table_ptr(EFI_ACPI_6_1_INTERRUPT_SOURCE_OVERRIDE_SIGNATURE, 0);
 #endif
-        return(UINT64)(Entry64[Idx]);
-    }
-  }
-
-  return 0;
-
 }
 
 /**
-  @brief   Iterate through the tables pointed by XSDT and return FADT Table address
+  @brief   Return FADT Table address from the ACPI table index
   @param   None
   @return  64-bit address of FADT table
   @retval  0:  FADT table could not be found
@@ -350,24 +372,5 @@ pal_get_fadt_ptr (
   VOID
   )
 {
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
-
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      bsa_print(ACS_PRINT_ERR, L" XSDT not found\n");
-      return 0;
-  }
-
-  Entry64 = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof (EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_FIXED_ACPI_DESCRIPTION_TABLE_SIGNATURE) {
-      return (UINT64)(Entry64[Idx]);
-    }
-  }
-
-  return 0;
+  return pal_get_acpi_table_ptr(EFI_ACPI_6_1_FIXED_ACPI_DESCRIPTION_TABLE_SIGNATURE, 0);
 }
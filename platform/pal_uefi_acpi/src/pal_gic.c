@@ -36,6 +36,43 @@ EFI_HARDWARE_INTERRUPT2_PROTOCOL *gInterrupt2 = NULL;
 UINT64
 pal_get_madt_ptr();
 
+/**
+  @brief  Count the MADT interrupt controller structures that get an IIC info
+          entry, so that the caller can size the IIC info table before it is filled.
+
+  @param  None
+
+  @return Number of IIC info entries, including the end marker, that
+          pal_gic_create_info_table will fill
+**/
+UINT32
+pal_gic_get_info_entry_count(VOID)
+{
+  EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *MadtHdr;
+  EFI_ACPI_6_1_GIC_STRUCTURE                          *Entry;
+  UINT32                                              TableLength;
+  UINT32                                              Length;
+  UINT32                                              Count = 1;  /* End of data marker */
+
+  MadtHdr = (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *) pal_get_madt_ptr();
+  if (MadtHdr == NULL)
+    return 0;
+
+  TableLength = MadtHdr->Header.Length;
+  Entry = (EFI_ACPI_6_1_GIC_STRUCTURE *) (MadtHdr + 1);
+  Length = sizeof (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER);
+
+  do {
+    if (Entry->Type == EFI_ACPI_6_5_PLIC)
+      Count++;
+
+    Length += Entry->Length;
+    Entry = (EFI_ACPI_6_1_GIC_STRUCTURE *) ((UINT8 *)Entry + (Entry->Length));
+  } while (Length < TableLength);
+
+  return Count;
+}
+
 /**
   @brief  Populate information about the IIC sub-system at the input address.
           In a UEFI-ACPI framework, this information is part of the MADT table.
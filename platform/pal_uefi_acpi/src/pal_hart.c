@@ -42,6 +42,9 @@ extern INT32 gPsciConduit;
 #define ENABLED_BIT(flags)  (flags & 0x1)
 #define ONLINE_CAP_BIT(flags)  ((flags > 1) & 0x1)
 
+/* Cache block size assumed when no RHCT CMO node reports the CBOM block size */
+#define PAL_CACHE_BLOCK_SIZE_MIN  64
+
 UINT64
 pal_get_madt_ptr();
 
@@ -177,9 +180,181 @@ PalAllocateSecondaryStack(UINT64 mpidr)
 
 }
 
+/**
+  @brief  This API counts the usable HARTs described by the MADT, so that the caller
+          can size the HART_INFO table before it is filled.
+
+  @param  None
+
+  @return  Number of HART_INFO entries pal_hart_create_info_table will fill
+**/
+UINT32
+pal_hart_get_info_entry_count(VOID)
+{
+  EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *MadtHdr;
+  EFI_ACPI_6_5_RINTC_STRUCTURE                        *Entry;
+  UINT32                                              MadtTableLength;
+  UINT32                                              Length;
+  UINT32                                              Count = 0;
+
+  MadtHdr = (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *) pal_get_madt_ptr();
+  if (MadtHdr == NULL)
+    return 0;
+
+  MadtTableLength = MadtHdr->Header.Length;
+  Entry = (EFI_ACPI_6_5_RINTC_STRUCTURE *) (MadtHdr + 1);
+  Length = sizeof (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER);
+
+  do {
+    if ((Entry->Type == EFI_ACPI_6_5_RINTC) &&
+        ((ENABLED_BIT(Entry->Flags) == 1) || (ONLINE_CAP_BIT(Entry->Flags) == 1)))
+      Count++;
+
+    Length += Entry->Length;
+    Entry = (EFI_ACPI_6_5_RINTC_STRUCTURE *) ((UINT8 *)Entry + (Entry->Length));
+  } while (Length < MadtTableLength);
+
+  return Count;
+}
+
+/**
+  @brief  RHCT Hart Info node of one ACPI Processor UID
+**/
+typedef struct {
+  UINT32                                      Uid;
+  EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE  *Node;
+} RHCT_HART_INFO_INDEX;
+
+/**
+  @brief  Walks the RHCT nodes once and indexes the Hart Info nodes by ACPI
+          Processor UID. Firmware usually lists the nodes in UID order, so the
+          insertion sort is close to linear.
+
+  @param  Count  - Returns the number of entries in the index.
+
+  @return Index sorted by UID, to be freed with pal_mem_free. NULL if there is
+          no Hart Info node or the allocation failed.
+**/
+static RHCT_HART_INFO_INDEX *
+pal_rhct_build_hart_index(UINT32 *Count)
+{
+  EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE  *HartInfoNode;
+  RHCT_HART_INFO_INDEX                        *HartIndex;
+  UINT32                                      Index;
+  UINT32                                      Pos;
+
+  *Count = 0;
+  if (gRhctHdr->RHCTNodeNumber == 0)
+    return NULL;
+
+  HartIndex = pal_mem_alloc(gRhctHdr->RHCTNodeNumber * sizeof(RHCT_HART_INFO_INDEX));
+  if (HartIndex == NULL)
+    return NULL;
+
+  HartInfoNode = (EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE *)((UINTN)gRhctHdr + gRhctHdr->RHCTNodeOffset);
+  for (Index = 0; Index < gRhctHdr->RHCTNodeNumber; Index++) {
+    if (HartInfoNode->Header.Type == EFI_ACPI_6_5_RHCT_NODE_TYPE_HART_INFO_NODE) {
+      Pos = *Count;
+      while ((Pos > 0) && (HartIndex[Pos - 1].Uid > HartInfoNode->AcpiProcessorUid)) {
+        HartIndex[Pos] = HartIndex[Pos - 1];
+        Pos--;
+      }
+      HartIndex[Pos].Uid  = HartInfoNode->AcpiProcessorUid;
+      HartIndex[Pos].Node = HartInfoNode;
+      (*Count)++;
+    }
+    HartInfoNode = (EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE *)((UINTN)HartInfoNode + HartInfoNode->Header.Length);
+  }
+
+  return HartIndex;
+}
+
+/**
+  @brief  Looks up the RHCT Hart Info node of an ACPI Processor UID
+
+  @param  HartIndex  - Index built by pal_rhct_build_hart_index.
+  @param  Count      - Number of entries in the index.
+  @param  Uid        - ACPI Processor UID from the RINTC structure.
+
+  @return Hart Info node, NULL if the RHCT has none for this UID
+**/
+static EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE *
+pal_rhct_find_hart_info(RHCT_HART_INFO_INDEX *HartIndex, UINT32 Count, UINT32 Uid)
+{
+  UINT32 Low = 0;
+  UINT32 High = Count;
+  UINT32 Mid;
+
+  while (Low < High) {
+    Mid = Low + ((High - Low) >> 1);
+    if (HartIndex[Mid].Uid == Uid)
+      return HartIndex[Mid].Node;
+    if (HartIndex[Mid].Uid < Uid)
+      Low = Mid + 1;
+    else
+      High = Mid;
+  }
+
+  return NULL;
+}
+
+/**
+  @brief  Fills the HART entry and detail from the RHCT nodes that a Hart Info
+          node points to.
+
+  @param  HartInfoNode  - RHCT Hart Info node of the HART.
+  @param  Ptr           - HART entry to fill.
+  @param  Detail        - HART detail to fill.
+
+  @return None
+**/
+static VOID
+pal_hart_fill_rhct_info(EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE *HartInfoNode,
+                        HART_INFO_ENTRY *Ptr, HART_INFO_DETAIL *Detail)
+{
+  EFI_ACPI_6_5_RHCT_NODE_HEADER                  *RhctNodeEntry;
+  EFI_ACPI_6_5_RHCT_ISA_STRING_NODE_STRUCTURE    *IsaStringNode;
+  EFI_ACPI_6_5_RHCT_CMO_EXTENSION_NODE_STRUCTURE *CmoNode;
+  UINT32                                         Index;
+  UINT32                                         IsaLength;
+
+  // Go through HartInfoNode.Offsets for other RHCT nodes of this hart
+  for (Index = 0; Index < HartInfoNode->OffsetNumber; Index++) {
+    RhctNodeEntry = (EFI_ACPI_6_5_RHCT_NODE_HEADER *)((UINTN)gRhctHdr + HartInfoNode->Offsets[Index]);
+    switch (RhctNodeEntry->Type) {
+      case EFI_ACPI_6_5_RHCT_NODE_TYPE_ISA_STRING_NODE:
+        IsaStringNode = (EFI_ACPI_6_5_RHCT_ISA_STRING_NODE_STRUCTURE *) RhctNodeEntry;
+        IsaLength = IsaStringNode->ISALength;
+        if (IsaLength >= sizeof(Detail->isa_string)) {
+          bsa_print(ACS_PRINT_ERR, L"      Error: ISA String size overflow %d\n", IsaLength);
+          IsaLength = sizeof(Detail->isa_string) - 1;
+        }
+        CopyMem(Detail->isa_string, IsaStringNode->ISAString, IsaLength);
+        bsa_print(ACS_PRINT_INFO, L"      ISA string found: %a\n", Detail->isa_string);
+        break;
+
+      case EFI_ACPI_6_5_RHCT_NODE_TYPE_CMO_EXTENSION_NODE:
+        CmoNode = (EFI_ACPI_6_5_RHCT_CMO_EXTENSION_NODE_STRUCTURE *) RhctNodeEntry;
+        /* Block sizes are reported as a power of 2 */
+        Ptr->cbom_block_size = 1 << CmoNode->CBOMBlockSize;
+        bsa_print(ACS_PRINT_INFO, L"      CMO found, CBOM block size %d\n", Ptr->cbom_block_size);
+        break;
+
+      case EFI_ACPI_6_5_RHCT_NODE_TYPE_MMU_NODE:
+        bsa_print(ACS_PRINT_INFO, L"      MMU found\n");
+        break;
+
+      default:
+        bsa_print(ACS_PRINT_INFO, L"      Unknow type %d found\n", RhctNodeEntry->Type);
+    }
+  }
+}
+
 /**
   @brief  This API fills in the HART_INFO Table with information about the PEs in the
           system. This is achieved by parsing the ACPI - MADT table.
+          The RHCT Hart Info nodes are indexed by ACPI Processor UID once, so
+          the MADT is walked once without rescanning the RHCT for each HART.
 
   @param  PeTable  - Address where the HART information needs to be filled.
 
@@ -189,16 +364,20 @@ VOID
 pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
 {
   EFI_ACPI_6_5_RINTC_STRUCTURE                *Entry = NULL;
-  EFI_ACPI_6_5_RHCT_NODE_HEADER               *RhctNodeEntry = NULL;
   EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE  *HartInfoNode = NULL;
-  EFI_ACPI_6_5_RHCT_ISA_STRING_NODE_STRUCTURE *IsaStringNode = NULL;
-  HART_INFO_ENTRY                               *Ptr = NULL;
+  RHCT_HART_INFO_INDEX                        *RhctIndex = NULL;
+  HART_INFO_ENTRY                             *Ptr = NULL;
+  HART_INFO_DETAIL                            *Detail = NULL;
   UINT32                                      MadtTableLength = 0;
   UINT32                                      RhctTableLength = 0;
   UINT32                                      Length = 0;
-  UINT32                                      Index = 0;
-  UINT32                                      Index2 = 0;
+  UINT32                                      RhctIndexCount = 0;
+  UINT32                                      HartIndex = 0;
   UINT32                                      Flags = 0;
+  UINT64                                      Addr;
+  UINT64                                      End;
+  UINT32                                      BlockSize;
+  UINT32                                      Index;
 
   if (PeTable == NULL) {
     bsa_print(ACS_PRINT_ERR, L" Input HART Table Pointer is NULL. Cannot create HART INFO\n");
@@ -227,6 +406,15 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
     return;
   }
 
+  RhctIndex = pal_rhct_build_hart_index(&RhctIndexCount);
+  if (RhctIndex == NULL)
+    bsa_print(ACS_PRINT_WARN, L"  No RHCT Hart Info node indexed\n");
+
+  /* The detail array follows the last entry, so the count is set first */
+  PeTable->header.num_of_hart = pal_hart_get_info_entry_count();
+  Detail = HART_INFO_DETAIL_BASE(PeTable);
+  ZeroMem(Detail, PeTable->header.num_of_hart * sizeof(HART_INFO_DETAIL));
+
   Entry = (EFI_ACPI_6_5_RINTC_STRUCTURE *) (gMadtHdr + 1);
   Length = sizeof (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER);
   Ptr = PeTable->hart_info;
@@ -246,53 +434,24 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
       */
       if ((ENABLED_BIT(Flags) == 1) || (ONLINE_CAP_BIT(Flags) == 1)) {
         Ptr->hart_id = Entry->HartId;
-        Ptr->hart_num     = PeTable->header.num_of_hart;
+        Ptr->hart_num     = HartIndex;
         Ptr->acpi_processor_uid = Entry->AcpiProcessorUid;
         Ptr->ext_intc_id = Entry->ExternalINTCId;
         Ptr->imsic_base = Entry->IMSICBase;
         Ptr->imsic_size = Entry->IMSICSize;
+        Ptr->cbom_block_size = 0;
+        Ptr->isa_ext = 0;
         bsa_print(ACS_PRINT_DEBUG, L"  HartID 0x%lx HART num 0x%x\n", Ptr->hart_id, Ptr->hart_num);
         bsa_print(ACS_PRINT_DEBUG, L"    Processor UID %d\n", Ptr->acpi_processor_uid);
         bsa_print(ACS_PRINT_DEBUG, L"    IMSIC Base 0x%lx IMSIC Size 0x%x\n", Ptr->imsic_base, Ptr->imsic_size);
 
-        // Find Hart Info node first.
-        HartInfoNode = (EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE *)((UINTN)gRhctHdr + gRhctHdr->RHCTNodeOffset);
-        for (Index = 0; Index < gRhctHdr->RHCTNodeNumber; Index++) {
-          if (HartInfoNode->Header.Type == EFI_ACPI_6_5_RHCT_NODE_TYPE_HART_INFO_NODE &&
-              HartInfoNode->AcpiProcessorUid == Entry->AcpiProcessorUid) {
-            bsa_print(ACS_PRINT_INFO, L"      HART Info is found\n");
-
-            // Go through HartInfoNode.Offsets for other RHCT nodes of this hart
-            for (Index2 = 0; Index2 < HartInfoNode->OffsetNumber; Index2++) {
-              RhctNodeEntry = (EFI_ACPI_6_5_RHCT_NODE_HEADER *)((UINTN)gRhctHdr + HartInfoNode->Offsets[Index2]);
-              switch (RhctNodeEntry->Type) {
-                case EFI_ACPI_6_5_RHCT_NODE_TYPE_ISA_STRING_NODE:
-                  IsaStringNode = (EFI_ACPI_6_5_RHCT_ISA_STRING_NODE_STRUCTURE *) RhctNodeEntry;
-                  if (IsaStringNode->ISALength > sizeof(Ptr->isa_string)) {
-                    bsa_print(ACS_PRINT_ERR, L"      Error: ISA String size overflow %d\n", IsaStringNode->ISALength);
-                  }
-                  CopyMem(Ptr->isa_string, IsaStringNode->ISAString, IsaStringNode->ISALength);
-                  bsa_print(ACS_PRINT_INFO, L"      ISA string found: %a\n", Ptr->isa_string);
-                  break;
-
-                case EFI_ACPI_6_5_RHCT_NODE_TYPE_CMO_EXTENSION_NODE:
-                  bsa_print(ACS_PRINT_INFO, L"      CMO found\n");
-                  break;
-
-                case EFI_ACPI_6_5_RHCT_NODE_TYPE_MMU_NODE:
-                  bsa_print(ACS_PRINT_INFO, L"      MMU found\n");
-                  break;
-
-                default:
-                  bsa_print(ACS_PRINT_INFO, L"      Unknow type %d found\n", RhctNodeEntry->Type);
-              }
-            }
-          }
-          HartInfoNode = (EFI_ACPI_6_5_RHCT_HART_INFO_NODE_STRUCTURE *)((UINTN)HartInfoNode + HartInfoNode->Header.Length);
+        HartInfoNode = pal_rhct_find_hart_info(RhctIndex, RhctIndexCount, Entry->AcpiProcessorUid);
+        if (HartInfoNode != NULL) {
+          bsa_print(ACS_PRINT_INFO, L"      HART Info is found\n");
+          pal_hart_fill_rhct_info(HartInfoNode, Ptr, &Detail[HartIndex]);
         }
-        pal_hart_data_cache_ops_by_va((UINT64)Ptr, CLEAN_AND_INVALIDATE);
         Ptr++;
-        PeTable->header.num_of_hart++;
+        HartIndex++;
       }
     }
 
@@ -300,10 +459,28 @@ pal_hart_create_info_table(HART_INFO_TABLE *PeTable)
     Entry = (EFI_ACPI_6_5_RINTC_STRUCTURE *) ((UINT8 *)Entry + (Entry->Length));
   }while(Length < MadtTableLength);
 
+  if (RhctIndex != NULL)
+    pal_mem_free(RhctIndex);
+
   // gMpidrMax = MpidrAff0Max | MpidrAff1Max | MpidrAff2Max | MpidrAff3Max;
   g_num_hart = PeTable->header.num_of_hart;
 
-  pal_hart_data_cache_ops_by_va((UINT64)PeTable, CLEAN_AND_INVALIDATE);
+  /* Clean the whole table, entries and the detail array after them, once
+     everything is written, one cache block at a time using the smallest
+     CBOM block size of the harts */
+  BlockSize = 0;
+  for (Index = 0; Index < HartIndex; Index++) {
+    if ((PeTable->hart_info[Index].cbom_block_size != 0) &&
+        ((BlockSize == 0) || (PeTable->hart_info[Index].cbom_block_size < BlockSize)))
+      BlockSize = PeTable->hart_info[Index].cbom_block_size;
+  }
+  if (BlockSize == 0)
+    BlockSize = PAL_CACHE_BLOCK_SIZE_MIN;
+
+  End = (UINT64)(HART_INFO_DETAIL_BASE(PeTable) + PeTable->header.num_of_hart);
+  for (Addr = (UINT64)PeTable & ~((UINT64)BlockSize - 1); Addr < End; Addr += BlockSize)
+    pal_hart_data_cache_ops_by_va(Addr, CLEAN_AND_INVALIDATE);
+
   // RV porting TODO: secondary stack allocationg should be ported for RV multi-processor tests
   // pal_hart_data_cache_ops_by_va((UINT64)&gMpidrMax, CLEAN_AND_INVALIDATE);
   // PalAllocateSecondaryStack(gMpidrMax);
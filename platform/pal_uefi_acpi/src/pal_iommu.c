@@ -13,6 +13,38 @@ static EFI_ACPI_6_5_RISC_V_IO_MAPPING_TABLE_STRUCTURE *gRimtHdr;
 UINT64
 pal_get_rimt_ptr();
 
+/**
+  @brief  Count the RIMT device nodes, so that the caller can size the IOMMU info
+          table before it is filled.
+
+  @param  None
+
+  @return Number of IOMMU info entries pal_iommu_create_info_table will fill
+**/
+UINT32
+pal_iommu_get_info_entry_count(VOID)
+{
+  EFI_ACPI_6_5_RISC_V_IO_MAPPING_TABLE_STRUCTURE *RimtHdr;
+  EFI_ACPI_6_5_RIMT_DEVICE_HEADER                *Entry;
+  UINT32                                         Length;
+  UINT32                                         Count = 0;
+
+  RimtHdr = (EFI_ACPI_6_5_RISC_V_IO_MAPPING_TABLE_STRUCTURE *) pal_get_rimt_ptr();
+  if (RimtHdr == NULL)
+    return 0;
+
+  Entry = (EFI_ACPI_6_5_RIMT_DEVICE_HEADER *) ((UINT8 *)RimtHdr + RimtHdr->RimtDeviceOffset);
+  Length = RimtHdr->RimtDeviceOffset;
+
+  do {
+    Length += Entry->Length;
+    Entry = (EFI_ACPI_6_5_RIMT_DEVICE_HEADER *) ((UINT8 *)Entry + (Entry->Length));
+    Count++;
+  } while (Length < RimtHdr->Header.Length);
+
+  return Count;
+}
+
 /**
   @brief  Populate information about the IOMMU sub-system at the input address.
           In a UEFI-ACPI framework, this information is part of the RIMT table.
@@ -24,6 +24,7 @@
 #include  <Library/ShellLib.h>
 #include  <Library/PrintLib.h>
 #include  <Library/BaseMemoryLib.h>
+#include  <Library/SynchronizationLib.h>
 #include <Protocol/Cpu.h>
 
 
@@ -31,6 +32,30 @@
 
 UINT8   *gSharedMemory;
 
+/* Log and result file output is staged here and written out in large blocks */
+#define PAL_LOG_BUFFER_SIZE     0x10000
+#define PAL_LOG_MSG_MAX         1024
+#define PAL_RESULT_BUFFER_SIZE  0x4000
+
+typedef struct {
+  CHAR8  *Data;
+  UINTN  Size;
+  UINTN  Used;
+} PAL_FILE_BUFFER;
+
+STATIC CHAR8  gLogData[PAL_LOG_BUFFER_SIZE];
+STATIC CHAR8  gResultData[ACS_RESULT_NUM_STREAM][PAL_RESULT_BUFFER_SIZE];
+
+STATIC PAL_FILE_BUFFER gLogBuffer = { gLogData, PAL_LOG_BUFFER_SIZE, 0 };
+
+/* Serializes space reservation, formatting and flushing of gLogBuffer, which
+   every HART prints into */
+STATIC SPIN_LOCK       gLogBufferLock = SPIN_LOCK_RELEASED;
+STATIC PAL_FILE_BUFFER gResultBuffer[ACS_RESULT_NUM_STREAM] = {
+  { gResultData[ACS_RESULT_JSON], PAL_RESULT_BUFFER_SIZE, 0 },
+  { gResultData[ACS_RESULT_JUNIT], PAL_RESULT_BUFFER_SIZE, 0 }
+};
+
 /**
  @brief This API provides a single point of abstraction to write 8-bit
         data to all memory-mapped I/O addresses.
@@ -193,7 +218,76 @@ pal_mmio_write(UINT64 addr, UINT32 data)
 }
 
 /**
-  @brief  Sends a formatted string to the output console
+  @brief  Writes the contents of a file buffer to its file and flushes the
+          file so that the output is complete on disk even if the run stops
+          responding afterwards.
+
+  @param  Handle  file the buffer belongs to
+  @param  Buffer  file buffer
+
+  @return Status of the write
+**/
+STATIC
+EFI_STATUS
+pal_file_buffer_flush(SHELL_FILE_HANDLE Handle, PAL_FILE_BUFFER *Buffer)
+{
+  UINTN      BufferSize;
+  EFI_STATUS Status;
+
+  if ((Handle == NULL) || (Buffer->Used == 0))
+    return EFI_SUCCESS;
+
+  BufferSize = Buffer->Used;
+  Buffer->Used = 0;
+
+  Status = ShellWriteFile(Handle, &BufferSize, (VOID *)Buffer->Data);
+  if (!EFI_ERROR(Status))
+    Status = ShellFlushFile(Handle);
+
+  return Status;
+}
+
+/**
+  @brief  Writes the buffered log output to the log file. Called with
+          gLogBuffer locked.
+
+  @param  None
+
+  @return Status of the write
+**/
+STATIC
+EFI_STATUS
+pal_print_flush_locked(VOID)
+{
+  return pal_file_buffer_flush(g_bsa_log_file_handle, &gLogBuffer);
+}
+
+/**
+  @brief  Writes the buffered log output to the log file.
+
+  @param  None
+
+  @return None
+**/
+VOID
+pal_print_flush(VOID)
+{
+  EFI_STATUS Status;
+
+  AcquireSpinLock(&gLogBufferLock);
+  Status = pal_print_flush_locked();
+  ReleaseSpinLock(&gLogBufferLock);
+
+  if (EFI_ERROR(Status))
+    bsa_print(ACS_PRINT_ERR, L" Error in writing to log file\n");
+}
+
+/**
+  @brief  Sends a formatted string to the output console. When a log file
+          is open, the string is also appended to the log buffer, which is
+          written out by pal_print_flush when it cannot hold another message.
+          The buffer is locked from reserving space until the message is
+          printed, so that messages of several HARTs do not overlap.
 
   @param  string  An ASCII string
   @param  data    data for the formatted output
@@ -203,20 +297,109 @@ pal_mmio_write(UINT64 addr, UINT32 data)
 VOID
 pal_print(CHAR8 *string, UINT64 data)
 {
+  CHAR8      *Buffer;
+  EFI_STATUS Status = EFI_SUCCESS;
+
   if(g_bsa_log_file_handle)
   {
-    CHAR8 Buffer[1024];
-    UINTN BufferSize = 1;
-    EFI_STATUS Status = 0;
-    BufferSize = AsciiSPrint(Buffer, 1024, string, data);
+    AcquireSpinLock(&gLogBufferLock);
+    if ((gLogBuffer.Size - gLogBuffer.Used) < PAL_LOG_MSG_MAX)
+      Status = pal_print_flush_locked();
+
+    Buffer = &gLogBuffer.Data[gLogBuffer.Used];
+    gLogBuffer.Used += AsciiSPrint(Buffer, PAL_LOG_MSG_MAX, string, data);
     AsciiPrint(Buffer);
-    Status = ShellWriteFile(g_bsa_log_file_handle, &BufferSize, (VOID*)Buffer);
-    if(EFI_ERROR(Status))
+    ReleaseSpinLock(&gLogBufferLock);
+
+    if (EFI_ERROR(Status))
       bsa_print(ACS_PRINT_ERR, L" Error in writing to log file\n");
   } else
       AsciiPrint(string, data);
 }
 
+STATIC
+SHELL_FILE_HANDLE
+pal_result_get_handle(UINT32 stream)
+{
+  if (stream == ACS_RESULT_JSON)
+    return g_bsa_json_file_handle;
+  if (stream == ACS_RESULT_JUNIT)
+    return g_bsa_junit_file_handle;
+
+  return NULL;
+}
+
+/**
+  @brief  Checks whether a structured result stream has a file open
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+
+  @return 1 if the stream is written, 0 otherwise
+**/
+UINT32
+pal_result_stream_enabled(UINT32 stream)
+{
+  return (pal_result_get_handle(stream) != NULL);
+}
+
+/**
+  @brief  Appends data to a structured result stream. The data is staged in
+          the buffer of the stream and written to its file in large blocks,
+          like the log output.
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+  @param  data    bytes to write
+  @param  len     number of bytes
+
+  @return None
+**/
+VOID
+pal_result_write(UINT32 stream, CHAR8 *data, UINT32 len)
+{
+  SHELL_FILE_HANDLE Handle;
+  PAL_FILE_BUFFER   *Buffer;
+  UINTN             BufferSize;
+  EFI_STATUS        Status = EFI_SUCCESS;
+
+  Handle = pal_result_get_handle(stream);
+  if (Handle == NULL)
+    return;
+
+  Buffer = &gResultBuffer[stream];
+  if ((Buffer->Size - Buffer->Used) < len)
+    Status = pal_file_buffer_flush(Handle, Buffer);
+
+  if (len > Buffer->Size) {
+    BufferSize = len;
+    Status = ShellWriteFile(Handle, &BufferSize, (VOID *)data);
+  } else if (!EFI_ERROR(Status)) {
+    CopyMem(&Buffer->Data[Buffer->Used], data, len);
+    Buffer->Used += len;
+  }
+
+  if (EFI_ERROR(Status))
+    bsa_print(ACS_PRINT_ERR, L" Error in writing to result file\n");
+}
+
+/**
+  @brief  Writes the buffered output of all structured result streams to
+          their files.
+
+  @param  None
+
+  @return None
+**/
+VOID
+pal_result_flush(VOID)
+{
+  UINT32 stream;
+
+  for (stream = 0; stream < ACS_RESULT_NUM_STREAM; stream++) {
+    if (EFI_ERROR(pal_file_buffer_flush(pal_result_get_handle(stream), &gResultBuffer[stream])))
+      bsa_print(ACS_PRINT_ERR, L" Error in writing to result file\n");
+  }
+}
+
 /**
   @brief  Sends a string to the output console without using UEFI print function
           This function will get COMM port address and directly writes to the addr char-by-char
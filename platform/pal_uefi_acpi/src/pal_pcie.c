@@ -39,6 +39,181 @@ static EFI_ACPI_MEMORY_MAPPED_CONFIGURATION_BASE_ADDRESS_TABLE_HEADER *gMcfgHdr;
 UINT64
 pal_get_mcfg_ptr();
 
+static EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL **gRootBridgeIo;
+static UINTN                           gRootBridgeIoCount;
+static BOOLEAN                         gRootBridgeIoBuilt;
+
+/* Orders functions by bus, device, function and then segment, like the PCI scan did */
+#define PCI_IO_MAP_KEY(Seg, Bus, Dev, Func) \
+  ((((Bus) & 0xFF) << 24) | (((Dev) & 0xFF) << 16) | (((Func) & 0xFF) << 8) | ((Seg) & 0xFF))
+
+typedef struct {
+  UINT32               Key;       ///< PCI_IO_MAP_KEY of the function
+  UINT32               ClassReg;  ///< Class code and revision ID register
+  EFI_PCI_IO_PROTOCOL  *Pci;
+} PCI_IO_MAP_ENTRY;
+
+static PCI_IO_MAP_ENTRY *gPciIoMap;
+static UINT32           gPciIoMapCount;
+static BOOLEAN          gPciIoMapBuilt;
+
+/**
+  @brief  Builds the map from PCI location to PciIo protocol. The PciIo
+          handles are located once and each one is asked for its location and
+          class code once, so that later accesses cost one protocol call.
+
+  @param  None
+
+  @return None
+**/
+static VOID
+pal_pcie_io_build_map(VOID)
+{
+  EFI_STATUS                    Status;
+  EFI_PCI_IO_PROTOCOL           *Pci;
+  UINTN                         HandleCount;
+  EFI_HANDLE                    *HandleBuffer;
+  UINTN                         Seg, Bus, Dev, Func;
+  UINT32                        Index;
+  UINT32                        Pos;
+  UINT32                        Key;
+  UINT32                        ClassReg;
+
+  gPciIoMapBuilt = TRUE;
+  gPciIoMapCount = 0;
+
+  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiPciIoProtocolGuid, NULL, &HandleCount, &HandleBuffer);
+  if (EFI_ERROR (Status)) {
+    bsa_print(ACS_PRINT_INFO,L" No PCI devices found in the system\n");
+    return;
+  }
+
+  gPciIoMap = pal_mem_alloc(HandleCount * sizeof(PCI_IO_MAP_ENTRY));
+  if (gPciIoMap == NULL) {
+    pal_mem_free(HandleBuffer);
+    return;
+  }
+
+  for (Index = 0; Index < HandleCount; Index++) {
+    Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciIoProtocolGuid, (VOID **)&Pci);
+    if (EFI_ERROR (Status))
+      continue;
+
+    Pci->GetLocation (Pci, &Seg, &Bus, &Dev, &Func);
+    Status = Pci->Pci.Read (Pci, EfiPciIoWidthUint32, PCI_REVISION_ID_OFFSET, 1, &ClassReg);
+    if (EFI_ERROR (Status))
+      ClassReg = 0;
+
+    /* Handles are mostly in PCI scan order, so this stays close to linear */
+    Key = PCI_IO_MAP_KEY(Seg, Bus, Dev, Func);
+    Pos = gPciIoMapCount;
+    while ((Pos > 0) && (gPciIoMap[Pos - 1].Key > Key)) {
+      gPciIoMap[Pos] = gPciIoMap[Pos - 1];
+      Pos--;
+    }
+    gPciIoMap[Pos].Key      = Key;
+    gPciIoMap[Pos].ClassReg = ClassReg;
+    gPciIoMap[Pos].Pci      = Pci;
+    gPciIoMapCount++;
+  }
+
+  pal_mem_free(HandleBuffer);
+  bsa_print(ACS_PRINT_INFO, L"  PciIo functions mapped : %d\n", gPciIoMapCount);
+}
+
+/**
+  @brief  Returns the index of the first map entry whose key is not below Key
+
+  @param  Key  PCI_IO_MAP_KEY to search for
+
+  @return Map index, gPciIoMapCount if every key is below Key
+**/
+static UINT32
+pal_pcie_io_map_lower_bound(UINT32 Key)
+{
+  UINT32 Low = 0;
+  UINT32 High;
+  UINT32 Mid;
+
+  if (!gPciIoMapBuilt)
+    pal_pcie_io_build_map();
+
+  High = gPciIoMapCount;
+  while (Low < High) {
+    Mid = Low + ((High - Low) >> 1);
+    if (gPciIoMap[Mid].Key < Key)
+      Low = Mid + 1;
+    else
+      High = Mid;
+  }
+
+  return Low;
+}
+
+/**
+  @brief  Returns the PciIo protocol of a PCI function
+
+  @param  Bdf  Segment/Bus/Dev/Func in the format created by PCIE_CREATE_BDF
+
+  @return PciIo protocol, NULL if no PciIo handle has this location
+**/
+EFI_PCI_IO_PROTOCOL *
+pal_pcie_io_get_protocol(UINT32 Bdf)
+{
+  UINT32 Key;
+  UINT32 Index;
+
+  Key = PCI_IO_MAP_KEY(PCIE_EXTRACT_BDF_SEG(Bdf), PCIE_EXTRACT_BDF_BUS(Bdf),
+                       PCIE_EXTRACT_BDF_DEV(Bdf), PCIE_EXTRACT_BDF_FUNC(Bdf));
+  Index = pal_pcie_io_map_lower_bound(Key);
+  if ((Index < gPciIoMapCount) && (gPciIoMap[Index].Key == Key))
+    return gPciIoMap[Index].Pci;
+
+  return NULL;
+}
+
+/**
+    @brief   Returns the Bus, Dev, Function (in the form seg<<24 | bus<<16 | Dev <<8 | func)
+             for a matching class code.
+
+    @param   ClassCode  - is a 32bit value of format ClassCode << 16 | sub_class_code
+    @param   StartBdf   - is 0     : start enumeration from Host bridge
+                          is not 0 : start enumeration from the input segment, bus, dev
+                          this is needed as multiple controllers with same class code are
+                          potentially present in a system.
+    @return  the BDF of the device matching the class code
+**/
+UINT32
+palPcieGetBdf(UINT32 ClassCode, UINT32 StartBdf)
+{
+
+  UINT32                        Index;
+  UINT32                        Key;
+  UINT32                        ClassReg;
+
+  /* Search in an incremental order of bus numbers, device numbers */
+  Index = pal_pcie_io_map_lower_bound(PCI_IO_MAP_KEY(0, PCIE_EXTRACT_BDF_BUS(StartBdf),
+                                                     PCIE_EXTRACT_BDF_DEV(StartBdf), 0));
+
+  for (; Index < gPciIoMapCount; Index++) {
+    Key = gPciIoMap[Index].Key;
+    ClassReg = gPciIoMap[Index].ClassReg;
+    bsa_print(ACS_PRINT_INFO,L"  %03d.%02d.%02d class_code = %d %d\n",
+                (Key >> 24) & 0xFF, (Key >> 16) & 0xFF, (Key >> 8) & 0xFF,
+                (ClassReg >> 16) & 0xFF, (ClassReg >> 24) & 0xFF);
+    if (((ClassReg >> 24) & 0xFF) == ((ClassCode >> 16) & 0xFF)) {
+      if (((ClassReg >> 16) & 0xFF) == ((ClassCode >> 8) & 0xFF)) {
+         /* Found our device */
+         /* Return the BDF   */
+         return (UINT32)(PCIE_CREATE_BDF(Key & 0xFF, (Key >> 24) & 0xFF,
+                                         (Key >> 16) & 0xFF, (Key >> 8) & 0xFF));
+      }
+    }
+  }
+
+  return 0;
+}
+
 /**
   @brief  Returns the PCI ECAM address from the ACPI MCFG Table address
 
@@ -64,6 +239,37 @@ pal_pcie_get_mcfg_ecam()
 }
 
 
+/**
+  @brief  Count the ECAM regions described by the MCFG, so that the caller can
+          size the PCIe info table before it is filled.
+
+  @param  None
+
+  @return  Number of PCIE_INFO_BLOCK entries pal_pcie_create_info_table will fill
+ **/
+UINT32
+pal_pcie_get_info_entry_count(VOID)
+{
+  EFI_ACPI_MEMORY_MAPPED_CONFIGURATION_BASE_ADDRESS_TABLE_HEADER *McfgHdr;
+  UINT32 length = sizeof(EFI_ACPI_MEMORY_MAPPED_CONFIGURATION_BASE_ADDRESS_TABLE_HEADER);
+  UINT32 Count = 0;
+
+  McfgHdr = (EFI_ACPI_MEMORY_MAPPED_CONFIGURATION_BASE_ADDRESS_TABLE_HEADER *) pal_get_mcfg_ptr();
+  if (McfgHdr == NULL)
+      return 0;
+
+  if (PLATFORM_OVERRIDE_PCIE_ECAM_BASE)
+      return 1;
+
+  /* Same walk as pal_pcie_create_info_table, which fills at least one block */
+  do {
+      length += sizeof(EFI_ACPI_MEMORY_MAPPED_ENHANCED_CONFIGURATION_SPACE_BASE_ADDRESS_ALLOCATION_STRUCTURE);
+      Count++;
+  } while (length < McfgHdr->Header.Length);
+
+  return Count;
+}
+
 /**
   @brief  Fill the PCIE Info table with the details of the PCIe sub-system
 
@@ -140,41 +346,16 @@ pal_pcie_io_read_cfg(UINT32 Bdf, UINT32 offset, UINT32 *data)
 
   EFI_STATUS                    Status;
   EFI_PCI_IO_PROTOCOL           *Pci;
-  UINTN                         HandleCount;
-  EFI_HANDLE                    *HandleBuffer;
-  UINTN                         Seg, Bus, Dev, Func;
-  UINT32                        Index;
-  UINT32                        InputSeg, InputBus, InputDev, InputFunc;
-
 
-  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiPciIoProtocolGuid, NULL, &HandleCount, &HandleBuffer);
-  if (EFI_ERROR (Status)) {
-    bsa_print(ACS_PRINT_INFO,L" No PCI devices found in the system\n");
+  Pci = pal_pcie_io_get_protocol(Bdf);
+  if (Pci == NULL)
     return PCIE_NO_MAPPING;
-  }
-
-  InputSeg = PCIE_EXTRACT_BDF_SEG(Bdf);
-  InputBus = PCIE_EXTRACT_BDF_BUS(Bdf);
-  InputDev = PCIE_EXTRACT_BDF_DEV(Bdf);
-  InputFunc = PCIE_EXTRACT_BDF_FUNC(Bdf);
-
-  for (Index = 0; Index < HandleCount; Index++) {
-    Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciIoProtocolGuid, (VOID **)&Pci);
-    if (!EFI_ERROR (Status)) {
-      Pci->GetLocation (Pci, &Seg, &Bus, &Dev, &Func);
-      if (InputSeg == Seg && InputBus == Bus && InputDev == Dev && InputFunc == Func) {
-          Status = Pci->Pci.Read (Pci, EfiPciIoWidthUint32, offset, 1, data);
-          pal_mem_free(HandleBuffer);
-          if (!EFI_ERROR (Status))
-            return 0;
-          else
-            return PCIE_NO_MAPPING;
-      }
-    }
-  }
 
-  pal_mem_free(HandleBuffer);
-  return PCIE_NO_MAPPING;
+  Status = Pci->Pci.Read (Pci, EfiPciIoWidthUint32, offset, 1, data);
+  if (!EFI_ERROR (Status))
+    return 0;
+  else
+    return PCIE_NO_MAPPING;
 }
 
 /**
@@ -190,37 +371,57 @@ VOID
 pal_pcie_io_write_cfg(UINT32 Bdf, UINT32 offset, UINT32 data)
 {
 
-  EFI_STATUS                    Status;
   EFI_PCI_IO_PROTOCOL           *Pci;
-  UINTN                         HandleCount;
-  EFI_HANDLE                    *HandleBuffer;
-  UINTN                         Seg, Bus, Dev, Func;
-  UINT32                        Index;
-  UINT32                        InputSeg, InputBus, InputDev, InputFunc;
-
 
-  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiPciIoProtocolGuid, NULL, &HandleCount, &HandleBuffer);
-  if (EFI_ERROR (Status)) {
-    bsa_print(ACS_PRINT_INFO,L" No PCI devices found in the system\n");
+  Pci = pal_pcie_io_get_protocol(Bdf);
+  if (Pci == NULL)
     return;
-  }
 
-  InputSeg = PCIE_EXTRACT_BDF_SEG(Bdf);
-  InputBus = PCIE_EXTRACT_BDF_BUS(Bdf);
-  InputDev = PCIE_EXTRACT_BDF_DEV(Bdf);
-  InputFunc = PCIE_EXTRACT_BDF_FUNC(Bdf);
+  Pci->Pci.Write (Pci, EfiPciIoWidthUint32, offset, 1, &data);
+}
 
-  for (Index = 0; Index < HandleCount; Index++) {
-    Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciIoProtocolGuid, (VOID **)&Pci);
-    if (!EFI_ERROR (Status)) {
-      Pci->GetLocation (Pci, &Seg, &Bus, &Dev, &Func);
-      if (InputSeg == Seg && InputBus == Bus && InputDev == Dev && InputFunc == Func) {
-          Status = Pci->Pci.Write (Pci, EfiPciIoWidthUint32, offset, 1, &data);
+/**
+    @brief   Returns the PciRootBridgeIo protocol of a PCI segment. The root
+             bridge handles are located once, on the first call.
+
+    @param   Seg  - PCI segment number
+    @return  PciRootBridgeIo protocol, NULL if no root bridge has this segment
+**/
+static EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL *
+pal_pcie_get_root_bridge_io(UINT32 Seg)
+{
+
+  EFI_STATUS                       Status;
+  EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL  *Pci;
+  UINTN                            HandleCount;
+  EFI_HANDLE                       *HandleBuffer;
+  UINT32                           Index;
+
+  if (!gRootBridgeIoBuilt) {
+    gRootBridgeIoBuilt = TRUE;
+    Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiPciRootBridgeIoProtocolGuid, NULL, &HandleCount, &HandleBuffer);
+    if (EFI_ERROR (Status)) {
+      bsa_print(ACS_PRINT_INFO,L" No Root Bridge found in the system\n");
+      return NULL;
+    }
+
+    gRootBridgeIo = pal_mem_alloc(HandleCount * sizeof(EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL *));
+    if (gRootBridgeIo != NULL) {
+      for (Index = 0; Index < HandleCount; Index++) {
+        Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciRootBridgeIoProtocolGuid, (VOID **)&Pci);
+        if (!EFI_ERROR (Status))
+          gRootBridgeIo[gRootBridgeIoCount++] = Pci;
       }
     }
+    pal_mem_free(HandleBuffer);
   }
 
-  pal_mem_free(HandleBuffer);
+  for (Index = 0; Index < gRootBridgeIoCount; Index++) {
+    if (gRootBridgeIo[Index]->SegmentNumber == Seg)
+      return gRootBridgeIo[Index];
+  }
+
+  return NULL;
 }
 
 /**
@@ -238,36 +439,16 @@ pal_pcie_bar_mem_read(UINT32 Bdf, UINT64 address, UINT32 *data)
 
   EFI_STATUS                       Status;
   EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL  *Pci;
-  UINTN                            HandleCount;
-  EFI_HANDLE                       *HandleBuffer;
-  UINT32                           Index;
-  UINT32                           InputSeg;
 
-
-  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiPciRootBridgeIoProtocolGuid, NULL, &HandleCount, &HandleBuffer);
-  if (EFI_ERROR (Status)) {
-    bsa_print(ACS_PRINT_INFO,L" No Root Bridge found in the system\n");
+  Pci = pal_pcie_get_root_bridge_io(PCIE_EXTRACT_BDF_SEG(Bdf));
+  if (Pci == NULL)
     return PCIE_NO_MAPPING;
-  }
-
-  InputSeg = PCIE_EXTRACT_BDF_SEG(Bdf);
-
-  for (Index = 0; Index < HandleCount; Index++) {
-    Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciRootBridgeIoProtocolGuid, (VOID **)&Pci);
-    if (!EFI_ERROR (Status)) {
-      if (Pci->SegmentNumber == InputSeg) {
-          Status = Pci->Mem.Read (Pci, EfiPciIoWidthUint32, address, 1, data);
-          pal_mem_free(HandleBuffer);
-          if (!EFI_ERROR (Status))
-            return 0;
-          else
-            return PCIE_NO_MAPPING;
-      }
-    }
-  }
 
-  pal_mem_free(HandleBuffer);
-  return PCIE_NO_MAPPING;
+  Status = Pci->Mem.Read (Pci, EfiPciIoWidthUint32, address, 1, data);
+  if (!EFI_ERROR (Status))
+    return 0;
+  else
+    return PCIE_NO_MAPPING;
 }
 
 /**
@@ -286,36 +467,16 @@ pal_pcie_bar_mem_write(UINT32 Bdf, UINT64 address, UINT32 data)
 
   EFI_STATUS                       Status;
   EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL  *Pci;
-  UINTN                            HandleCount;
-  EFI_HANDLE                       *HandleBuffer;
-  UINT32                           Index;
-  UINT32                           InputSeg;
 
-
-  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiPciRootBridgeIoProtocolGuid, NULL, &HandleCount, &HandleBuffer);
-  if (EFI_ERROR (Status)) {
-    bsa_print(ACS_PRINT_INFO,L" No Root Bridge found in the system\n");
+  Pci = pal_pcie_get_root_bridge_io(PCIE_EXTRACT_BDF_SEG(Bdf));
+  if (Pci == NULL)
     return PCIE_NO_MAPPING;
-  }
-
-  InputSeg = PCIE_EXTRACT_BDF_SEG(Bdf);
-
-  for (Index = 0; Index < HandleCount; Index++) {
-    Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciRootBridgeIoProtocolGuid, (VOID **)&Pci);
-    if (!EFI_ERROR (Status)) {
-      if (Pci->SegmentNumber == InputSeg) {
-          Status = Pci->Mem.Write (Pci, EfiPciIoWidthUint32, address, 1, &data);
-          pal_mem_free(HandleBuffer);
-          if (!EFI_ERROR (Status))
-            return 0;
-          else
-            return PCIE_NO_MAPPING;
-      }
-    }
-  }
 
-  pal_mem_free(HandleBuffer);
-  return PCIE_NO_MAPPING;
+  Status = Pci->Mem.Write (Pci, EfiPciIoWidthUint32, address, 1, &data);
+  if (!EFI_ERROR (Status))
+    return 0;
+  else
+    return PCIE_NO_MAPPING;
 }
 
 /**
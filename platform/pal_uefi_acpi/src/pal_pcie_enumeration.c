@@ -54,78 +54,8 @@ incrementBusDev(UINT32 StartBdf)
   return PCIE_CREATE_BDF(Seg, Bus, Dev, 0);
 }
 
-/**
-    @brief   Returns the Bus, Dev, Function (in the form seg<<24 | bus<<16 | Dev <<8 | func)
-             for a matching class code.
-
-    @param   ClassCode  - is a 32bit value of format ClassCode << 16 | sub_class_code
-    @param   StartBdf   - is 0     : start enumeration from Host bridge
-                          is not 0 : start enumeration from the input segment, bus, dev
-                          this is needed as multiple controllers with same class code are
-                          potentially present in a system.
-    @return  the BDF of the device matching the class code
-**/
-UINT32
-palPcieGetBdf(UINT32 ClassCode, UINT32 StartBdf)
-{
-
-  EFI_STATUS                    Status;
-  EFI_PCI_IO_PROTOCOL           *Pci;
-  UINTN                         HandleCount;
-  EFI_HANDLE                    *HandleBuffer;
-  UINTN                         Seg, Bus, Dev, Func;
-  UINT32                        Index;
-  PCI_TYPE_GENERIC              PciHeader;
-  PCI_DEVICE_INDEPENDENT_REGION *Hdr;
-  UINT32                        ThisBus, InputBus;
-  UINT32                        ThisDev, InputDev;
-
-
-  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiPciIoProtocolGuid, NULL, &HandleCount, &HandleBuffer);
-  if (EFI_ERROR (Status)) {
-    bsa_print(ACS_PRINT_INFO,L" No PCI devices found in the system\n");
-    return EFI_SUCCESS;
-  }
-
-  InputBus = PCIE_EXTRACT_BDF_BUS(StartBdf);
-  InputDev = PCIE_EXTRACT_BDF_DEV(StartBdf);
-  /* Don't care about multi-function devices for now */
-
-  /* These loops are to search for devices in an incremental order of bus numbers, device numbers */
-  for (ThisBus = InputBus; ThisBus <= PCI_MAX_BUS; ThisBus++) {
-    for (ThisDev = InputDev; ThisDev <= PCI_MAX_DEVICE; ThisDev++) {
-      for (Index = 0; Index < HandleCount; Index++) {
-        Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciIoProtocolGuid, (VOID **)&Pci);
-        if (!EFI_ERROR (Status)) {
-          Pci->GetLocation (Pci, &Seg, &Bus, &Dev, &Func);
-          if (ThisBus != Bus) {
-            continue;
-          }
-          if (ThisDev != Dev) {
-            continue;
-          }
-          Status = Pci->Pci.Read (Pci, EfiPciIoWidthUint32, 0, sizeof (PciHeader)/sizeof (UINT32), &PciHeader);
-          if (!EFI_ERROR (Status)) {
-            Hdr = &PciHeader.Bridge.Hdr;
-            bsa_print(ACS_PRINT_INFO,L"  %03d.%02d.%02d class_code = %d %d\n",
-                        Bus, Dev, Index, Hdr->ClassCode[1], Hdr->ClassCode[2]);
-            if (Hdr->ClassCode[2] == ((ClassCode >> 16) & 0xFF)) {
-              if (Hdr->ClassCode[1] == ((ClassCode >> 8) & 0xFF)) {
-                 /* Found our device */
-                 /* Return the BDF   */
-                 pal_mem_free(HandleBuffer);
-                 return (UINT32)(PCIE_CREATE_BDF(Seg, Bus, Dev, Func));
-              }
-            }
-          }
-        }
-      }
-    }
-  }
-
-  pal_mem_free(HandleBuffer);
-  return 0;
-}
+EFI_PCI_IO_PROTOCOL *
+pal_pcie_io_get_protocol(UINT32 Bdf);
 
 /**
     @brief   Returns the Bus, Dev, Function (in the form seg<<24 | bus<<16 | Dev <<8 | func)
@@ -161,53 +91,28 @@ palPcieGetBase(UINT32 bdf, UINT32 bar_index)
 
   EFI_STATUS                    Status;
   EFI_PCI_IO_PROTOCOL           *Pci;
-  UINTN                         HandleCount;
-  EFI_HANDLE                    *HandleBuffer;
-  UINTN                         Seg, Bus, Dev, Func;
-  UINT32                        Index;
   PCI_TYPE_GENERIC              PciHeader;
   PCI_DEVICE_HEADER_TYPE_REGION *Device;
-  UINT32                        InputSeg, InputBus, InputDev, InputFunc;
   UINT64                        bar_value;
 
-  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiPciIoProtocolGuid, NULL, &HandleCount, &HandleBuffer);
-  if (EFI_ERROR (Status)) {
-    bsa_print(ACS_PRINT_INFO,L" No PCI devices found in the system\n");
-    return EFI_SUCCESS;
-  }
+  Pci = pal_pcie_io_get_protocol(bdf);
+  if (Pci == NULL)
+    return 0;
+
+  Status = Pci->Pci.Read (Pci, EfiPciIoWidthUint32, 0, sizeof (PciHeader)/sizeof (UINT32), &PciHeader);
+  if (EFI_ERROR (Status))
+    return 0;
 
-  InputSeg = (bdf >> 24) & 0xFF;
-  InputBus = (bdf >> 16) & 0xFF;
-  InputDev = (bdf >> 8)  & 0xFF;
-  InputFunc = bdf & 0xFF;
-
-  for (Index = 0; Index < HandleCount; Index++) {
-    Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciIoProtocolGuid, (VOID **)&Pci);
-    if (!EFI_ERROR (Status)) {
-      Pci->GetLocation (Pci, &Seg, &Bus, &Dev, &Func);
-
-      if ((Seg == InputSeg) && (Bus == InputBus) && (Dev == InputDev) && (Func == InputFunc)) {
-          Status = Pci->Pci.Read (Pci, EfiPciIoWidthUint32, 0, sizeof (PciHeader)/sizeof (UINT32), &PciHeader);
-          if (!EFI_ERROR (Status)) {
-            Device = &PciHeader.Device.Device;
-            pal_mem_free(HandleBuffer);
-            if ((((Device->Bar[bar_index]) >> BAR_MDT_SHIFT) & BAR_MDT_MASK) == BITS_64)
-            {
-                bar_value = Device->Bar[bar_index + 1];
-                bar_value = (bar_value << 32) | (Device->Bar[bar_index]);
-                return bar_value;
-            }
-
-            else
-                return (Device->Bar[bar_index]);
-        }
-      }
-
-    }
+  Device = &PciHeader.Device.Device;
+  if ((((Device->Bar[bar_index]) >> BAR_MDT_SHIFT) & BAR_MDT_MASK) == BITS_64)
+  {
+      bar_value = Device->Bar[bar_index + 1];
+      bar_value = (bar_value << 32) | (Device->Bar[bar_index]);
+      return bar_value;
   }
 
-  pal_mem_free(HandleBuffer);
-  return 0;
+  else
+      return (Device->Bar[bar_index]);
 }
 
 /**
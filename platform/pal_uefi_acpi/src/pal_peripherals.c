@@ -38,6 +38,10 @@
 #define BAR2            2
 
 UINT32 spcr_baudrate_id[] = {0, 0, 0, 9600, 19200, 0, 57600, 115200};
+
+/* Memory map entries the memory info table was sized for */
+static UINT32 gMemInfoMaxEntry;
+
 UINT64
 pal_get_spcr_ptr();
 
@@ -233,9 +237,41 @@ IsDeviceMemory(EFI_MEMORY_TYPE type)
 }
 
 
+/**
+  @brief  This API sizes the MEMORY_INFO_TABLE from the current UEFI memory map.
+          Allocating the table and the memory map copy can split descriptors, so
+          a few spare entries are reserved, and pal_memory_create_info_table does
+          not fill more entries than were counted here.
+
+  @param  None
+
+  @return  Number of MEM_INFO_BLOCK entries, including the last entry marker,
+           pal_memory_create_info_table will fill
+**/
+UINT32
+pal_memory_get_info_entry_count(VOID)
+{
+  UINTN                 MemoryMapSize = 0;
+  UINTN                 MapKey;
+  UINTN                 DescriptorSize = 0;
+  UINT32                DescriptorVersion;
+  EFI_STATUS            Status;
+  UINT32                Count;
+
+  Status = gBS->GetMemoryMap (&MemoryMapSize, NULL, &MapKey, &DescriptorSize, &DescriptorVersion);
+  if ((Status != EFI_BUFFER_TOO_SMALL) || (DescriptorSize == 0))
+    Count = 0;
+  else
+    Count = (UINT32)(MemoryMapSize / DescriptorSize) + MEM_INFO_TBL_SPARE_ENTRY;
+
+  gMemInfoMaxEntry = Count;
+  return Count + 1;
+}
+
 /**
   @brief  This API fills in the MEMORY_INFO_TABLE with information about memory in the
-          system. This is achieved by parsing the UEFI memory map.
+          system. This is achieved by parsing the UEFI memory map. The entries
+          are in memory map order, VAL sorts and merges them.
 
   @param  memory_info_table Address where the memory info table is created
 
@@ -261,6 +297,8 @@ pal_memory_create_info_table(MEMORY_INFO_TABLE *memoryInfoTable)
     return;
   }
 
+  memoryInfoTable->info[0].type = MEMORY_TYPE_LAST_ENTRY;
+
 // Retrieve the UEFI Memory Map
 
   MemoryMap = NULL;
@@ -283,6 +321,10 @@ pal_memory_create_info_table(MEMORY_INFO_TABLE *memoryInfoTable)
   if (!EFI_ERROR (Status)) {
     MemoryMapPtr = MemoryMap;
     for (Index = 0; Index < (MemoryMapSize / DescriptorSize); Index++) {
+      if (i >= gMemInfoMaxEntry) {
+        bsa_print(ACS_PRINT_DEBUG, L"  Memory Info tbl limit exceeded, Skipping remaining\n", 0);
+        break;
+      }
           bsa_print(ACS_PRINT_INFO, L"  Reserved region of type %d [0x%lX, 0x%lX]\n",
             MemoryMapPtr->Type, (UINTN)MemoryMapPtr->PhysicalStart,
             (UINTN)(MemoryMapPtr->PhysicalStart + MemoryMapPtr->NumberOfPages * EFI_PAGE_SIZE));
@@ -302,11 +344,8 @@ pal_memory_create_info_table(MEMORY_INFO_TABLE *memoryInfoTable)
       memoryInfoTable->info[i].phy_addr  = MemoryMapPtr->PhysicalStart;
       memoryInfoTable->info[i].virt_addr = MemoryMapPtr->VirtualStart;
       memoryInfoTable->info[i].size      = (MemoryMapPtr->NumberOfPages * EFI_PAGE_SIZE);
+      memoryInfoTable->info[i].flags     = MemoryMapPtr->Attribute;
       i++;
-      if (i >= MEM_INFO_TBL_MAX_ENTRY) {
-        bsa_print(ACS_PRINT_DEBUG, L"  Memory Info tbl limit exceeded, Skipping remaining\n", 0);
-        break;
-      }
 
       MemoryMapPtr = (EFI_MEMORY_DESCRIPTOR*)((UINTN)MemoryMapPtr + DescriptorSize);
     }
@@ -22,6 +22,8 @@
 
 #include <Protocol/AcpiTable.h>
 #include "Include/IndustryStandard/Acpi61.h"
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
 
 #include "include/pal_uefi.h"
 #include "../include/platform_override.h"
@@ -61,6 +63,21 @@ pal_get_rhct_ptr();
 
 // }
 
+/**
+  @brief  This API returns the number of platform timer blocks the TIMER_INFO_TABLE
+          needs room for. The RHCT only describes the time base, so no GT block
+          entries are filled.
+
+  @param  None
+
+  @return  Number of TIMER_INFO_GTBLOCK entries pal_timer_create_info_table will fill
+**/
+UINT32
+pal_timer_get_info_entry_count(VOID)
+{
+  return 0;
+}
+
 /**
   @brief  This API fills in the TIMER_INFO_TABLE with information about local and system
           timers in the system. This is achieved by parsing the ACPI - GTDT table.
@@ -191,6 +208,20 @@ pal_timer_get_counter_frequency(VOID)
   return PLATFORM_OVERRIDE_TIMER_CNTFRQ;
 }
 
+/**
+  @brief  This API returns the current value of the hart time counter.
+          The counter ticks at the RHCT time base frequency.
+
+  @param  None
+
+  @return Time counter value
+**/
+UINT64
+pal_timer_get_counter(VOID)
+{
+  return csr_read(CSR_TIME);
+}
+
 /**
   @brief This API overrides the watch dog timer specified by WdTable
          Note: Only one watchdog information can be assigned as an override
@@ -214,6 +245,45 @@ pal_wd_platform_override(WD_INFO_TABLE *WdTable)
   return;
 }
 
+/**
+  @brief  This API counts the Watchdogs described by the GTDT, so that the caller
+          can size the WD_INFO_TABLE before it is filled.
+
+  @param  None
+
+  @return  Number of WD_INFO_BLOCK entries pal_wd_create_info_table will fill
+**/
+UINT32
+pal_wd_get_info_entry_count(VOID)
+{
+  EFI_ACPI_6_1_GENERIC_TIMER_DESCRIPTION_TABLE         *GtdtHdr;
+  EFI_ACPI_6_1_GTDT_SBSA_GENERIC_WATCHDOG_STRUCTURE    *Entry;
+  UINT32                      num_of_entries;
+  UINT32                      Count = 0;
+
+  GtdtHdr = (EFI_ACPI_6_1_GENERIC_TIMER_DESCRIPTION_TABLE *) pal_get_gtdt_ptr();
+  if (GtdtHdr == NULL)
+    return 0;
+
+  Entry          = (EFI_ACPI_6_1_GTDT_SBSA_GENERIC_WATCHDOG_STRUCTURE *)
+                   ((UINT8 *)GtdtHdr + GtdtHdr->PlatformTimerOffset);
+  num_of_entries = GtdtHdr->PlatformTimerCount;
+
+  while (num_of_entries) {
+    if (Entry->Type == EFI_ACPI_6_1_GTDT_SBSA_GENERIC_WATCHDOG)
+      Count++;
+
+    Entry = (EFI_ACPI_6_1_GTDT_SBSA_GENERIC_WATCHDOG_STRUCTURE *) ((UINT8 *)Entry + (Entry->Length));
+    num_of_entries--;
+  }
+
+  /* The platform override rewrites the first entry */
+  if ((PLATFORM_OVERRIDE_WD == 1) && (Count == 0))
+    Count = 1;
+
+  return Count;
+}
+
 /**
   @brief  This API fills in the WD_INFO_TABLE with information about Watchdogs
           in the system. This is achieved by parsing the ACPI - GTDT table.
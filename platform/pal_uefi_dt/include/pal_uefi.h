@@ -19,6 +19,8 @@
 #define __PAL_UEFI_H__
 
 extern VOID* g_bsa_log_file_handle;
+extern VOID* g_bsa_json_file_handle;
+extern VOID* g_bsa_junit_file_handle;
 extern UINT32 g_print_level;
 extern UINT32 g_print_mmio;
 extern UINT32 g_curr_module;
@@ -32,6 +34,10 @@ extern UINT32 g_pcie_cache_present;
 #define ACS_PRINT_DEBUG 2      /* For Debug statements. contains register dumps etc */
 #define ACS_PRINT_INFO  1      /* Print all statements. Do not use unless really needed */
 
+#define ACS_RESULT_JSON        0   /* JSON lines, written to g_bsa_json_file_handle */
+#define ACS_RESULT_JUNIT       1   /* JUnit XML, written to g_bsa_junit_file_handle */
+#define ACS_RESULT_NUM_STREAM  2
+
 #define PCIE_SUCCESS            0x00000000  /* Operation completed successfully */
 #define PCIE_NO_MAPPING         0x10000001  /* A mapping to a Function does not exist */
 #define PCIE_CAP_NOT_FOUND      0x10000010  /* The specified capability was not found */
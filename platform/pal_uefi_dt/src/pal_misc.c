@@ -212,6 +212,86 @@ pal_print(CHAR8 *string, UINT64 data)
       AsciiPrint(string, data);
 }
 
+/**
+  @brief  Flushes buffered log output. pal_print writes every message to
+          the log file directly, so there is nothing to flush.
+
+  @param  None
+
+  @return None
+**/
+VOID
+pal_print_flush(VOID)
+{
+}
+
+STATIC
+SHELL_FILE_HANDLE
+pal_result_get_handle(UINT32 stream)
+{
+  if (stream == ACS_RESULT_JSON)
+    return g_bsa_json_file_handle;
+  if (stream == ACS_RESULT_JUNIT)
+    return g_bsa_junit_file_handle;
+
+  return NULL;
+}
+
+/**
+  @brief  Checks whether a structured result stream has a file open
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+
+  @return 1 if the stream is written, 0 otherwise
+**/
+UINT32
+pal_result_stream_enabled(UINT32 stream)
+{
+  return (pal_result_get_handle(stream) != NULL);
+}
+
+/**
+  @brief  Writes data to the file of a structured result stream
+
+  @param  stream  ACS_RESULT_JSON or ACS_RESULT_JUNIT
+  @param  data    bytes to write
+  @param  len     number of bytes
+
+  @return None
+**/
+VOID
+pal_result_write(UINT32 stream, CHAR8 *data, UINT32 len)
+{
+  SHELL_FILE_HANDLE Handle;
+  UINTN             BufferSize = len;
+  EFI_STATUS        Status;
+
+  Handle = pal_result_get_handle(stream);
+  if (Handle == NULL)
+    return;
+
+  Status = ShellWriteFile(Handle, &BufferSize, (VOID *)data);
+  if (EFI_ERROR(Status))
+    bsa_print(ACS_PRINT_ERR, L" Error in writing to result file\n");
+}
+
+/**
+  @brief  Flushes the structured result files. pal_result_write writes
+          the data to the files directly, so only the files are flushed.
+
+  @param  None
+
+  @return None
+**/
+VOID
+pal_result_flush(VOID)
+{
+  if (g_bsa_json_file_handle)
+    ShellFlushFile(g_bsa_json_file_handle);
+  if (g_bsa_junit_file_handle)
+    ShellFlushFile(g_bsa_junit_file_handle);
+}
+
 /**
   @brief  Sends a string to the output console without using UEFI print function
           This function will get COMM port address and directly writes to the addr char-by-char
@@ -19,6 +19,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/TimerLib.h>
 
 #include <Protocol/AcpiTable.h>
 #include "Include/IndustryStandard/Acpi61.h"
@@ -174,6 +175,19 @@ pal_timer_get_counter_frequency(VOID)
   return PLATFORM_OVERRIDE_TIMER_CNTFRQ;
 }
 
+/**
+  @brief  This API returns the current value of the system counter
+
+  @param  None
+
+  @return System counter value
+**/
+UINT64
+pal_timer_get_counter(VOID)
+{
+  return GetPerformanceCounter();
+}
+
 /**
   @brief This API overrides the watch dog timer specified by WdTable
          Note: Only one watchdog information can be assigned as an override
@@ -52,7 +52,7 @@ payload (void)
 
   uint32_t index;
   uint32_t e_bdf = 0;
-  uint32_t timeout;
+  VAL_TIMEOUT_t timeout;
   uint32_t status;
   uint32_t num_cards;
   uint32_t num_smmus;
@@ -144,9 +144,9 @@ payload (void)
     val_mmio_write(its_base + GITS_TRANSLATER, lpi_int_id + instance);
 
     /* HART busy polls to check the completion of interrupt service routine */
-    timeout = TIMEOUT_MEDIUM;
-    while ((--timeout > 0) && irq_pending)
-        {};
+    val_timeout_start(&timeout, TIMEOUT_MEDIUM_US);
+    while (irq_pending && !val_timeout_expired(&timeout))
+        val_timeout_backoff(&timeout);
 
     /* Interrupt must not be generated */
     if (irq_pending == 0) {
@@ -162,11 +162,11 @@ payload (void)
     val_exerciser_ops(GENERATE_MSI, msi_index, instance);
 
     /* HART busy polls to check the completion of interrupt service routine */
-    timeout = TIMEOUT_LARGE;
-    while ((--timeout > 0) && irq_pending)
-        {};
+    val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+    while (irq_pending && !val_timeout_expired(&timeout))
+        val_timeout_backoff(&timeout);
 
-    if (timeout == 0) {
+    if (irq_pending) {
         val_print(ACS_PRINT_ERR,
             "\n       Interrupt trigger failed for : 0x%x, ", lpi_int_id + instance);
         val_print(ACS_PRINT_ERR,
@@ -71,7 +71,7 @@ payload (void)
 {
   uint32_t hart_index;
   uint32_t ret_val;
-  uint32_t timeout;
+  VAL_TIMEOUT_t timeout;
   uint32_t e_intr_pin;
   uint32_t status;
   uint32_t count;
@@ -140,10 +140,11 @@ payload (void)
             val_exerciser_ops(GENERATE_L_INTR, e_intr_line, instance);
 
             /* HART busy polls to check the completion of interrupt service routine */
-            timeout = TIMEOUT_LARGE;
-            while ((--timeout > 0) && e_intr_pending);
+            val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+            while (e_intr_pending && !val_timeout_expired(&timeout))
+                val_timeout_backoff(&timeout);
 
-            if (timeout == 0) {
+            if (e_intr_pending) {
                 val_gic_free_irq(e_intr_line, 0);
                 val_print(ACS_PRINT_ERR, "\n       Interrupt trigger failed for bdf 0x%lx", e_bdf);
                 test_fail++;
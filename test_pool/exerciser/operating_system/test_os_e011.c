@@ -51,7 +51,7 @@ payload (void)
 
   uint32_t index;
   uint32_t e_bdf = 0, get_value = 0;
-  uint32_t timeout;
+  VAL_TIMEOUT_t timeout;
   uint32_t status;
   uint32_t num_instance, grp_id = 0, blk_index = 0;
   uint32_t test_skip = 1;
@@ -156,12 +156,12 @@ payload (void)
       val_exerciser_ops(GENERATE_MSI, msi_index, instance);
 
       /* HART busy polls to check the completion of interrupt service routine */
-      timeout = TIMEOUT_LARGE;
-      while ((--timeout > 0) && irq_pending)
-          {};
+      val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+      while (irq_pending && !val_timeout_expired(&timeout))
+          val_timeout_backoff(&timeout);
 
       /* Interrupt must not be generated */
-      if (timeout == 0) {
+      if (irq_pending) {
           val_print(ACS_PRINT_ERR,
               "\n       Interrupt trigger failed int_id : 0x%x", base_lpi_id + instance);
           val_print(ACS_PRINT_ERR,
@@ -51,7 +51,7 @@ payload (void)
 
   uint32_t index;
   uint32_t e_bdf = 0, get_value = 0;
-  uint32_t timeout;
+  VAL_TIMEOUT_t timeout;
   uint32_t status;
   uint32_t num_cards;
   uint32_t num_smmus, num_group;
@@ -150,9 +150,9 @@ payload (void)
     val_exerciser_ops(GENERATE_MSI, msi_index, instance);
 
     /* HART busy polls to check the completion of interrupt service routine */
-    timeout = TIMEOUT_LARGE;
-    while ((--timeout > 0) && irq_pending)
-        {};
+    val_timeout_start(&timeout, TIMEOUT_MEDIUM_US);
+    while (irq_pending && !val_timeout_expired(&timeout))
+        val_timeout_backoff(&timeout);
 
     /* Interrupt must not be generated */
     if (irq_pending == 0) {
@@ -49,7 +49,7 @@ payload()
 
     /*Check CNTHV interrupt received*/
     uint32_t data;
-    uint32_t timeout = TIMEOUT_LARGE;
+    VAL_TIMEOUT_t timeout;
     uint64_t timer_expire_val = 100;
     uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
 
@@ -101,11 +101,11 @@ payload()
     }
 
     val_timer_set_vir_el2(timer_expire_val);
-    while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(index)))) {
-        ;
-    }
+    val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+    while ((IS_RESULT_PENDING(val_get_status(index))) && !val_timeout_expired(&timeout))
+        val_timeout_backoff(&timeout);
 
-    if (timeout == 0) {
+    if (IS_RESULT_PENDING(val_get_status(index))) {
         val_print(ACS_PRINT_ERR,
             "\n       NS EL2 Virtual timer interrupt %d not received", intid);
         val_set_status(index, RESULT_FAIL(TEST_NUM, 4));
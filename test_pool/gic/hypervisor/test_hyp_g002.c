@@ -48,7 +48,7 @@ payload()
 {
 
     /*Check CNTHP interrupt received*/
-    uint32_t timeout = TIMEOUT_LARGE;
+    VAL_TIMEOUT_t timeout;
     uint64_t timer_expire_val = 100;
     uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
 
@@ -87,11 +87,11 @@ payload()
     }
 
     val_timer_set_phy_el2(timer_expire_val);
-    while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(index)))) {
-        ;
-    }
+    val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+    while ((IS_RESULT_PENDING(val_get_status(index))) && !val_timeout_expired(&timeout))
+        val_timeout_backoff(&timeout);
 
-    if (timeout == 0) {
+    if (IS_RESULT_PENDING(val_get_status(index))) {
         val_print(ACS_PRINT_ERR,
             "\n       EL2-Phy timer interrupt not received on INTID: %d   ", intid);
         val_set_status(index, RESULT_FAIL(TEST_NUM, 4));
@@ -56,7 +56,7 @@ payload()
 
     /*Check IIC Maintenance interrupt received*/
     uint32_t data;
-    uint32_t timeout = TIMEOUT_LARGE;
+    VAL_TIMEOUT_t timeout;
     uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
 
     if (val_hart_reg_read(CurrentEL) == AARCH64_EL1) {
@@ -100,11 +100,11 @@ payload()
     data |= 0x7;
     val_gic_reg_write(ICH_HCR_EL2, data);
 
-    while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(index)))) {
-        ;
-    }
+    val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+    while ((IS_RESULT_PENDING(val_get_status(index))) && !val_timeout_expired(&timeout))
+        val_timeout_backoff(&timeout);
 
-    if (timeout == 0) {
+    if (IS_RESULT_PENDING(val_get_status(index))) {
         val_print(ACS_PRINT_ERR, "\n       Interrupt not received within timeout", 0);
         val_set_status(index, RESULT_FAIL(TEST_NUM, 4));
         return;
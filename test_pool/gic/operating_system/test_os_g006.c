@@ -43,7 +43,7 @@ void
 payload()
 {
   /* Check non-secure physical timer Private Peripheral Interrupt (PPI) assignment */
-  uint32_t timeout = TIMEOUT_LARGE;
+  VAL_TIMEOUT_t timeout;
   uint32_t timer_expire_val = 100;
   uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
 
@@ -65,11 +65,11 @@ payload()
   val_gic_install_isr(intid, isr_phy);
   val_timer_set_phy_el1(timer_expire_val);
 
-  while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(index)))) {
-        ;
-  }
+  val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+  while ((IS_RESULT_PENDING(val_get_status(index))) && !val_timeout_expired(&timeout))
+    val_timeout_backoff(&timeout);
 
-  if (timeout == 0) {
+  if (IS_RESULT_PENDING(val_get_status(index))) {
     val_print(ACS_PRINT_ERR,
         "\n       EL0-Phy timer interrupt not received on INTID: %d   ", intid);
     val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
@@ -46,7 +46,7 @@ payload()
   /* Check COMMIRQ interrupt received   (x)    -- not feasible */
   /* Check PMBIRQ interrupt received    (x)    -- requires access to secure monitor */
 
-  uint32_t timeout = TIMEOUT_LARGE;
+  VAL_TIMEOUT_t timeout;
   uint32_t timer_expire_val = 100;
   uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
 
@@ -69,11 +69,11 @@ payload()
   val_gic_install_isr(intid, isr_vir);
   val_timer_set_vir_el1(timer_expire_val);
 
-  while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(index)))) {
-        ;
-  }
+  val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+  while ((IS_RESULT_PENDING(val_get_status(index))) && !val_timeout_expired(&timeout))
+    val_timeout_backoff(&timeout);
 
-  if (timeout == 0) {
+  if (IS_RESULT_PENDING(val_get_status(index))) {
     val_print(ACS_PRINT_ERR,
         "\n       EL0-Virtual timer interrupt not received on INTID: %d   ", intid);
     val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
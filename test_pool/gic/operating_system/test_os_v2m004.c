@@ -46,7 +46,7 @@ payload()
 
   uint32_t num_spi;
   uint32_t instance;
-  uint32_t timeout = TIMEOUT_MEDIUM;
+  VAL_TIMEOUT_t timeout;
   uint32_t msi_frame, min_spi_id;
   uint64_t frame_base;
   uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
@@ -85,12 +85,12 @@ payload()
 
     val_mmio_write(val_get_gicd_base() + GICD_ISPENDR + (4 * reg_offset), 1 << reg_shift);
 
-    while ((timeout > 0) && (IS_RESULT_PENDING(val_get_status(index)))) {
-      timeout--;
-    }
+    val_timeout_start(&timeout, TIMEOUT_MEDIUM_US);
+    while ((IS_RESULT_PENDING(val_get_status(index))) && !val_timeout_expired(&timeout))
+      val_timeout_backoff(&timeout);
 
     /* If the Status is changed that means interrupt handler is called & test is failed. */
-    if (timeout != 0) {
+    if (!IS_RESULT_PENDING(val_get_status(index))) {
       val_print(ACS_PRINT_ERR, "\n       Interrupt generated by GICD registers", 0);
       val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
       return;
@@ -100,11 +100,11 @@ payload()
     /* Generate the Interrupt by writing the int_id to SETSPI_NS Register */
     val_mmio_write(frame_base + GICv2m_MSI_SETSPI, int_id);
 
-    while ((timeout > 0) && (IS_RESULT_PENDING(val_get_status(index)))) {
-      timeout--;
-    }
+    val_timeout_start(&timeout, TIMEOUT_MEDIUM_US);
+    while ((IS_RESULT_PENDING(val_get_status(index))) && !val_timeout_expired(&timeout))
+      val_timeout_backoff(&timeout);
 
-    if (timeout == 0) {
+    if (IS_RESULT_PENDING(val_get_status(index))) {
       val_print(ACS_PRINT_ERR, "\n       Interrupt not received within timeout", 0);
       val_set_status(index, RESULT_FAIL(TEST_NUM, 3));
       return;
@@ -191,7 +191,7 @@ payload(uint32_t num_hart)
 {
   uint32_t my_index = val_hart_get_index_mpid(val_hart_get_mpid());
   uint32_t i;
-  uint32_t timeout;
+  VAL_TIMEOUT_t timeout;
   uint64_t reg_read_data, debug_data=0, array_index=0;
 
   if (num_hart == 1) {
@@ -221,11 +221,12 @@ payload(uint32_t num_hart)
 
   for (i = 0; i < num_hart; i++) {
       if (i != my_index) {
-          timeout=TIMEOUT_LARGE;
           val_execute_on_pe(i, id_regs_check, 0);
-          while ((--timeout) && (IS_RESULT_PENDING(val_get_status(i))));
+          val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+          while ((IS_RESULT_PENDING(val_get_status(i))) && !val_timeout_expired(&timeout))
+              val_timeout_backoff(&timeout);
 
-          if(timeout == 0) {
+          if (IS_RESULT_PENDING(val_get_status(i))) {
               val_print(ACS_PRINT_ERR, "\n       **Timed out** for HART index = %d", i);
               val_set_status(i, RESULT_FAIL(TEST_NUM, 2));
               return;
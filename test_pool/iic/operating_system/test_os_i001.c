@@ -39,15 +39,10 @@ void
 payload()
 {
 
-  char8_t *isa_string;
-  char8_t *ptr;
   uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
   uint64_t imsic_base;
 
-  isa_string = val_hart_get_isa_string(index);
-
-  ptr = val_strstr(isa_string, "ssaia");
-  if (ptr == NULL) {
+  if (!val_hart_has_isa_ext(index, HART_ISA_EXT_SSAIA)) {
     val_print(ACS_PRINT_ERR, "\n       Ssaia not found", 0);
     val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
     return;
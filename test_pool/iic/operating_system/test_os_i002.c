@@ -45,7 +45,7 @@
  * @brief 1. Verify presence of siselect, sireg, stopi, and stopei CSRs.
           2. For each external interrupt identity supported by the S-level interrupt
           file, verify the ability to set the corresponding bit in the eipk and EIEk
-          registers.
+          registers. The registers are swept a whole register at a time.
           3. Verify ability to enable and disable interrupt delivery in the eidelivery
           register.
           4. Map the physical address of the S-mode interrupt register file of the hart
@@ -72,7 +72,8 @@ payload()
   uint64_t imsic_base;
   uint32_t intr_num = val_gic_max_supervisor_intr_num();
   uint32_t eidelivery;
-  uint32_t i;
+  uint32_t fail_eie, fail_eip;
+  uint64_t start;
   uint64_t val;
 
   /* Checkpoint 1: Verify presence of siselect, sireg, stopi, and stopei CSRs. */
@@ -90,33 +91,30 @@ payload()
   */
   val_print(ACS_PRINT_INFO, "\n       S-level interrupt number: %d", intr_num);
 
-  // for (i = 1; i <= intr_num; i++) {    // TODO: QEMU Virt problem? EIEk bit 32~63 read as 0 after set
-  for (i = 1; i <= 31; i++) {
-    /* Check EIEk */
-    // val_print(ACS_PRINT_INFO, "\n         Set EIEk for irq %d", i);
-    val_iic_imsic_eix_update(i, false, 1);
-    val = val_iic_imsic_eix_read(i, false);
-    // val_print(ACS_PRINT_INFO, "\n         Now EIEk is 0x%lx", val);
-    if ((val & BIT(i % __riscv_xlen)) == 0) {
-      val_print(ACS_PRINT_ERR, "\n       Fail to set EIEk for irq %d", i);
-      val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
-      return;
-    }
-    // val_print(ACS_PRINT_INFO, "\n         Clear EIEk for irq %d", i);
-    val_iic_imsic_eix_update(i, false, 0);
-
-    /* Check eipk */
-    // val_print(ACS_PRINT_INFO, "\n         Set EIPk for irq %d", i);
-    val_iic_imsic_eix_update(i, true, 1);
-    val = val_iic_imsic_eix_read(i, true);
-    // val_print(ACS_PRINT_INFO, "\n         Now EIPk is 0x%lx", val);
-    if ((val & BIT(i % __riscv_xlen)) == 0) {
-      val_print(ACS_PRINT_ERR, "\n       Fail to set EIPk for irq %d", i);
-      val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
-      return;
-    }
-    // val_print(ACS_PRINT_INFO, "\n         Clear EIPk for irq %d", i);
-    val_iic_imsic_eix_update(i, true, 0);
+  if ((intr_num == 0) || (intr_num > IMSIC_MAX_ID))
+    intr_num = (intr_num == 0) ? 31 : IMSIC_MAX_ID;
+
+  /* Keep interrupts from being delivered while the pending bits are swept */
+  val_iic_imsic_eidelivery_update(0);
+
+  start = val_timer_get_counter();
+  fail_eie = val_iic_imsic_eix_array_check(intr_num, false);
+  fail_eip = val_iic_imsic_eix_array_check(intr_num, true);
+  val_print(ACS_PRINT_INFO, "\n       S-level file EIE/EIP sweep time (us): %ld",
+            val_timer_ticks_to_us(val_timer_get_counter() - start));
+
+  val_iic_imsic_eidelivery_update(1);
+
+  if (fail_eie) {
+    val_print(ACS_PRINT_ERR, "\n       Fail to set/clear EIEk for irq %d", fail_eie);
+    val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
+    return;
+  }
+
+  if (fail_eip) {
+    val_print(ACS_PRINT_ERR, "\n       Fail to set/clear EIPk for irq %d", fail_eip);
+    val_set_status(index, RESULT_FAIL(TEST_NUM, 2));
+    return;
   }
 
   /* Checkpoint 3: Verify ability to enable and disable interrupt delivery in the eidelivery
@@ -31,7 +31,7 @@
 static uint64_t branch_to_test;
 uint32_t loop_var = LOOP_VAR;
 uint32_t instance = 0;
-uint32_t timeout;
+VAL_TIMEOUT_t timeout;
 
 static
 void
@@ -62,7 +62,7 @@ payload()
 
   branch_to_test = (uint64_t)&&exception_taken_d;
   while (loop_var) {
-      timeout = TIMEOUT_SMALL;
+      val_timeout_start(&timeout, TIMEOUT_SMALL_US);
       /* Get the address of device memory region */
       addr = val_memory_get_addr(MEM_TYPE_DEVICE, instance, &attr);
       if (!addr) {
@@ -74,7 +74,7 @@ payload()
       /* Access must not cause a deadlock */
       original_value = *((volatile addr_t*)addr);
       *((volatile addr_t*)addr) = original_value;
-      while (timeout--)
+      while (!val_timeout_expired(&timeout))
           {};
 
 exception_taken_d:
@@ -88,7 +88,7 @@ normal_mem_test:
   instance = 0;
   branch_to_test = (uint64_t)&&exception_taken_n;
   while (loop_var) {
-      timeout = TIMEOUT_SMALL;
+      val_timeout_start(&timeout, TIMEOUT_SMALL_US);
       /* Get the address of normal memory region */
       addr = val_memory_get_addr((MEMORY_INFO_e)MEMORY_TYPE_NORMAL, instance, &attr);
       if (!addr) {
@@ -100,7 +100,7 @@ normal_mem_test:
       /* Access must not cause a deadlock */
       original_value = *((volatile addr_t*)addr);
       *((volatile addr_t*)addr) = original_value;
-      while (timeout--)
+      while (!val_timeout_expired(&timeout))
           {};
 
 exception_taken_n:
@@ -24,8 +24,22 @@
 #define TEST_RULE  "MF_ECM_010_010"
 #define TEST_DESC  "ECAM Region accessibility check  "
 
+/* Mark test data written by the exception handler, or by a HART that could
+   not install it, instead of a failed read */
+#define SWEEP_EXCEPTION  0xFFFFFFFF
+#define SWEEP_NO_ESR     0xFFFFFFFE
+
+/* Test data of a failed read: the BDF, and the value read above the width */
+#define SWEEP_READ_DATA(value, width)  (((uint64_t)(value) << 8) | (width))
+
 static void *branch_to_test;
 
+/* Sweep partitioning, written by the primary HART before each run. HARTs
+   with an index below g_sweep_num_hart take part, plus the primary HART. */
+static uint32_t g_sweep_num_hart;
+static uint32_t g_sweep_num_part;
+static uint32_t g_sweep_total_bus;
+
 static
 void
 esr(uint64_t interrupt_type, void *context)
@@ -37,17 +51,22 @@ esr(uint64_t interrupt_type, void *context)
   /* Update the ELR to return to test specified address */
   val_hart_update_elr(context, (uint64_t)branch_to_test);
 
-  val_print(ACS_PRINT_INFO, "\n       Received exception of type: %d", interrupt_type);
+  val_set_test_data(hart_index, SWEEP_EXCEPTION, interrupt_type);
   val_set_status(hart_index, RESULT_FAIL(TEST_NUM, 1));
 }
 
 /**
- * @brief 1. Parse ACPI MCFG tables to local all ECAM ranges.
- *        2. For each 4 KiB range in the ECAM range, verify that the following reads
- *           do not cause any errors or exceptions.
+ * @brief Runs on every participating HART, which first installs the
+ *        exception handlers for itself. The buses of all ECAM regions
+ *        are numbered back to back and split into g_sweep_num_part equal
+ *        ranges. Each HART sweeps one range, and for each 4 KiB range of
+ *        it verifies that the following reads do not cause any errors or
+ *        exceptions.
  *           a. 4-bytes at offset 0 - vendor and device ID
  *           b. 2-bytes at offset 0 - vendor ID
  *           c. 1 byte at offset 8 - revision ID
+ *        A failing read is recorded in the test data of the HART, and is
+ *        printed by the primary HART.
  */
 static
 void
@@ -58,8 +77,9 @@ payload(void)
   uint16_t data16;
   uint32_t data32;
   uint32_t num_ecam;
-  uint64_t ecam_base;
+  uint32_t ecam_index;
   uint32_t index;
+  uint32_t part;
   uint32_t bdf = 0;
   uint32_t bus, segment;
   uint32_t end_bus;
@@ -68,41 +88,46 @@ payload(void)
   uint32_t func_index;
   uint32_t ret;
   uint32_t status;
+  uint64_t first, last;
+  uint64_t region_first;
+  uint64_t region_last;
 
   index = val_hart_get_index_mpid(val_hart_get_mpid());
 
   /* Install sync and async handlers to handle exceptions.*/
   status = val_hart_install_esr(EXCEPT_AARCH64_SYNCHRONOUS_EXCEPTIONS, esr);
   status |= val_hart_install_esr(EXCEPT_AARCH64_SERROR, esr);
-  if (status)
-  {
-      val_print(ACS_PRINT_ERR, "\n      Failed in installing the exception handler", 0);
+  if (status) {
+      val_set_test_data(index, SWEEP_NO_ESR, 0);
       val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
       return;
   }
 
   branch_to_test = &&exception_return;
 
+  /* Buses [first, last) of the back to back numbering belong to this HART */
+  part = (index < g_sweep_num_hart) ? index : g_sweep_num_hart;
+  first = ((uint64_t)g_sweep_total_bus * part) / g_sweep_num_part;
+  last = ((uint64_t)g_sweep_total_bus * (part + 1)) / g_sweep_num_part;
+
   num_ecam = val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0);
-  if (num_ecam == 0) {
-      val_print(ACS_PRINT_DEBUG, "\n       No ECAM in MCFG                   ", 0);
-      val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
-      return;
-  }
+  region_first = 0;
 
-  while (num_ecam) {
-      num_ecam--;
-      ecam_base = val_pcie_get_info(PCIE_INFO_ECAM, num_ecam);
-      if (ecam_base == 0) {
-          val_print(ACS_PRINT_ERR, "\n       ECAM Base in MCFG is 0            ", 0);
-          val_set_status(index, RESULT_SKIP(TEST_NUM, 1));
-          return;
-      }
+  for (ecam_index = 0; (ecam_index < num_ecam) && (region_first < last); ecam_index++) {
+      segment = val_pcie_get_info(PCIE_INFO_SEGMENT, ecam_index);
+      bus = val_pcie_get_info(PCIE_INFO_START_BUS, ecam_index);
+      end_bus = val_pcie_get_info(PCIE_INFO_END_BUS, ecam_index);
+      region_last = region_first + (end_bus - bus + 1);
 
-      segment = val_pcie_get_info(PCIE_INFO_SEGMENT, num_ecam);
-      bus = val_pcie_get_info(PCIE_INFO_START_BUS, num_ecam);
-      end_bus = val_pcie_get_info(PCIE_INFO_END_BUS, num_ecam);
+      if (region_last <= first) {
+          region_first = region_last;
+          continue;
+      }
 
+      if (first > region_first)
+          bus += (uint32_t)(first - region_first);
+      if (last < region_last)
+          end_bus -= (uint32_t)(region_last - last);
 
       /* Accessing the BDF PCIe config range */
       for (bus_index = bus; bus_index <= end_bus; bus_index++) {
@@ -112,30 +137,29 @@ payload(void)
                bdf = PCIE_CREATE_BDF(segment, bus_index, dev_index, func_index);
                ret = val_pcie_read_cfg_width(bdf, TYPE01_VIDR, &data32, PCI_WIDTH_UINT32);
                if (ret == PCIE_NO_MAPPING || (data32 == 0)) {
-                  val_print(ACS_PRINT_ERR,
-                        "\n         Incorrect vendor and device ID 0x%08x    ", data32);
+                  val_set_test_data(index, bdf, SWEEP_READ_DATA(data32, PCI_WIDTH_UINT32));
                   val_set_status(index, RESULT_FAIL(TEST_NUM, (bus_index << 8)|dev_index));
                   return;
                }
 
                ret = val_pcie_read_cfg_width(bdf, TYPE01_VIDR, &data16, PCI_WIDTH_UINT16);
                if (ret == PCIE_NO_MAPPING || (data16 == 0)) {
-                  val_print(ACS_PRINT_ERR,
-                        "\n         Incorrect vendor ID %04x    ", data16);
+                  val_set_test_data(index, bdf, SWEEP_READ_DATA(data16, PCI_WIDTH_UINT16));
                   val_set_status(index, RESULT_FAIL(TEST_NUM, (bus_index << 8)|dev_index));
                   return;
                }
 
                ret = val_pcie_read_cfg_width(bdf, TYPE01_RIDR, &data8, PCI_WIDTH_UINT8);
                if (ret == PCIE_NO_MAPPING) {
-                  val_print(ACS_PRINT_ERR,
-                        "\n         Incorrect revision 0x%02x    ", data8);
+                  val_set_test_data(index, bdf, SWEEP_READ_DATA(data8, PCI_WIDTH_UINT8));
                   val_set_status(index, RESULT_FAIL(TEST_NUM, (bus_index << 8)|dev_index));
                   return;
                }
             }
         }
       }
+
+      region_first = region_last;
   }
 
   val_set_status(index, RESULT_PASS(TEST_NUM, 1));
@@ -144,20 +168,222 @@ exception_return:
   return;
 }
 
+/**
+ * @brief Sweeps all ECAM regions split across the HARTs with an index
+ *        below num_hart and the primary HART.
+ *
+ * @param num_hart    number of HARTs from index 0 to run the sweep on
+ * @param total_hart  number of HARTs in the system
+ *
+ * @return time taken by the sweep in microseconds
+ */
+static
+uint64_t
+sweep_run(uint32_t num_hart, uint32_t total_hart)
+{
+  uint32_t i;
+  uint32_t my_index;
+  uint64_t start;
+
+  my_index = val_hart_get_index_mpid(val_hart_get_mpid());
+
+  if (num_hart == 1) {
+      /* Only this HART runs the payload */
+      g_sweep_num_hart = 0;
+      g_sweep_num_part = 1;
+  } else {
+      g_sweep_num_hart = num_hart;
+      g_sweep_num_part = (my_index < num_hart) ? num_hart : num_hart + 1;
+  }
+  val_data_cache_ops_by_va((addr_t)&g_sweep_num_hart, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&g_sweep_num_part, CLEAN_AND_INVALIDATE);
+
+  for (i = 0; i < total_hart; i++)
+      val_set_status(i, RESULT_PENDING(TEST_NUM));
+
+  start = val_timer_get_counter();
+  val_run_test_payload_concurrent(TEST_NUM, num_hart, payload, 0);
+
+  return val_timer_ticks_to_us(val_timer_get_counter() - start);
+}
+
+/**
+ * @brief Times the sweep on 1 HART and then on twice as many HARTs at each
+ *        step up to all HARTs, printing the speedup over a single HART.
+ *        The last run covers all HARTs and gives the test result.
+ *
+ * @param total_hart  number of HARTs in the system
+ *
+ * @return None
+ */
+static
+void
+sweep_timing_summary(uint32_t total_hart)
+{
+  uint32_t num_hart = 1;
+  uint32_t num_part;
+  uint64_t elapsed_us;
+  uint64_t single_us = 0;
+
+  val_print(ACS_PRINT_TEST, "\n       P001_PERF: Buses swept           : %d", g_sweep_total_bus);
+
+  while (1) {
+      elapsed_us = sweep_run(num_hart, total_hart);
+      num_part = g_sweep_num_part;
+      if (num_part == 1)
+          single_us = elapsed_us;
+
+      val_print(ACS_PRINT_TEST, "\n       P001_PERF: HARTs %4d", num_part);
+      val_print(ACS_PRINT_TEST, "  time %ld us", elapsed_us);
+      if (single_us && elapsed_us) {
+          val_print(ACS_PRINT_TEST, "  speedup %ld", single_us / elapsed_us);
+          val_print(ACS_PRINT_TEST, ".%02ld", ((single_us * 100) / elapsed_us) % 100);
+      }
+
+      if (num_hart == total_hart)
+          break;
+
+      num_hart = (num_hart * 2 > total_hart) ? total_hart : num_hart * 2;
+  }
+}
+
+/**
+ * @brief Prints the failing read recorded by one HART in the last run
+ *
+ * @param index  HART index
+ *
+ * @return None
+ */
+static
+void
+sweep_report_hart(uint32_t index)
+{
+  uint64_t data0;
+  uint64_t data1;
+
+  if (!IS_TEST_FAIL(val_get_status(index)))
+      return;
+
+  val_get_test_data(index, &data0, &data1);
+  if (data0 == SWEEP_NO_ESR) {
+      val_print(ACS_PRINT_ERR, "\n      Failed in installing the exception handler", 0);
+      val_print(ACS_PRINT_ERR, " on HART %d", index);
+      return;
+  }
+
+  if (data0 == SWEEP_EXCEPTION) {
+      val_print(ACS_PRINT_INFO, "\n       Received exception of type: %d", data1);
+      val_print(ACS_PRINT_ERR, " on HART %d", index);
+      return;
+  }
+
+  switch (data1 & 0xFF) {
+  case PCI_WIDTH_UINT32:
+      val_print(ACS_PRINT_ERR, "\n         Incorrect vendor and device ID 0x%08x    ", data1 >> 8);
+      break;
+  case PCI_WIDTH_UINT16:
+      val_print(ACS_PRINT_ERR, "\n         Incorrect vendor ID %04x    ", data1 >> 8);
+      break;
+  default:
+      val_print(ACS_PRINT_ERR, "\n         Incorrect revision 0x%02x    ", data1 >> 8);
+      break;
+  }
+  val_print(ACS_PRINT_ERR, "\n         BDF 0x%x", data0);
+  val_print(ACS_PRINT_ERR, " on HART %d    ", index);
+}
+
+/**
+ * @brief Prints the failing read recorded by each HART of the last run,
+ *        including the primary HART when its index is not below total_hart
+ *
+ * @param total_hart  number of HARTs in the system
+ * @param my_index    index of the primary HART
+ *
+ * @return None
+ */
+static
+void
+sweep_report_failures(uint32_t total_hart, uint32_t my_index)
+{
+  uint32_t i;
+
+  for (i = 0; i < total_hart; i++)
+      sweep_report_hart(i);
+
+  if (my_index >= total_hart)
+      sweep_report_hart(my_index);
+}
+
 uint32_t
 os_p001_entry(uint32_t num_hart)
 {
 
   uint32_t status = ACS_STATUS_FAIL;
+  uint32_t num_ecam;
+  uint32_t i;
+  uint32_t my_index;
+  uint32_t primary_fail = 0;
+  uint64_t elapsed_us;
 
-  num_hart = 1;  //This test is run on single processor
+  my_index = val_hart_get_index_mpid(val_hart_get_mpid());
+
+  /* This test is run on single processor. With -perf the sweep is split
+     across the HARTs to time it, and the all-HART run gives the result. */
+  if (!g_perf_mode)
+      num_hart = 1;
 
   status = val_initialize_test(TEST_NUM, TEST_DESC, num_hart);
-  if (status != ACS_STATUS_SKIP)
-      val_run_test_payload(TEST_NUM, num_hart, payload, 0);
+  if (status != ACS_STATUS_SKIP) {
+
+      /* val_initialize_test only resets HARTs 0 .. num_hart - 1 */
+      if (my_index >= num_hart)
+          val_set_status(my_index, RESULT_PENDING(TEST_NUM));
+
+      num_ecam = val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0);
+      if (num_ecam == 0)
+          val_print(ACS_PRINT_DEBUG, "\n       No ECAM in MCFG                   ", 0);
+
+      g_sweep_total_bus = 0;
+      for (i = 0; i < num_ecam; i++) {
+          if (val_pcie_get_info(PCIE_INFO_ECAM, i) == 0) {
+              val_print(ACS_PRINT_ERR, "\n       ECAM Base in MCFG is 0            ", 0);
+              num_ecam = 0;
+              break;
+          }
+          g_sweep_total_bus += val_pcie_get_info(PCIE_INFO_END_BUS, i) -
+                               val_pcie_get_info(PCIE_INFO_START_BUS, i) + 1;
+      }
+      val_data_cache_ops_by_va((addr_t)&g_sweep_total_bus, CLEAN_AND_INVALIDATE);
+
+      if (num_ecam == 0) {
+          for (i = 0; i < num_hart; i++)
+              val_set_status(i, RESULT_SKIP(TEST_NUM, 1));
+          val_set_status(my_index, RESULT_SKIP(TEST_NUM, 1));
+      } else {
+          if (g_perf_mode) {
+              sweep_timing_summary(num_hart);
+          } else {
+              elapsed_us = sweep_run(num_hart, num_hart);
+              val_print(ACS_PRINT_DEBUG, "\n       ECAM sweep on %d HARTs", g_sweep_num_part);
+              val_print(ACS_PRINT_DEBUG, " took %ld us", elapsed_us);
+          }
+
+          sweep_report_failures(num_hart, my_index);
+
+          /* The primary HART sweeps a range too. When its index is not
+             below num_hart, val_check_for_error does not read its status. */
+          if ((num_hart > 1) && (my_index >= num_hart))
+              primary_fail = IS_TEST_FAIL(val_get_status(my_index));
+      }
+  }
 
-  /* get the result from all HART and check for failure */
-  status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
+  /* get the result from all HART and check for failure. A failure of the
+     primary HART is reported through the single HART check, which reads
+     the status of the calling HART. */
+  if (primary_fail)
+      status = val_check_for_error(TEST_NUM, 1, TEST_RULE);
+  else
+      status = val_check_for_error(TEST_NUM, num_hart, TEST_RULE);
 
   val_report_status(0, BSA_ACS_END(TEST_NUM), NULL);
 
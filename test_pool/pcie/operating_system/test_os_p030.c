@@ -57,7 +57,7 @@ payload(void)
   uint32_t test_skip = 1;
   uint64_t bar_base;
   uint32_t status;
-  uint32_t timeout;
+  VAL_TIMEOUT_t timeout;
 
   pcie_device_bdf_table *bdf_tbl_ptr;
 
@@ -139,8 +139,9 @@ payload(void)
        * even cause an sync/async exception.
        */
       bar_data = (*(volatile addr_t *)bar_base);
-      timeout = TIMEOUT_SMALL;
-      while (--timeout > 0);
+      val_timeout_start(&timeout, TIMEOUT_SMALL_US);
+      while (!val_timeout_expired(&timeout))
+          val_timeout_backoff(&timeout);
 
 exception_return:
       /*
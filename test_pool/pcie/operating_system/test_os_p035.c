@@ -69,7 +69,7 @@ payload(void)
   uint32_t test_fails;
   uint32_t test_skip = 1;
   uint32_t idx;
-  uint32_t timeout;
+  VAL_TIMEOUT_t timeout;
   uint32_t status;
   addr_t config_space_addr;
   void *func_config_space;
@@ -153,8 +153,8 @@ payload(void)
 
           /* If Vendor Id is 0xFF after max FLR period, wait
            * for 1 ms and read again. Keep polling for 5 secs */
-          timeout = (5 * TIMEOUT_LARGE);
-          while (timeout-- > 0)
+          val_timeout_start(&timeout, 5 * TIMEOUT_MEDIUM_US);
+          while (!val_timeout_expired(&timeout))
           {
               val_pcie_read_cfg(bdf, 0, &reg_value);
               if ((reg_value & TYPE01_VIDR_MASK) == TYPE01_VIDR_MASK)
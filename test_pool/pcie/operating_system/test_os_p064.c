@@ -46,49 +46,12 @@ static uint32_t check_msi_status(uint32_t dev_index)
   return 0;
 }
 
-/**
-    @brief   Compare two lists of MSI(X) vectors
-
-    @param   list_one    pointer to a first list of MSI(X) vectors
-    @param   list_two    pointer to a second list of MSI(X) vectors
-
-    @return  0    no vectors duplicates are found
-    @return  1    lists contain at leas one common MSI(X) vector
-**/
-static
-uint32_t
-check_list_duplicates (PERIPHERAL_VECTOR_LIST *list_one, PERIPHERAL_VECTOR_LIST *list_two)
-{
-  PERIPHERAL_VECTOR_LIST *flist_node;
-  PERIPHERAL_VECTOR_LIST *slist_node;
-
-  uint32_t fcount = 0;
-  uint32_t scount = 0;
-  uint32_t irq_start1, irq_end1;
-  uint32_t irq_start2, irq_end2;
-
-  flist_node = list_one;
-  slist_node = list_two;
-
-  while (flist_node != NULL) {
-    while (slist_node != NULL) {
-      irq_start1 = flist_node->vector.vector_irq_base;
-      irq_end1 = flist_node->vector.vector_irq_base + flist_node->vector.vector_n_irqs - 1;
-      irq_start2 = slist_node->vector.vector_irq_base;
-      irq_end2 = slist_node->vector.vector_irq_base + slist_node->vector.vector_n_irqs - 1;
-      if (!(irq_end1 < irq_start2 || irq_start1 > irq_end2))
-        return 1;
-      slist_node = slist_node->next;
-      scount++;
-    }
-    slist_node = list_two;
-    flist_node = flist_node->next;
-    fcount++;
-    scount = 0;
-  }
-
-  return 0;
-}
+/* One MSI(X) vector block and the device it belongs to */
+typedef struct {
+  uint32_t irq_start;
+  uint32_t irq_end;
+  uint32_t bdf;
+} MSI_VECTOR_RANGE;
 
 /**
     @brief   Free memory allocated for a list of MSI(X) vectors
@@ -110,6 +73,108 @@ clean_msi_list (PERIPHERAL_VECTOR_LIST *list)
   }
 }
 
+static
+void
+sift_down_range (MSI_VECTOR_RANGE *range, uint32_t root, uint32_t num)
+{
+  uint32_t child;
+  MSI_VECTOR_RANGE tmp;
+
+  while ((child = (2 * root) + 1) < num) {
+    if ((child + 1 < num) && (range[child + 1].irq_start > range[child].irq_start))
+      child++;
+    if (range[root].irq_start >= range[child].irq_start)
+      return;
+    tmp = range[root];
+    range[root] = range[child];
+    range[child] = tmp;
+    root = child;
+  }
+}
+
+/**
+    @brief   Heap sort MSI(X) vector blocks by their first IRQ
+
+    @param   range   array of vector blocks
+    @param   num     number of blocks
+**/
+static
+void
+sort_msi_ranges (MSI_VECTOR_RANGE *range, uint32_t num)
+{
+  uint32_t i;
+  MSI_VECTOR_RANGE tmp;
+
+  if (num < 2)
+    return;
+
+  for (i = num / 2; i > 0; i--)
+    sift_down_range (range, i - 1, num);
+
+  for (i = num - 1; i > 0; i--) {
+    tmp = range[0];
+    range[0] = range[i];
+    range[i] = tmp;
+    sift_down_range (range, 0, i);
+  }
+}
+
+/**
+    @brief   Find two vector blocks of different devices that share an IRQ.
+             The blocks must be sorted by first IRQ. While walking them, the
+             block reaching furthest and the block reaching furthest among
+             the other devices are kept, so a block overlaps an earlier block
+             of another device exactly when it starts before one of them ends.
+
+    @param   range   sorted array of vector blocks
+    @param   num     number of blocks
+    @param   first   index of the earlier block of a conflict
+    @param   second  index of the later block of a conflict
+
+    @return  0    no vectors duplicates are found
+    @return  1    a conflict is returned in first and second
+**/
+static
+uint32_t
+find_range_duplicate (MSI_VECTOR_RANGE *range, uint32_t num, uint32_t *first, uint32_t *second)
+{
+  uint32_t i;
+  uint32_t top = 0;
+  uint32_t other = 0;
+  uint32_t other_valid = 0;
+  uint32_t cand;
+
+  for (i = 1; i < num; i++) {
+    if (range[top].bdf != range[i].bdf) {
+      cand = top;
+    } else if (other_valid) {
+      cand = other;
+    } else {
+      cand = i;
+    }
+
+    if ((cand != i) && (range[i].irq_start <= range[cand].irq_end)) {
+      *first = cand;
+      *second = i;
+      return 1;
+    }
+
+    if (range[i].irq_end > range[top].irq_end) {
+      if (range[i].bdf != range[top].bdf) {
+        other = top;
+        other_valid = 1;
+      }
+      top = i;
+    } else if ((range[i].bdf != range[top].bdf) &&
+               (!other_valid || (range[i].irq_end > range[other].irq_end))) {
+      other = i;
+      other_valid = 1;
+    }
+  }
+
+  return 0;
+}
+
 static
 void
 payload (void)
@@ -117,13 +182,14 @@ payload (void)
 
   uint32_t count = val_peripheral_get_info (NUM_ALL, 0);
   uint32_t index = val_hart_get_index_mpid (val_hart_get_mpid());
-  uint8_t status;
-  PERIPHERAL_VECTOR_LIST *current_dev_mvec;
-  PERIPHERAL_VECTOR_LIST *next_dev_mvec;
-  uint64_t current_dev_bdf;
-  uint64_t next_dev_bdf;
-  uint32_t count_next;
-  uint32_t test_skip = 1;
+  PERIPHERAL_VECTOR_LIST **dev_mvec;
+  PERIPHERAL_VECTOR_LIST *node;
+  MSI_VECTOR_RANGE *range = NULL;
+  uint32_t *dev_bdf;
+  uint32_t num_dev = 0;
+  uint32_t num_range = 0;
+  uint32_t first, second;
+  uint32_t i;
 
   if (!count) {
      val_print(ACS_PRINT_DEBUG, "\n       No peripherals found. Skipping test", 0);
@@ -131,60 +197,88 @@ payload (void)
      return;
   }
 
-  status = 0;
-  current_dev_mvec = NULL;
-  next_dev_mvec = NULL;
+  dev_mvec = val_memory_calloc (count, sizeof(PERIPHERAL_VECTOR_LIST *));
+  dev_bdf = val_memory_calloc (count, sizeof(uint32_t));
+  if ((dev_mvec == NULL) || (dev_bdf == NULL)) {
+     val_print(ACS_PRINT_ERR, "\n       Memory allocation failed", 0);
+     val_set_status (index, RESULT_FAIL(TEST_NUM, 03));
+     goto free_dev;
+  }
 
   /*
-    Pull each discovered PCI device and its list of MSI(X) vectors.
-    Compare this list with MSI(X) vector lists of other discovered
-    PCI devices and find duplicates exist.
+    Read the list of MSI(X) vectors of each discovered PCI device once,
+    then gather the vector blocks of all devices into one array.
   */
-  while (count > 0 && !status) {
-    count_next = count - 1;
+  while (count > 0) {
     if (check_msi_status (count - 1)) {
       /* Get BDF of a device */
-      current_dev_bdf = val_peripheral_get_info (ANY_BDF, count - 1);
-      if (current_dev_bdf) {
-        val_print (ACS_PRINT_DEBUG, "\n       Checking PCI device with BDF 0x%X", current_dev_bdf);
+      dev_bdf[num_dev] = val_peripheral_get_info (ANY_BDF, count - 1);
+      if (dev_bdf[num_dev]) {
+        val_print (ACS_PRINT_DEBUG, "\n       Checking PCI device with BDF 0x%X", dev_bdf[num_dev]);
         /* Read MSI(X) vectors */
-        if (val_get_msi_vectors (current_dev_bdf, &current_dev_mvec)) {
-
-          /* Pull other PCI devices left in the devices list */
-          while (count_next > 0 && !status) {
-            if (check_msi_status (count_next - 1)) {
-              /* Get BDF of a device */
-              next_dev_bdf = val_peripheral_get_info (ANY_BDF, count_next - 1);
-              /* Read MSI(X) vectors */
-              if (val_get_msi_vectors (next_dev_bdf, &next_dev_mvec)) {
-                test_skip = 0;
-                /* Compare two lists of MSI(X) vectors */
-                if (check_list_duplicates (current_dev_mvec, next_dev_mvec)) {
-                  val_print (ACS_STATUS_ERR, "\n       Allocated MSIs are not unique", 0);
-                  val_set_status (index, RESULT_FAIL(TEST_NUM, 02));
-                  status = 1;
-                }
-                clean_msi_list (next_dev_mvec);
-              }
-            }
-            count_next--;
-          }
-
-          clean_msi_list (current_dev_mvec);
+        if (val_get_msi_vectors (dev_bdf[num_dev], &dev_mvec[num_dev])) {
+          for (node = dev_mvec[num_dev]; node != NULL; node = node->next)
+            num_range++;
+          num_dev++;
         }
       } else {
-        val_print (ACS_PRINT_DEBUG, "\n       Invalid BDF 0x%x", current_dev_bdf);
+        val_print (ACS_PRINT_DEBUG, "\n       Invalid BDF 0x%x", dev_bdf[num_dev]);
       }
     }
     count--;
   }
 
-  if (test_skip) {
-    val_print(ACS_PRINT_ERR, "\n       No MSI vectors found ", 0);;
+  if ((num_dev < 2) || (num_range == 0)) {
+    val_print(ACS_PRINT_ERR, "\n       No MSI vectors found ", 0);
     val_set_status (index, RESULT_SKIP(TEST_NUM, 01));
-  } else  if (!status) {
+    goto free_lists;
+  }
+
+  range = val_memory_calloc (num_range, sizeof(MSI_VECTOR_RANGE));
+  if (range == NULL) {
+    val_print(ACS_PRINT_ERR, "\n       Memory allocation failed", 0);
+    val_set_status (index, RESULT_FAIL(TEST_NUM, 03));
+    goto free_lists;
+  }
+
+  num_range = 0;
+  for (i = 0; i < num_dev; i++) {
+    for (node = dev_mvec[i]; node != NULL; node = node->next) {
+      if (node->vector.vector_n_irqs == 0)
+        continue;
+      range[num_range].irq_start = node->vector.vector_irq_base;
+      range[num_range].irq_end = node->vector.vector_irq_base + node->vector.vector_n_irqs - 1;
+      range[num_range].bdf = dev_bdf[i];
+      num_range++;
+    }
+  }
+
+  /* Sort the blocks by first IRQ and look for overlaps between devices */
+  sort_msi_ranges (range, num_range);
+
+  if (find_range_duplicate (range, num_range, &first, &second)) {
+    val_print (ACS_PRINT_ERR, "\n       Allocated MSIs are not unique", 0);
+    val_print (ACS_PRINT_ERR, "\n       BDF 0x%x", range[first].bdf);
+    val_print (ACS_PRINT_ERR, " IRQs 0x%x", range[first].irq_start);
+    val_print (ACS_PRINT_ERR, " - 0x%x", range[first].irq_end);
+    val_print (ACS_PRINT_ERR, "\n       BDF 0x%x", range[second].bdf);
+    val_print (ACS_PRINT_ERR, " IRQs 0x%x", range[second].irq_start);
+    val_print (ACS_PRINT_ERR, " - 0x%x", range[second].irq_end);
+    val_set_status (index, RESULT_FAIL(TEST_NUM, 02));
+  } else {
     val_set_status (index, RESULT_PASS(TEST_NUM, 01));
   }
+
+  val_memory_free (range);
+
+free_lists:
+  for (i = 0; i < num_dev; i++)
+    clean_msi_list (dev_mvec[i]);
+free_dev:
+  if (dev_mvec != NULL)
+    val_memory_free (dev_mvec);
+  if (dev_bdf != NULL)
+    val_memory_free (dev_bdf);
 }
 
 uint32_t
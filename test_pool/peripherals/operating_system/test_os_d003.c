@@ -183,7 +183,7 @@ payload1()
 {
   uint32_t count = val_peripheral_get_info(NUM_UART, 0);
   uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
-  uint32_t timeout = TIMEOUT_LARGE;
+  VAL_TIMEOUT_t timeout;
   uint32_t interface_type;
 
   if (count == 0) {
@@ -193,7 +193,6 @@ payload1()
   }
   val_set_status(index, RESULT_SKIP(TEST_NUM1, 1));
   while (count != 0) {
-      timeout = TIMEOUT_MEDIUM;
       int_id    = val_peripheral_get_info(UART_GSIV, count - 1);
       interface_type = val_peripheral_get_info(UART_INTERFACE_TYPE, count - 1);
       l_uart_base = val_peripheral_get_info(UART_BASE0, count - 1);
@@ -217,10 +216,11 @@ payload1()
               val_print_raw(l_uart_base, g_print_level,
                             "\n       Test Message                          ", 0);
 
-              while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(index)))) {
-              };
+              val_timeout_start(&timeout, TIMEOUT_MEDIUM_US);
+              while ((IS_RESULT_PENDING(val_get_status(index))) && !val_timeout_expired(&timeout))
+                  val_timeout_backoff(&timeout);
 
-              if (timeout == 0) {
+              if (IS_RESULT_PENDING(val_get_status(index))) {
                  val_print(ACS_PRINT_ERR,
                  "\n       Did not receive UART interrupt on %d  ",
                  int_id);
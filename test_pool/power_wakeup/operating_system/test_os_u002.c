@@ -121,7 +121,7 @@ static
 void
 payload()
 {
-  uint64_t timeout = TIMEOUT_SMALL;
+  VAL_TIMEOUT_t timeout;
   uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
   uint32_t target_pe, status;
   uint64_t timer_expire_ticks = TIMEOUT_SMALL;
@@ -176,10 +176,11 @@ payload()
 
   // Step6: Wait for target HART to update the status, if a timeout occurs that would mean that
   //        target HART was not able to wakeup
-  while ((IS_TEST_PASS(val_get_status(target_pe))) && (--timeout))
-  ;
+  val_timeout_start(&timeout, TIMEOUT_SMALL_US);
+  while ((IS_TEST_PASS(val_get_status(target_pe))) && !val_timeout_expired(&timeout))
+      val_timeout_backoff(&timeout);
 
-  if (timeout == 0)
+  if (IS_TEST_PASS(val_get_status(target_pe)))
       val_print(ACS_PRINT_ERR, "\n       Target HART was not able to wake up successfully "
                                 "from sleep \n       due to watchdog/sytimer interrupt", 0);
 
@@ -203,9 +204,9 @@ payload()
 
   // Step8: Wait for target HART to switch itself off, if it still doesn't switch off timeout
   //        value should be increased
-  timeout = TIMEOUT_MEDIUM;
-  while (--timeout)
-  ;
+  val_timeout_start(&timeout, TIMEOUT_MEDIUM_US);
+  while (!val_timeout_expired(&timeout))
+      val_timeout_backoff(&timeout);
 
   // Step9: Generate timer interrupt again, when target HART is off and make sure it doesn't wakeup
   val_gic_route_interrupt_to_pe(intid, val_hart_get_mpid_index(target_pe));
@@ -231,11 +232,11 @@ payload()
   val_print(ACS_PRINT_ERR, "\n       Interrupt generating sequence triggered", 0);
 
   // Step10: wait for interrupt to become active or pending for a timeout duration
-  timeout = TIMEOUT_MEDIUM;
-  while ((--timeout) && (0 == val_gic_get_interrupt_state(intid)))
-  ;
+  val_timeout_start(&timeout, TIMEOUT_MEDIUM_US);
+  while ((0 == val_gic_get_interrupt_state(intid)) && !val_timeout_expired(&timeout))
+      val_timeout_backoff(&timeout);
 
-  if (timeout == 0)
+  if (0 == val_gic_get_interrupt_state(intid))
       val_print(ACS_PRINT_ERR, "\n       No pending interrupt was seen for the 2nd interrupt", 0);
 
   if (1 == val_gic_get_interrupt_state(intid)) {
@@ -35,14 +35,9 @@ static
 void
 payload()
 {
-  char8_t *isa_string;
-  char8_t *ptr;
   uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
 
-  isa_string = val_hart_get_isa_string(index);
-
-  ptr = val_strstr(isa_string, "ssqosid");
-  if (ptr == NULL) {
+  if (!val_hart_has_isa_ext(index, HART_ISA_EXT_SSQOSID)) {
     val_print(ACS_PRINT_ERR, "\n       Ssqosid not found", 0);
     val_set_status(index, RESULT_FAIL(TEST_NUM, 1));
     return;
@@ -30,30 +30,17 @@
   #define G_SW_HYP           1
   #define G_SW_PS            2
 
-  /* Note : Total Size Required for Info tables ~ 550 KB
-   * Table size is required to be updated whenever new members
-   * are added in the info table structures
+  /* Note : The HART, IOMMU, IIC, Timer, Watchdog, PCIe, Memory and MNG info
+   * tables are sized at runtime from the entries the PAL counts, see
+   * val_<module>_get_info_table_size(). Only the tables below still use a
+   * fixed size.
    */
 
   /* Please MAKE SURE all the table sizes are 16 Bytes aligned */
-  #define PE_INFO_TBL_SZ         16384  /*Supports max 400 PEs     */
-                                        /*[24 B Each + 4 B Header] */
-  #define IOMMU_INFO_TBL_SZ      2048
-  #define GIC_INFO_TBL_SZ        240000 /*Supports max 832 IIC info (GICH,CPUIF,RD,ITS,MSI,D)*/
-                                        /*[48 B Each + 32 B Header]*/
-  #define TIMER_INFO_TBL_SZ      2048   /*Supports max 4 system timers*/
-                                        /*[248 B Each + 56 B Header]  */
-  #define WD_INFO_TBL_SZ         512    /*Supports max 20 Watchdogs*/
-                                        /*[24 B Each + 4 B Header] */
-  #define MEM_INFO_TBL_SZ        32768  /*Supports max 800 memory regions*/
-                                        /*[40 B Each + 16 B Header]      */
   // #define IOVIRT_INFO_TBL_SZ     1048576/*Supports max 2400 nodes of a typical iort table*/
                                         /*[(268+32*5) B Each + 24 B Header]*/
   // #define PERIPHERAL_INFO_TBL_SZ 2048   /*Supports max 20 PCIe EPs (USB and SATA controllers)*/
                                         /*[72 B Each + 16 B Header]*/
-  #define PCIE_INFO_TBL_SZ       512    /*Supports max 20 RC's    */
-                                        /*[24 B Each + 4 B Header]*/
-  #define MNG_INFO_TBL_SZ        1024   /*Size TBD*/
 
 
   #ifdef _AARCH64_BUILD_
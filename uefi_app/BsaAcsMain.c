@@ -55,9 +55,13 @@ UINT32  g_num_modules = 0;
    of EL1 phy and virt timer, Below command line option is added only for debug
    purpose to complete BSA run on these systems */
 UINT32  g_el1physkip = FALSE;
+UINT32  g_perf_mode = FALSE;
+UINT32  g_hart_park = TRUE;
 
 SHELL_FILE_HANDLE g_bsa_log_file_handle;
 SHELL_FILE_HANDLE g_dtb_log_file_handle;
+SHELL_FILE_HANDLE g_bsa_json_file_handle;
+SHELL_FILE_HANDLE g_bsa_junit_file_handle;
 
 STATIC VOID FlushImage (VOID)
 {
@@ -82,9 +86,9 @@ createPeInfoTable (
 
   UINT64   *PeInfoTable;
 
-/* allowing room for growth, at present each entry is 16 bytes, so we can support upto 511 PEs with 8192 bytes*/
+  /* Size the table from the HARTs the PAL counts in the MADT */
   Status = gBS->AllocatePool ( EfiBootServicesData,
-                               PE_INFO_TBL_SZ,
+                               val_hart_get_info_table_size(),
                                (VOID **) &PeInfoTable );
 
   if (EFI_ERROR(Status))
@@ -107,7 +111,7 @@ createIommuInfoTable(
   UINT64      *IommuInfoTable;
 
   Status = gBS->AllocatePool ( EfiBootServicesData,
-                               IOMMU_INFO_TBL_SZ,
+                               val_iommu_get_info_table_size(),
                                (VOID **) &IommuInfoTable );
 
   if (EFI_ERROR(Status))
@@ -130,7 +134,7 @@ createGicInfoTable (
   UINT64     *GicInfoTable;
 
   Status = gBS->AllocatePool (EfiBootServicesData,
-                               GIC_INFO_TBL_SZ,
+                               val_gic_get_info_table_size(),
                                (VOID **) &GicInfoTable);
 
   if (EFI_ERROR(Status))
@@ -154,7 +158,7 @@ createMngInfoTable (
   UINT64     *MngInfoTable;
 
   Status = gBS->AllocatePool (EfiBootServicesData,
-                               MNG_INFO_TBL_SZ,
+                               sizeof(MNG_INFO_TABLE),
                                (VOID **) &MngInfoTable);
 
   if (EFI_ERROR(Status))
@@ -178,7 +182,7 @@ createTimerInfoTable(
   EFI_STATUS Status;
 
   Status = gBS->AllocatePool (EfiBootServicesData,
-                              TIMER_INFO_TBL_SZ,
+                              val_timer_get_info_table_size(),
                               (VOID **) &TimerInfoTable);
 
   if (EFI_ERROR(Status))
@@ -200,7 +204,7 @@ createWatchdogInfoTable(
   EFI_STATUS Status;
 
   Status = gBS->AllocatePool (EfiBootServicesData,
-                              WD_INFO_TBL_SZ,
+                              val_wd_get_info_table_size(),
                               (VOID **) &WdInfoTable);
 
   if (EFI_ERROR(Status))
@@ -224,7 +228,7 @@ createPcieVirtInfoTable(
   EFI_STATUS Status;
 
   Status = gBS->AllocatePool (EfiBootServicesData,
-                              PCIE_INFO_TBL_SZ,
+                              val_pcie_get_info_table_size(),
                               (VOID **) &PcieInfoTable);
 
   if (EFI_ERROR(Status))
@@ -270,7 +274,7 @@ createPeripheralInfoTable(
   val_peripheral_create_info_table(PeripheralInfoTable);
 
   Status = gBS->AllocatePool (EfiBootServicesData,
-                              MEM_INFO_TBL_SZ,
+                              val_memory_get_info_table_size(),
                               (VOID **) &MemoryInfoTable);
 
   if (EFI_ERROR(Status))
@@ -301,12 +305,62 @@ freeBsaAcsMem()
   val_free_shared_mem();
 }
 
+/**
+  @brief  Parse a comma separated list of test or module numbers and
+          ranges, e.g. "801,805-810,901", into a test selection list.
+
+  @param  CmdLineArg  option value
+  @param  List        VAL_SELECT_SKIP, VAL_SELECT_TEST or VAL_SELECT_MODULE
+
+  @return EFI_SUCCESS, or EFI_INVALID_PARAMETER if the list is malformed
+**/
+STATIC
+EFI_STATUS
+ParseTestList (
+  CONST CHAR16 *CmdLineArg,
+  UINT32       List
+  )
+{
+  UINT32 First;
+  UINT32 Last;
+
+  while (*CmdLineArg != L'\0') {
+    if (!ShellIsDecimalDigitCharacter(*CmdLineArg))
+      return EFI_INVALID_PARAMETER;
+
+    First = 0;
+    while (ShellIsDecimalDigitCharacter(*CmdLineArg) && (First < VAL_TEST_NUM_MAX))
+      First = (First * 10) + (*CmdLineArg++ - L'0');
+
+    Last = First;
+    if (*CmdLineArg == L'-') {
+      CmdLineArg++;
+      if (!ShellIsDecimalDigitCharacter(*CmdLineArg))
+        return EFI_INVALID_PARAMETER;
+
+      Last = 0;
+      while (ShellIsDecimalDigitCharacter(*CmdLineArg) && (Last < VAL_TEST_NUM_MAX))
+        Last = (Last * 10) + (*CmdLineArg++ - L'0');
+    }
+
+    if (val_test_select_add(List, First, Last) != ACS_STATUS_PASS)
+      return EFI_INVALID_PARAMETER;
+
+    if (*CmdLineArg == L',')
+      CmdLineArg++;
+    else if (*CmdLineArg != L'\0')
+      return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
 VOID
 HelpMsg (
   VOID
   )
 {
-  Print (L"\nUsage: Bsa.efi [-v <n>] | [-f <filename>] | [-skip <n>] | [-t <n>] | [-m <n>]\n"
+  Print (L"\nUsage: Bsa.efi [-v <n>] | [-f <filename>] | [-json <filename>] | [-junit <filename>] | [-skip <n>] | [-t <n>] | [-m <n>]\n"
          "Options:\n"
          "-v      Verbosity of the prints\n"
          "        1 prints all, 5 prints only the errors\n"
@@ -317,7 +371,11 @@ HelpMsg (
          "              E.g., To enable mmio prints for HART and TIMER pass -v 104\n"
          "-mmio   Pass this flag to enable pal_mmio_read/write prints, use with -v 1\n"
          "-f      Name of the log file to record the test results in\n"
+         "-json   Name of the file to record one JSON line per test in\n"
+         "-junit  Name of the file to record the test results in as JUnit XML\n"
          "-skip   Test(s) to be skipped\n"
+         "        Lists are comma separated and take ranges, e.g. -skip 801,805-810\n"
+         "        A module ID skips the whole module only as a single entry, not in a range\n"
          "        Refer to section 4 of BSA ACS User Guide\n"
          "        To skip a module, use Module ID as mentioned in user guide\n"
          "        To skip a particular test within a module, use the exact testcase number\n"
@@ -333,12 +391,16 @@ HelpMsg (
          "-dtb    Enable the execution of dtb dump\n"
          "-sbsa   Enable sbsa requirements for bsa binary\n"
          "-el1physkip Skips EL1 register checks\n"
+         "-perf   Run performance micro-benchmarks and report timing\n"
+         "-nopark Power secondary HARTs off after every payload instead of parking them\n"
   );
 }
 
 STATIC CONST SHELL_PARAM_ITEM ParamList[] = {
   {L"-v", TypeValue},    // -v    # Verbosity of the Prints. 1 shows all prints, 5 shows Errors
   {L"-f", TypeValue},    // -f    # Name of the log file to record the test results in.
+  {L"-json", TypeValue}, // -json # Name of the file to record JSON test results in.
+  {L"-junit", TypeValue}, // -junit # Name of the file to record JUnit XML test results in.
   {L"-skip", TypeValue}, // -skip # test(s) to skip execution
   {L"-t", TypeValue},    // -t    # Test to be run
   {L"-m", TypeValue},    // -m    # Module to be run
@@ -354,6 +416,8 @@ STATIC CONST SHELL_PARAM_ITEM ParamList[] = {
   {L"-sbsa", TypeFlag},  // -sbsa # Enable sbsa requirements for bsa binary\n"
   {L"-mmio", TypeFlag}, // -mmio # Enable pal_mmio prints
   {L"-el1physkip", TypeFlag}, // -el1physkip # Skips EL1 register checks
+  {L"-perf", TypeFlag},  // -perf # Run performance micro-benchmarks
+  {L"-nopark", TypeFlag}, // -nopark # Power secondary HARTs off after every payload
   {NULL, TypeMax}
   };
 
@@ -377,7 +441,6 @@ ShellAppMain (
   CONST CHAR16       *CmdLineArg;
   CHAR16             *ProbParam;
   UINT32             Status;
-  UINT32             i;
   VOID               *branch_label;
   UINT32             ReadVerbosity;
 
@@ -402,25 +465,11 @@ ShellAppMain (
       HelpMsg();
       return SHELL_INVALID_PARAMETER;
     }
-    else
+    else if (EFI_ERROR(ParseTestList(CmdLineArg, VAL_SELECT_SKIP)))
     {
-      Status = gBS->AllocatePool(EfiBootServicesData,
-                                 StrLen(CmdLineArg),
-                                 (VOID **) &g_skip_test_num);
-      if (EFI_ERROR(Status))
-      {
-        Print(L"Allocate memory for -skip failed\n", 0);
-        return 0;
-      }
-
-      g_skip_test_num[0] = StrDecimalToUintn((CONST CHAR16 *)(CmdLineArg+0));
-      for (i = 0; i < StrLen(CmdLineArg); i++) {
-      if(*(CmdLineArg+i) == L',') {
-          g_skip_test_num[++g_num_skip] = StrDecimalToUintn((CONST CHAR16 *)(CmdLineArg+i+1));
-        }
-      }
-
-      g_num_skip++;
+      Print(L"Invalid parameter passed for -skip\n", 0);
+      HelpMsg();
+      return SHELL_INVALID_PARAMETER;
     }
   }
 
@@ -492,6 +541,30 @@ ShellAppMain (
     }
   }
 
+  CmdLineArg  = ShellCommandLineGetValue (ParamPackage, L"-json");
+  if (CmdLineArg == NULL) {
+    g_bsa_json_file_handle = NULL;
+  } else {
+    Status = ShellOpenFileByName(CmdLineArg, &g_bsa_json_file_handle,
+             EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ | EFI_FILE_MODE_CREATE, 0x0);
+    if(EFI_ERROR(Status)) {
+         Print(L"Failed to open JSON result file %s\n", CmdLineArg);
+         g_bsa_json_file_handle = NULL;
+    }
+  }
+
+  CmdLineArg  = ShellCommandLineGetValue (ParamPackage, L"-junit");
+  if (CmdLineArg == NULL) {
+    g_bsa_junit_file_handle = NULL;
+  } else {
+    Status = ShellOpenFileByName(CmdLineArg, &g_bsa_junit_file_handle,
+             EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ | EFI_FILE_MODE_CREATE, 0x0);
+    if(EFI_ERROR(Status)) {
+         Print(L"Failed to open JUnit result file %s\n", CmdLineArg);
+         g_bsa_junit_file_handle = NULL;
+    }
+  }
+
     // If user has pass dtb flag, then dump the dtb in file
   CmdLineArg  = ShellCommandLineGetValue(ParamPackage, L"-dtb");
   if (CmdLineArg == NULL) {
@@ -522,34 +595,12 @@ ShellAppMain (
           HelpMsg();
           return SHELL_INVALID_PARAMETER;
       }
-      else
+      else if (EFI_ERROR(ParseTestList(CmdLineArg, VAL_SELECT_TEST)))
       {
-          Status = gBS->AllocatePool(EfiBootServicesData,
-                                     StrLen(CmdLineArg),
-                                     (VOID **) &g_execute_tests);
-          if (EFI_ERROR(Status))
-          {
-              Print(L"Allocate memory for -t failed\n", 0);
-              return 0;
-          }
-
-          /* Check if the first value to -t is a decimal character. */
-          if (!ShellIsDecimalDigitCharacter(*CmdLineArg)) {
-              Print(L"Invalid parameter passed for -t\n", 0);
-              HelpMsg();
-              return SHELL_INVALID_PARAMETER;
-          }
-
-          g_execute_tests[0] = StrDecimalToUintn((CONST CHAR16 *)(CmdLineArg + 0));
-          for (i = 0; i < StrLen(CmdLineArg); i++) {
-              if (*(CmdLineArg + i) == L',') {
-                  g_execute_tests[++g_num_tests] = StrDecimalToUintn(
-                                                          (CONST CHAR16 *)(CmdLineArg + i + 1));
-              }
-          }
-
-          g_num_tests++;
-        }
+          Print(L"Invalid parameter passed for -t\n", 0);
+          HelpMsg();
+          return SHELL_INVALID_PARAMETER;
+      }
   }
 
   // Options with Values
@@ -561,33 +612,11 @@ ShellAppMain (
           HelpMsg();
           return SHELL_INVALID_PARAMETER;
       }
-      else
+      else if (EFI_ERROR(ParseTestList(CmdLineArg, VAL_SELECT_MODULE)))
       {
-          Status = gBS->AllocatePool(EfiBootServicesData,
-                                     StrLen(CmdLineArg),
-                                     (VOID **) &g_execute_modules);
-          if (EFI_ERROR(Status))
-          {
-              Print(L"Allocate memory for -m failed\n", 0);
-              return 0;
-          }
-
-          /* Check if the first value to -m is a decimal character. */
-          if (!ShellIsDecimalDigitCharacter(*CmdLineArg)) {
-              Print(L"Invalid parameter passed for -m\n", 0);
-              HelpMsg();
-              return SHELL_INVALID_PARAMETER;
-          }
-
-          g_execute_modules[0] = StrDecimalToUintn((CONST CHAR16 *)(CmdLineArg + 0));
-          for (i = 0; i < StrLen(CmdLineArg); i++) {
-              if (*(CmdLineArg + i) == L',') {
-                  g_execute_modules[++g_num_modules] = StrDecimalToUintn(
-                                                          (CONST CHAR16 *)(CmdLineArg + i + 1));
-              }
-          }
-
-          g_num_modules++;
+          Print(L"Invalid parameter passed for -m\n", 0);
+          HelpMsg();
+          return SHELL_INVALID_PARAMETER;
       }
   }
 
@@ -606,6 +635,14 @@ ShellAppMain (
   if (ShellCommandLineGetFlag (ParamPackage, L"-el1physkip")) {
     g_el1physkip = TRUE;
   }
+
+  if (ShellCommandLineGetFlag (ParamPackage, L"-perf")) {
+    g_perf_mode = TRUE;
+  }
+
+  if (ShellCommandLineGetFlag (ParamPackage, L"-nopark")) {
+    g_hart_park = FALSE;
+  }
   //
   // Initialize global counters
   //
@@ -626,20 +663,28 @@ ShellAppMain (
 
 
   Status = createPeInfoTable();
-  if (Status)
+  if (Status) {
+    val_print_flush();
     return Status;
+  }
 
   Status = createIommuInfoTable();
-  if (Status)
+  if (Status) {
+    val_print_flush();
     return Status;
+  }
 
   Status = createGicInfoTable();
-  if (Status)
+  if (Status) {
+    val_print_flush();
     return Status;
+  }
 
   Status = createMngInfoTable();
-  if (Status)
+  if (Status) {
+    val_print_flush();
     return Status;
+  }
 
   val_print(ACS_PRINT_TEST, "\n Allocate shared mem and flush image\n", 0);
   val_allocate_shared_mem();
@@ -661,6 +706,11 @@ ShellAppMain (
 
   FlushImage();
 
+  if (g_perf_mode) {
+    val_shared_mem_benchmark(VAL_MAILBOX_BENCH_ITERATIONS);
+    val_dispatch_benchmark(VAL_DISPATCH_BENCH_ITERATIONS);
+  }
+
   /***  Starting HART tests             ***/
   // Status = val_hart_execute_tests(val_hart_get_num(), g_sw_view);
 
@@ -707,13 +757,25 @@ print_test_status:
   val_print(ACS_PRINT_TEST, "\n     Tests Failed = %4d\n", g_bsa_tests_fail);
   val_print(ACS_PRINT_TEST, "\n     -------------------------------------------------------", 0);
 
+  val_profile_report(VAL_PROFILE_NUM_SLOWEST);
+  val_result_close();
+
   freeBsaAcsMem();
 
   if (g_dtb_log_file_handle) {
     ShellCloseFile(&g_dtb_log_file_handle);
   }
 
+  if (g_bsa_json_file_handle) {
+    ShellCloseFile(&g_bsa_json_file_handle);
+  }
+
+  if (g_bsa_junit_file_handle) {
+    ShellCloseFile(&g_bsa_junit_file_handle);
+  }
+
   val_print(ACS_PRINT_TEST, "\n      *** BSA tests complete. Reset the system. ***\n\n", 0);
+  val_print_flush();
 
   if (g_bsa_log_file_handle) {
     ShellCloseFile(&g_bsa_log_file_handle);
@@ -35,5 +35,7 @@ extern uint32_t g_num_modules;
 extern uint32_t g_build_sbsa;
 extern uint32_t g_curr_module;
 extern uint32_t g_el1physkip;
+extern uint32_t g_perf_mode;
+extern uint32_t g_hart_park;
 
 #endif
@@ -48,6 +48,8 @@
 #define ACS_QOS_TEST_NUM_BASE        1000
 #define ACS_MNG_TEST_NUM_BASE        1100
 #define ACS_IOMMU_TEST_NUM_BASE      1200
+/* Synthetic tests of the host simulation app, kept clear of the modules */
+#define ACS_HOST_TEST_NUM_BASE       1900
 #define STATE_BIT   28
 #define STATE_MASK 0xF
 
@@ -119,6 +121,9 @@ val_mmio_write(addr_t addr, uint32_t data);
 void
 val_mmio_write64(addr_t addr, uint64_t data);
 
+uint32_t
+val_check_skip_module_id(uint32_t module_base);
+
 uint32_t
 val_check_skip_module(uint32_t module_base);
 
@@ -131,6 +136,10 @@ val_check_for_error(uint32_t test_num, uint32_t num_hart, char8_t *ruleid);
 void
 val_run_test_payload(uint32_t test_num, uint32_t num_hart, void (*payload)(void), uint64_t test_input);
 
+void
+val_run_test_payload_concurrent(uint32_t test_num, uint32_t num_hart, void (*payload)(void),
+                                uint64_t test_input);
+
 void
 val_data_cache_ops_by_va(addr_t addr, uint32_t type);
 
@@ -387,6 +387,8 @@ uint64_t AA64ReadDbgbcr15El1(void);
 
 void ArmCallWFI(void);
 
+void ArmCallPause(void);
+
 void ArmExecuteMemoryBarrier(void);
 
 void SpeProgramUnderProfiling(uint64_t interval, uint64_t address);
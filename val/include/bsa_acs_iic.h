@@ -25,6 +25,9 @@
 #define IMSIC_MMIO_PAGE_LE             0x00
 #define IMSIC_MMIO_PAGE_BE             0x04
 
+/* Highest external interrupt identity an IMSIC interrupt file can implement */
+#define IMSIC_MAX_ID                   2047
+
 uint32_t
 os_i001_entry(uint32_t num_hart);
 uint32_t
@@ -39,6 +42,7 @@ os_i005_entry(uint32_t num_hart);
 void val_iic_imsic_eix_array_update (uint32_t base_id, uint32_t num_id, bool pend, bool val);
 void val_iic_imsic_eix_update (uint32_t id, bool pend, bool val);
 uint64_t val_iic_imsic_eix_read (uint32_t id, bool pend);
+uint32_t val_iic_imsic_eix_array_check (uint32_t num_id, bool pend);
 uint32_t val_iic_imsic_eidelivery_update (uint32_t val);
 uint32_t val_iic_imsic_eithreshold_update (uint32_t val);
 
@@ -36,6 +36,15 @@
 #define PCIE_BUS_SHIFT 8
 #define PCIE_CFG_SIZE  4096
 
+/* Segment numbers addressable through the 8-bit BDF segment field */
+#define PCIE_MAX_SEG   256
+
+/* Config reads timed per path by val_pcie_cfg_access_benchmark */
+#define PCIE_CFG_BENCH_ITERATIONS 100000
+
+/* Passed to val_pcie_cap_cache_invalidate to drop every cached Function */
+#define PCIE_CAP_CACHE_ALL_BDF    0xFFFFFFFF
+
 #define PCIE_INTERRUPT_LINE  0x3c
 #define PCIE_INTERRUPT_PIN   0x3d
 #define PCIE_INTERRUPT_PIN_SHIFT 0x8
@@ -63,6 +72,7 @@
 #define REG_SHIFT(alignment_byte_cnt, start) (((alignment_byte_cnt)*BITS_IN_BYTE) + start)
 
 #define MAX_BITFIELD_ENTRIES 100
+#define BITFIELD_GROUP_MAX   32
 #define ERR_STRING_SIZE 64
 
 #define MEM_OFFSET_SMALL   0x10
@@ -128,6 +138,14 @@ typedef struct {
   char                   err_str2[ERR_STRING_SIZE];
 } pcie_cfgreg_bitfield_entry;
 
+/* Counters of val_pcie_register_bitfields_check */
+typedef struct {
+  uint32_t num_pass;
+  uint32_t num_fails;
+  uint32_t num_access;            ///< Config accesses made
+  uint32_t num_access_unbatched;  ///< Config accesses the per-entry check would make
+} PCIE_BITFIELD_STATS;
+
 typedef enum {
   MMIO = 0,
   IO = 1
@@ -166,6 +184,7 @@ uint32_t val_pcie_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data);
 uint32_t val_pcie_read_cfg_width(uint32_t bdf, uint32_t offset, void *data, PCI_WIDTH_TYPE width);
 uint32_t val_get_msi_vectors (uint32_t bdf, PERIPHERAL_VECTOR_LIST **mvector);
 uint64_t val_pcie_get_bdf_config_addr(uint32_t bdf);
+void     val_pcie_cfg_access_benchmark(uint32_t num_iter);
 
 uint32_t val_pcie_bar_mem_read(uint32_t bdf, uint64_t address, uint32_t *data);
 uint32_t val_pcie_bar_mem_write(uint32_t bdf, uint64_t address, uint32_t data);
@@ -62,7 +62,15 @@
 #define PAGE_SIZE_16K       (4 * 0x1000)
 #define PAGE_SIZE_64K       (16 * 0x1000)
 
+typedef struct {
+    uint32_t pages_used;       /* Table pages added to the translation table */
+    uint64_t entries_written;  /* Table, block and page descriptors written */
+    uint64_t block_entries;    /* Block descriptors among them */
+    uint64_t time_us;
+} pgt_stats_t;
+
 uint32_t val_pgt_create(memory_region_descriptor_t *mem_desc, pgt_descriptor_t *pgt_desc);
+void val_pgt_get_stats(pgt_stats_t *stats);
 void val_pgt_destroy(pgt_descriptor_t pgt_desc);
 uint64_t val_pgt_get_attributes(pgt_descriptor_t pgt_desc, uint64_t virtual_address, uint64_t *attributes);
 
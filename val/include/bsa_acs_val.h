@@ -28,8 +28,39 @@ typedef struct {
   uint64_t    data0;
   uint64_t    data1;
   uint32_t    status;
+  uint32_t    park_state;  ///< VAL_HART_OFF, VAL_HART_BUSY or VAL_HART_PARKED
+  uint32_t    park_cmd;    ///< VAL_PARK_CMD_RUN or VAL_PARK_CMD_EXIT
+  uint64_t    park_seq;    ///< Bumped by the dispatcher to wake a parked HART
 }VAL_SHARED_MEM_t;
 
+/* Secondary HART states kept in its mailbox */
+#define VAL_HART_OFF      0
+#define VAL_HART_BUSY     1
+#define VAL_HART_PARKED   2
+
+/* Commands to a parked HART */
+#define VAL_PARK_CMD_RUN   0
+#define VAL_PARK_CMD_EXIT  1
+
+/* Cache line size assumed when no HART reports a Zicbom block size */
+#define VAL_CACHE_LINE_SIZE_DEFAULT   64
+
+/* Status updates per HART timed by val_shared_mem_benchmark */
+#define VAL_MAILBOX_BENCH_ITERATIONS  10000
+
+/* Empty payload dispatches timed per model by val_dispatch_benchmark */
+#define VAL_DISPATCH_BENCH_ITERATIONS 100
+
+/* Tests timed per run, and slowest tests listed by val_profile_report */
+#define VAL_PROFILE_MAX_TESTS         512
+#define VAL_PROFILE_NUM_SLOWEST       10
+
+/* Modules named by val_get_module_name, by test number / 100 */
+#define VAL_NUM_MODULE                13
+
+volatile VAL_SHARED_MEM_t *
+val_get_shared_mem_entry(uint32_t index);
+
 uint64_t
 val_hart_reg_read(uint32_t reg_id);
 
@@ -57,5 +88,15 @@ val_set_status(uint32_t index, uint32_t status);
 uint32_t
 val_get_status(uint32_t id);
 
+void
+val_result_begin_test(uint32_t test_num, char8_t *desc);
+
+void
+val_result_write_test(uint32_t test_num, char8_t *ruleid, uint32_t num_hart,
+                      uint32_t status, uint64_t elapsed_us);
+
+char8_t *
+val_get_module_name(uint32_t test_num);
+
 #endif
 
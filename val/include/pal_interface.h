@@ -91,6 +91,10 @@
 
 #define MAX_SID          PLATFORM_OVERRIDE_MAX_SID
 #define MAX_IRQ_CNT      PLATFORM_BM_OVERRIDE_MAX_IRQ_CNT
+#ifndef MMU_PGT_IAS
+#define MMU_PGT_IAS      PLATFORM_OVERRIDE_MMU_PGT_IAS
+#define MMU_PGT_OAS      PLATFORM_OVERRIDE_MMU_PGT_OAS
+#endif
 
 #elif ENABLE_OOB
   typedef INT8   int8_t;
@@ -164,6 +168,17 @@
 
 #define ONE_MILLISECOND 1000
 
+/* Wall clock timeouts in microseconds, measured against the time counter */
+#if defined(PLATFORM_OVERRIDE_TIMEOUT_US) && PLATFORM_OVERRIDE_TIMEOUT_US
+    #define TIMEOUT_LARGE_US    PLATFORM_OVERRIDE_TIMEOUT_LARGE_US
+    #define TIMEOUT_MEDIUM_US   PLATFORM_OVERRIDE_TIMEOUT_MEDIUM_US
+    #define TIMEOUT_SMALL_US    PLATFORM_OVERRIDE_TIMEOUT_SMALL_US
+#else
+    #define TIMEOUT_LARGE_US    10000000
+    #define TIMEOUT_MEDIUM_US   1000000
+    #define TIMEOUT_SMALL_US    1000
+#endif
+
 #define PCIE_SUCCESS            0x00000000  /* Operation completed successfully */
 #define PCIE_NO_MAPPING         0x10000001  /* A mapping to a Function does not exist */
 #define PCIE_CAP_NOT_FOUND      0x10000010  /* The specified capability was not found */
@@ -191,23 +206,41 @@ typedef struct {
 }HART_INFO_HDR;
 
 /**
-  @brief  structure instance for HART entry
+  @brief  structure instance for HART entry. Only the fields used to look up
+          and dispatch to HARTs are kept here, the ISA string is kept in the
+          HART_INFO_DETAIL array that follows the entries.
 **/
 typedef struct {
-  uint32_t   hart_num;        ///< HART Index
   uint64_t   hart_id;         ///< Hart ID (mhartid) of the hart
+  uint64_t   imsic_base;      ///< Physical base address of the Incoming MSI Controller (IMSIC) MMIO region of this hart.
+  uint64_t   isa_ext;         ///< Bitmap of HART_ISA_EXT_e, parsed by VAL from the ISA string.
+  uint32_t   hart_num;        ///< HART Index
   uint32_t   acpi_processor_uid;
   uint32_t   ext_intc_id;     ///< The unique ID of the external interrupts connected to this hart.
-  uint64_t   imsic_base;      ///< Physical base address of the Incoming MSI Controller (IMSIC) MMIO region of this hart.
   uint32_t   imsic_size;      ///< Size in bytes of the IMSIC MMIO region of this hart.
-  char8_t    isa_string[512]; ///< Null-terminated ASCII Instruction Set Architecture (ISA) string for this hart.
+  uint32_t   cbom_block_size; ///< Zicbom cache block size in bytes, 0 if not reported.
 }HART_INFO_ENTRY;
 
+/**
+  @brief  Per HART data that is only read when a test asks for it
+**/
+typedef struct {
+  char8_t    isa_string[512]; ///< Null-terminated ASCII Instruction Set Architecture (ISA) string for this hart.
+}HART_INFO_DETAIL;
+
+/**
+  @brief  HART information table. The HART_INFO_DETAIL array starts right
+          after hart_info[num_of_hart - 1], so the PAL sets num_of_hart
+          before it fills any detail.
+**/
 typedef struct {
   HART_INFO_HDR    header;
   HART_INFO_ENTRY  hart_info[];
 }HART_INFO_TABLE;
 
+#define HART_INFO_DETAIL_BASE(table) \
+  ((HART_INFO_DETAIL *)&(table)->hart_info[(table)->header.num_of_hart])
+
 typedef struct {
   uint32_t ps:3;
   uint32_t tg:2;
@@ -220,6 +253,7 @@ typedef struct {
 }PE_TCR_BF;
 
 void pal_hart_create_info_table(HART_INFO_TABLE *hart_info_table);
+uint32_t pal_hart_get_info_entry_count(void);
 
 /**
   @brief  Structure to Pass SMC arguments. Return data is also filled into
@@ -274,6 +308,7 @@ typedef struct {
 } IOMMU_INFO_TABLE;
 
 void pal_iommu_create_info_table(IOMMU_INFO_TABLE *iommu_info_table);
+uint32_t pal_iommu_get_info_entry_count(void);
 
 /* ********** IOMMU INFO END **********/
 
@@ -293,8 +328,8 @@ typedef struct {
   uint32_t num_gich;
 
   /* RV porting */
-  UINT16   supervisor_intr_num;
-  UINT16   guest_intr_num;
+  uint16_t supervisor_intr_num;
+  uint16_t guest_intr_num;
 } GIC_INFO_HDR;
 
 typedef enum {
@@ -352,6 +387,7 @@ typedef struct {
 } GIC_ITS_INFO;
 
 void     pal_gic_create_info_table(GIC_INFO_TABLE *gic_info_table);
+uint32_t pal_gic_get_info_entry_count(void);
 uint32_t pal_gic_install_isr(uint32_t int_id, void (*isr)(void));
 void pal_gic_end_of_interrupt(uint32_t int_id);
 uint32_t pal_gic_request_irq(unsigned int irq_num, unsigned int mapped_irq_num, void *isr);
@@ -407,7 +443,9 @@ typedef struct {
 }TIMER_INFO_TABLE;
 
 void pal_timer_create_info_table(TIMER_INFO_TABLE *timer_info_table);
+uint32_t pal_timer_get_info_entry_count(void);
 uint64_t pal_timer_get_counter_frequency(void);
+uint64_t pal_timer_get_counter(void);
 
 /** Watchdog tests related definitions **/
 
@@ -437,6 +475,7 @@ typedef struct {
 }WD_INFO_TABLE;
 
 void pal_wd_create_info_table(WD_INFO_TABLE  *wd_table);
+uint32_t pal_wd_get_info_entry_count(void);
 
 
 /* PCIe Tests related definitions */
@@ -469,6 +508,7 @@ uint32_t pal_pci_cfg_read(uint32_t bus, uint32_t dev, uint32_t func, int offset,
 
 uint64_t pal_pcie_get_mcfg_ecam(void);
 void     pal_pcie_create_info_table(PCIE_INFO_TABLE *PcieTable);
+uint32_t pal_pcie_get_info_entry_count(void);
 uint32_t pal_pcie_io_read_cfg(uint32_t bdf, uint32_t offset, uint32_t *data);
 uint32_t pal_pcie_get_bdf_wrapper(uint32_t class_code, uint32_t start_bdf);
 void *pal_pci_bdf_to_dev(uint32_t bdf);
@@ -776,12 +816,22 @@ typedef struct {
 } MEMORY_INFO_TABLE;
 
 void  pal_memory_create_info_table(MEMORY_INFO_TABLE *memoryInfoTable);
+uint32_t pal_memory_get_info_entry_count(void);
 uint64_t pal_memory_ioremap(void *addr, uint32_t size, uint32_t attr);
 void pal_memory_unmap(void *addr);
 uint64_t pal_memory_get_unpopulated_addr(uint64_t *addr, uint32_t instance);
 
+/* Structured result streams, one record per test */
+#define ACS_RESULT_JSON        0   /* JSON lines */
+#define ACS_RESULT_JUNIT       1   /* JUnit XML */
+#define ACS_RESULT_NUM_STREAM  2
+
 /* Common Definitions */
 void     pal_print(char8_t *string, uint64_t data);
+void     pal_print_flush(void);
+uint32_t pal_result_stream_enabled(uint32_t stream);
+void     pal_result_write(uint32_t stream, char8_t *data, uint32_t len);
+void     pal_result_flush(void);
 void     pal_uart_print(int log, const char *fmt, ...);
 void     pal_print_raw(uint64_t addr, char8_t *string, uint64_t data);
 uint32_t pal_strncmp(char8_t *str1, char8_t *str2, uint32_t len);
@@ -48,17 +48,31 @@
 
 #define NOT_IMPLEMENTED         0x4B1D  /* Feature or API not implemented */
 
+/* Test selection lists filled from the -skip, -t and -m options. Test and
+   module numbers at or above VAL_TEST_NUM_MAX cannot be selected. */
+#define VAL_SELECT_SKIP      0
+#define VAL_SELECT_TEST      1
+#define VAL_SELECT_MODULE    2
+#define VAL_TEST_NUM_MAX     2048
+
 #define VAL_EXTRACT_BITS(data, start, end) ((data >> start) & ((1ul << (end-start+1))-1))
 
 typedef char char8_t;
 /* GENERIC VAL APIs */
 void val_allocate_shared_mem(void);
 void val_free_shared_mem(void);
+void val_shared_mem_benchmark(uint32_t num_iter);
+void val_dispatch_benchmark(uint32_t num_iter);
+void val_profile_report(uint32_t num_slowest);
+void val_result_close(void);
+uint32_t val_test_select_add(uint32_t list, uint32_t first, uint32_t last);
+void val_test_select_init(void);
 void val_print(uint32_t level, char8_t *string, uint64_t data);
 void val_print_raw(uint64_t uart_addr, uint32_t level, char8_t *string,
                                                                 uint64_t data);
 void val_print_test_start(char8_t *string);
 void val_print_test_end(uint32_t status, char8_t *string);
+void val_print_flush(void);
 void val_set_test_data(uint32_t index, uint64_t addr, uint64_t test_data);
 void val_get_test_data(uint32_t index, uint64_t *data0, uint64_t *data1);
 uint32_t val_strncmp(char8_t *str1, char8_t *str2, uint32_t len);
@@ -68,19 +82,55 @@ void val_dump_dtb(void);
 uint64_t val_time_delay_ms(uint64_t time_ms);
 
 /* VAL HART APIs */
+
+/* ISA extensions tracked in HART_INFO_ENTRY.isa_ext. Single letter
+   extensions use the bit of their letter, see HART_ISA_EXT_LETTER. */
+#define HART_ISA_EXT_LETTER(c)  ((uint32_t)((c) - 'a'))
+
+typedef enum {
+  HART_ISA_EXT_ZICBOM = 26,
+  HART_ISA_EXT_ZICBOP,
+  HART_ISA_EXT_ZICBOZ,
+  HART_ISA_EXT_ZICNTR,
+  HART_ISA_EXT_ZICSR,
+  HART_ISA_EXT_ZIFENCEI,
+  HART_ISA_EXT_ZIHINTPAUSE,
+  HART_ISA_EXT_ZIHPM,
+  HART_ISA_EXT_ZBA,
+  HART_ISA_EXT_ZBB,
+  HART_ISA_EXT_ZBS,
+  HART_ISA_EXT_ZKR,
+  HART_ISA_EXT_SMAIA,
+  HART_ISA_EXT_SSAIA,
+  HART_ISA_EXT_SSCOFPMF,
+  HART_ISA_EXT_SSQOSID,
+  HART_ISA_EXT_SSTC,
+  HART_ISA_EXT_SVADU,
+  HART_ISA_EXT_SVINVAL,
+  HART_ISA_EXT_SVNAPOT,
+  HART_ISA_EXT_SVPBMT,
+  HART_ISA_EXT_MAX
+} HART_ISA_EXT_e;
+
 uint32_t val_hart_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
 uint32_t val_hart_create_info_table(uint64_t *hart_info_table);
+uint32_t val_hart_get_info_table_size(void);
 void     val_hart_free_info_table(void);
 uint32_t val_hart_get_num(void);
 char8_t *val_hart_get_isa_string (uint32_t index);
+uint32_t val_hart_has_isa_ext(uint32_t index, uint32_t ext);
+uint32_t val_hart_all_have_isa_ext(uint32_t ext);
 uint64_t val_hart_get_imsic_base (int32_t index);
 uint64_t val_hart_get_mpid(void);
 uint32_t val_hart_get_index_mpid(uint64_t hart_id);
 uint32_t val_hart_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void *));
 uint32_t val_hart_get_primary_index(void);
+uint32_t val_hart_get_cache_line_size(void);
 uint64_t val_get_primary_mpidr(void);
 
 void     val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t args);
+int32_t  val_execute_on_pe_async(uint32_t index, void (*payload)(void), uint64_t args);
+void     val_hart_park_shutdown(void);
 int      val_suspend_pe(uint64_t entry, uint32_t context_id);
 
 /* IOMMU HART APIs */
@@ -90,12 +140,14 @@ typedef enum {
 }IOMMU_INFO_e;
 uint32_t val_iommu_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
 uint32_t val_iommu_create_info_table(uint64_t *iommu_info_table);
+uint32_t val_iommu_get_info_table_size(void);
 void     val_iommu_free_info_table(void);
 uint32_t val_iommu_get_num(void);
 uint64_t val_iommu_get_info(int32_t index, IOMMU_INFO_e info_type);
 
 /* IIC VAL APIs */
 uint32_t    val_gic_create_info_table(uint64_t *gic_info_table);
+uint32_t    val_gic_get_info_table_size(void);
 
 typedef enum {
   GIC_INFO_VERSION=1,
@@ -174,6 +226,7 @@ typedef enum {
 #define BSA_TIMER_FLAG_ALWAYS_ON 0x4
 
 void     val_timer_create_info_table(uint64_t *timer_info_table);
+uint32_t val_timer_get_info_table_size(void);
 void     val_timer_free_info_table(void);
 uint32_t val_timer_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
 uint64_t val_timer_get_info(TIMER_INFO_e info_type, uint64_t instance);
@@ -184,6 +237,24 @@ void     val_timer_set_vir_el2(uint64_t timeout);
 void     val_timer_set_system_timer(addr_t cnt_base_n, uint32_t timeout);
 void     val_timer_disable_system_timer(addr_t cnt_base_n);
 uint32_t val_timer_skip_if_cntbase_access_not_allowed(uint64_t index);
+uint64_t val_timer_get_counter(void);
+uint64_t val_timer_ticks_to_us(uint64_t ticks);
+uint64_t val_timer_us_to_ticks(uint64_t us);
+
+/* Longest delay between two polls of a timeout with backoff */
+#define VAL_POLL_BACKOFF_MAX_US 100
+
+typedef struct {
+  uint64_t start;        ///< Time counter value when the timeout was started
+  uint64_t ticks;        ///< Timeout length in counter ticks, 0 if counting polls
+  uint64_t polls;        ///< Remaining polls when the counter frequency is unknown
+  uint64_t backoff;      ///< Current delay between polls in counter ticks
+  uint64_t max_backoff;  ///< Upper bound of the delay between polls in counter ticks
+} VAL_TIMEOUT_t;
+
+void     val_timeout_start(VAL_TIMEOUT_t *timeout, uint64_t timeout_us);
+uint32_t val_timeout_expired(VAL_TIMEOUT_t *timeout);
+void     val_timeout_backoff(VAL_TIMEOUT_t *timeout);
 void val_platform_timer_get_entry_index(uint64_t instance, uint32_t *block, uint32_t *index);
 uint64_t val_get_phy_el2_timer_count(void);
 uint64_t val_get_phy_el1_timer_count(void);
@@ -199,6 +270,7 @@ typedef enum {
 }WD_INFO_TYPE_e;
 
 void     val_wd_create_info_table(uint64_t *wd_info_table);
+uint32_t val_wd_get_info_table_size(void);
 void     val_wd_free_info_table(void);
 uint32_t val_wd_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
 uint64_t val_wd_get_info(uint32_t index, WD_INFO_TYPE_e info_type);
@@ -208,6 +280,7 @@ uint64_t val_get_counter_frequency(void);
 /* PCIE VAL APIs */
 void     val_pcie_enumerate(void);
 void     val_pcie_create_info_table(uint64_t *pcie_info_table);
+uint32_t val_pcie_get_info_table_size(void);
 uint32_t val_pcie_create_device_bdf_table(void);
 addr_t val_pcie_get_ecam_base(uint32_t rp_bdf);
 void *val_pcie_bdf_table_ptr(void);
@@ -223,6 +296,7 @@ uint32_t val_pcie_dev_p2p_support(uint32_t bdf);
 uint32_t val_pcie_multifunction_support(uint32_t bdf);
 uint32_t val_pcie_is_onchip_peripheral(uint32_t bdf);
 uint32_t val_pcie_device_port_type(uint32_t bdf);
+void val_pcie_cap_cache_invalidate(uint32_t bdf);
 uint32_t val_pcie_find_capability(uint32_t bdf, uint32_t cid_type,
                                            uint32_t cid, uint32_t *cid_offset);
 void val_pcie_disable_bme(uint32_t bdf);
@@ -406,6 +480,7 @@ uint32_t val_enable_mmu(void);
 #define MEM_SH_INNER(sh) (sh == 0x3)
 
 void     val_memory_create_info_table(uint64_t *memory_info_table);
+uint32_t val_memory_get_info_table_size(void);
 void     val_memory_free_info_table(void);
 uint32_t val_memory_execute_tests(uint32_t num_hart, uint32_t *g_sw_view);
 uint64_t val_memory_get_info(addr_t addr, uint64_t *attr);
@@ -291,15 +291,14 @@ uint32_t val_exerciser_get_data(EXERCISER_DATA_TYPE type, exerciser_data_t *data
 uint32_t
 val_exerciser_execute_tests(uint32_t *g_sw_view)
 {
-  uint32_t status, i;
+  uint32_t status;
   uint32_t num_instances;
   uint32_t instance, num_smmu;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_EXERCISER_TEST_NUM_BASE) {
-          val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Exerciser tests\n", 0);
-          return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_EXERCISER_TEST_NUM_BASE)) {
+    val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Exerciser tests\n", 0);
+    return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
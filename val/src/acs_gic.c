@@ -36,13 +36,12 @@ uint32_t
 val_iic_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 {
 
-  uint32_t status, i;
+  uint32_t status;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_GIC_TEST_NUM_BASE) {
-          val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all IIC tests\n", 0);
-          return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_GIC_TEST_NUM_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all IIC tests\n", 0);
+      return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
@@ -75,6 +74,20 @@ val_iic_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 }
 
 
+/**
+  @brief   This API returns the number of bytes needed for the IIC info table,
+           as counted by the PAL layer, so that the caller can allocate it exactly.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  None.
+  @param   None
+  @return  Size of the IIC info table in bytes
+**/
+uint32_t
+val_gic_get_info_table_size(void)
+{
+  return sizeof(GIC_INFO_TABLE) + (pal_gic_get_info_entry_count() * sizeof(GIC_INFO_ENTRY));
+}
+
 /**
   @brief   This API will call PAL layer to fill in the IIC information
            into the g_gic_info_table pointer.
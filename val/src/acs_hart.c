@@ -42,13 +42,12 @@ extern ARM_SMC_ARGS g_smc_args;
 uint32_t
 val_hart_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 {
-  uint32_t status, i;
+  uint32_t status;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_PE_TEST_NUM_BASE) {
-        val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all HART tests\n", 0);
-        return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_PE_TEST_NUM_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all HART tests\n", 0);
+      return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
@@ -377,16 +376,16 @@ val_is_el2_enabled()
 char8_t *
 val_hart_get_isa_string (uint32_t index)
 {
-  HART_INFO_ENTRY *entry;
+  HART_INFO_DETAIL *detail;
 
-  if (index > g_hart_info_table->header.num_of_hart) {
+  if (index >= g_hart_info_table->header.num_of_hart) {
         val_report_status(index, RESULT_FAIL(0, 0xFF), NULL);
         return NULL;
   }
 
-  entry = g_hart_info_table->hart_info;
+  detail = HART_INFO_DETAIL_BASE(g_hart_info_table);
 
-  return entry[index].isa_string;
+  return detail[index].isa_string;
 }
 
 /**
@@ -413,6 +412,41 @@ val_hart_get_imsic_base (int32_t index)
   return entry[index].imsic_base;
 }
 
+/**
+ * @brief  This API returns the cache line size to be used when laying out data
+           shared between HARTs. This is the largest Zicbom block size
+           reported by any HART, so that a cache block operation issued by
+           one HART never touches data owned by another.
+           1. Caller       -  VAL
+           2. Prerequisite -  val_create_peinfo_table
+ *
+ * @param  None
+ * @return Cache line size in bytes
+ */
+uint32_t
+val_hart_get_cache_line_size (void)
+{
+  uint32_t index;
+  uint32_t line_size = 0;
+  HART_INFO_ENTRY *entry;
+
+  if (g_hart_info_table == NULL)
+      return VAL_CACHE_LINE_SIZE_DEFAULT;
+
+  entry = g_hart_info_table->hart_info;
+
+  for (index = 0; index < g_hart_info_table->header.num_of_hart; index++) {
+      if (entry[index].cbom_block_size > line_size)
+          line_size = entry[index].cbom_block_size;
+  }
+
+  /* Fall back to the default if not reported or not a power of 2 */
+  if ((line_size == 0) || (line_size & (line_size - 1)))
+      return VAL_CACHE_LINE_SIZE_DEFAULT;
+
+  return line_size;
+}
+
 /**
   @brief   This API will call an assembly sequence with interval
            as argument over which an SPE event is exected to be generated.
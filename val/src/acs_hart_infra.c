@@ -39,6 +39,286 @@ ARM_SMC_ARGS g_smc_args;
 /* global variable to store primary HART index */
 uint32_t g_primary_hart_index = 0;
 
+/* Open addressed hash map from Hart ID to HART index */
+#define HART_MAP_EMPTY      0xFFFFFFFF
+#define HART_MAP_HASH_MULT  0x9E3779B97F4A7C15ULL
+
+typedef struct {
+  uint64_t hart_id;
+  uint32_t index;
+} HART_MAP_ENTRY;
+
+static HART_MAP_ENTRY *g_hart_map;
+static uint32_t        g_hart_map_mask;
+
+/* ISA extensions reported by every HART, as a HART_ISA_EXT_e bitmap */
+static uint64_t        g_hart_isa_ext_all;
+
+/* Multi-letter ISA extension names, matched after the version is stripped */
+static const struct {
+  const char8_t *name;
+  uint32_t      ext;
+} g_hart_isa_ext_name[] = {
+  {"zicbom",      HART_ISA_EXT_ZICBOM},
+  {"zicbop",      HART_ISA_EXT_ZICBOP},
+  {"zicboz",      HART_ISA_EXT_ZICBOZ},
+  {"zicntr",      HART_ISA_EXT_ZICNTR},
+  {"zicsr",       HART_ISA_EXT_ZICSR},
+  {"zifencei",    HART_ISA_EXT_ZIFENCEI},
+  {"zihintpause", HART_ISA_EXT_ZIHINTPAUSE},
+  {"zihpm",       HART_ISA_EXT_ZIHPM},
+  {"zba",         HART_ISA_EXT_ZBA},
+  {"zbb",         HART_ISA_EXT_ZBB},
+  {"zbs",         HART_ISA_EXT_ZBS},
+  {"zkr",         HART_ISA_EXT_ZKR},
+  {"smaia",       HART_ISA_EXT_SMAIA},
+  {"ssaia",       HART_ISA_EXT_SSAIA},
+  {"sscofpmf",    HART_ISA_EXT_SSCOFPMF},
+  {"ssqosid",     HART_ISA_EXT_SSQOSID},
+  {"sstc",        HART_ISA_EXT_SSTC},
+  {"svadu",       HART_ISA_EXT_SVADU},
+  {"svinval",     HART_ISA_EXT_SVINVAL},
+  {"svnapot",     HART_ISA_EXT_SVNAPOT},
+  {"svpbmt",      HART_ISA_EXT_SVPBMT},
+};
+
+/**
+  @brief   Returns the hash map slot at which the probe for a Hart ID starts
+
+  @param   hart_id - Hart ID to hash
+  @return  Slot index
+**/
+static uint32_t
+val_hart_map_slot(uint64_t hart_id)
+{
+  return (uint32_t)((hart_id * HART_MAP_HASH_MULT) >> 32) & g_hart_map_mask;
+}
+
+/**
+  @brief   Builds the Hart ID to HART index hash map from g_hart_info_table.
+           The map is sized to at most half full, and is written back to
+           memory so that secondary HARTs observe it. It is never modified
+           once built, so lookups need no cache maintenance.
+           1. Caller       -  val_hart_create_info_table
+           2. Prerequisite -  g_hart_info_table populated
+  @param   None
+  @return  None. On allocation failure lookups fall back to a table walk.
+**/
+static void
+val_hart_create_index_map(void)
+{
+  uint32_t i;
+  uint32_t slot;
+  uint32_t num_slots = 1;
+  uint32_t num_hart = g_hart_info_table->header.num_of_hart;
+  uint32_t line_size;
+  addr_t   addr;
+  HART_INFO_ENTRY *entry = g_hart_info_table->hart_info;
+
+  while (num_slots < (2 * num_hart))
+      num_slots <<= 1;
+
+  g_hart_map = pal_mem_alloc(num_slots * sizeof(HART_MAP_ENTRY));
+  if (g_hart_map == NULL) {
+      val_print(ACS_PRINT_WARN, " HART index map not allocated\n", 0);
+      g_hart_map_mask = 0;
+      return;
+  }
+  g_hart_map_mask = num_slots - 1;
+
+  for (i = 0; i < num_slots; i++)
+      g_hart_map[i].index = HART_MAP_EMPTY;
+
+  for (i = 0; i < num_hart; i++) {
+      slot = val_hart_map_slot(entry[i].hart_id);
+      while (g_hart_map[slot].index != HART_MAP_EMPTY)
+          slot = (slot + 1) & g_hart_map_mask;
+
+      g_hart_map[slot].hart_id = entry[i].hart_id;
+      g_hart_map[slot].index   = entry[i].hart_num;
+  }
+
+  line_size = val_hart_get_cache_line_size();
+  for (addr = (addr_t)g_hart_map; addr < (addr_t)&g_hart_map[num_slots]; addr += line_size)
+      val_data_cache_ops_by_va(addr, CLEAN_AND_INVALIDATE);
+
+  val_data_cache_ops_by_va((addr_t)&g_hart_map, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&g_hart_map_mask, CLEAN_AND_INVALIDATE);
+}
+
+static char8_t
+val_hart_isa_lower(char8_t c)
+{
+  return ((c >= 'A') && (c <= 'Z')) ? (c - 'A' + 'a') : c;
+}
+
+static uint32_t
+val_hart_isa_is_digit(char8_t c)
+{
+  return (c >= '0') && (c <= '9');
+}
+
+/**
+  @brief   Case insensitive match of an ISA extension name against the first
+           len characters of an ISA string token
+
+  @param   name  - lower case extension name
+  @param   token - ISA string token, not terminated
+  @param   len   - token length without the version
+  @return  1 if they match, else 0
+**/
+static uint32_t
+val_hart_isa_name_match(const char8_t *name, char8_t *token, uint32_t len)
+{
+  uint32_t i;
+
+  for (i = 0; i < len; i++) {
+      if ((name[i] == '\0') || (name[i] != val_hart_isa_lower(token[i])))
+          return 0;
+  }
+
+  return name[len] == '\0';
+}
+
+/**
+  @brief   Returns the length of an ISA extension name without its version
+           suffix, for example 6 for "zicbom1p0".
+
+  @param   name - extension name
+  @param   len  - length of the name including the version
+  @return  Length of the name alone
+**/
+static uint32_t
+val_hart_isa_strip_version(char8_t *name, uint32_t len)
+{
+  uint32_t end = len;
+
+  while ((end > 0) && val_hart_isa_is_digit(name[end - 1]))
+      end--;
+
+  /* A minor version follows a 'p' that itself follows the major version */
+  if ((end < len) && (end > 1) && (val_hart_isa_lower(name[end - 1]) == 'p') &&
+      val_hart_isa_is_digit(name[end - 2])) {
+      end--;
+      while ((end > 0) && val_hart_isa_is_digit(name[end - 1]))
+          end--;
+  }
+
+  return end;
+}
+
+/**
+  @brief   Parses a RISC-V ISA string, for example
+           "rv64imafdch_zicsr_zifencei_ssaia", into a bitmap of HART_ISA_EXT_e.
+           Extensions the bitmap does not track are ignored.
+
+  @param   isa - Null-terminated ISA string
+  @return  Extension bitmap
+**/
+static uint64_t
+val_hart_parse_isa_string(char8_t *isa)
+{
+  uint64_t ext = 0;
+  uint32_t len;
+  uint32_t i, j;
+  char8_t  c;
+
+  if ((val_hart_isa_lower(isa[0]) != 'r') || (val_hart_isa_lower(isa[1]) != 'v'))
+      return 0;
+
+  isa += 2;
+  while (val_hart_isa_is_digit(*isa))
+      isa++;
+
+  /* Single letter extensions, up to the first multi-letter one */
+  while ((*isa != '\0') && (*isa != '_')) {
+      c = val_hart_isa_lower(*isa);
+      if ((c == 's') || (c == 'x') || (c == 'z'))
+          break;
+
+      if (c == 'g') {
+          ext |= (1ULL << HART_ISA_EXT_LETTER('i')) | (1ULL << HART_ISA_EXT_LETTER('m')) |
+                 (1ULL << HART_ISA_EXT_LETTER('a')) | (1ULL << HART_ISA_EXT_LETTER('f')) |
+                 (1ULL << HART_ISA_EXT_LETTER('d')) | (1ULL << HART_ISA_EXT_ZICSR) |
+                 (1ULL << HART_ISA_EXT_ZIFENCEI);
+      } else if ((c >= 'a') && (c <= 'z')) {
+          ext |= 1ULL << HART_ISA_EXT_LETTER(c);
+      }
+      isa++;
+
+      /* Skip the version, e.g. the "2p1" of "i2p1" */
+      while (val_hart_isa_is_digit(*isa) ||
+             ((val_hart_isa_lower(*isa) == 'p') && val_hart_isa_is_digit(isa[1])))
+          isa++;
+  }
+
+  /* Multi-letter extensions, separated by underscores */
+  while (*isa != '\0') {
+      if (*isa == '_') {
+          isa++;
+          continue;
+      }
+
+      for (len = 0; (isa[len] != '\0') && (isa[len] != '_'); len++)
+          ;
+
+      j = val_hart_isa_strip_version(isa, len);
+      for (i = 0; i < sizeof(g_hart_isa_ext_name) / sizeof(g_hart_isa_ext_name[0]); i++) {
+          if (val_hart_isa_name_match(g_hart_isa_ext_name[i].name, isa, j)) {
+              ext |= 1ULL << g_hart_isa_ext_name[i].ext;
+              break;
+          }
+      }
+
+      isa += len;
+  }
+
+  return ext;
+}
+
+/**
+  @brief   Parses the ISA string of every HART into its isa_ext bitmap, and
+           the extensions common to all HARTs into g_hart_isa_ext_all.
+
+  @param   None
+  @return  None
+**/
+static void
+val_hart_create_isa_ext(void)
+{
+  uint32_t         i;
+  uint32_t         num_hart = g_hart_info_table->header.num_of_hart;
+  HART_INFO_ENTRY  *entry = g_hart_info_table->hart_info;
+  HART_INFO_DETAIL *detail = HART_INFO_DETAIL_BASE(g_hart_info_table);
+
+  g_hart_isa_ext_all = (num_hart != 0) ? ~0ULL : 0;
+
+  for (i = 0; i < num_hart; i++) {
+      entry[i].isa_ext = val_hart_parse_isa_string(detail[i].isa_string);
+      g_hart_isa_ext_all &= entry[i].isa_ext;
+      val_data_cache_ops_by_va((addr_t)&entry[i].isa_ext, CLEAN_AND_INVALIDATE);
+  }
+
+  val_data_cache_ops_by_va((addr_t)&g_hart_isa_ext_all, CLEAN_AND_INVALIDATE);
+  val_print(ACS_PRINT_INFO, " HART_INFO: ISA extensions on all HARTs : 0x%lx\n",
+            g_hart_isa_ext_all);
+}
+
+/**
+  @brief   This API returns the number of bytes needed for the HART info table,
+           as counted by the PAL layer, so that the caller can allocate it exactly.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  None.
+  @param   None
+  @return  Size of the HART info table in bytes
+**/
+uint32_t
+val_hart_get_info_table_size(void)
+{
+  return sizeof(HART_INFO_TABLE) +
+         (pal_hart_get_info_entry_count() * (sizeof(HART_INFO_ENTRY) + sizeof(HART_INFO_DETAIL)));
+}
+
 /**
   @brief   This API will call PAL layer to fill in the HART information
            into the g_hart_info_table pointer.
@@ -85,6 +365,9 @@ val_hart_create_info_table(uint64_t *hart_info_table)
       return ACS_STATUS_ERR;
   }
 
+  val_hart_create_index_map();
+  val_hart_create_isa_ext();
+
   /* store primary HART index for debug message printing purposes on
      multi HART tests */
   g_primary_hart_index = val_hart_get_index_mpid(val_hart_get_mpid());
@@ -104,6 +387,11 @@ val_hart_create_info_table(uint64_t *hart_info_table)
 void
 val_hart_free_info_table()
 {
+  if (g_hart_map != NULL) {
+      pal_mem_free((void *)g_hart_map);
+      g_hart_map = NULL;
+  }
+
   pal_mem_free((void *)g_hart_info_table);
 }
 
@@ -124,6 +412,40 @@ val_hart_get_num()
 }
 
 
+/**
+  @brief   This API checks if a HART implements an ISA extension.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_hart_create_info_table.
+  @param   index - HART index
+  @param   ext   - HART_ISA_EXT_e, or HART_ISA_EXT_LETTER() of a single letter extension
+  @return  1 if the extension is implemented, else 0
+**/
+uint32_t
+val_hart_has_isa_ext(uint32_t index, uint32_t ext)
+{
+  if ((g_hart_info_table == NULL) || (index >= g_hart_info_table->header.num_of_hart) ||
+      (ext >= HART_ISA_EXT_MAX))
+      return 0;
+
+  return (g_hart_info_table->hart_info[index].isa_ext >> ext) & 0x1;
+}
+
+/**
+  @brief   This API checks if every HART implements an ISA extension.
+           1. Caller       -  Test Suite
+           2. Prerequisite -  val_hart_create_info_table.
+  @param   ext   - HART_ISA_EXT_e, or HART_ISA_EXT_LETTER() of a single letter extension
+  @return  1 if all HARTs implement the extension, else 0
+**/
+uint32_t
+val_hart_all_have_isa_ext(uint32_t ext)
+{
+  if (ext >= HART_ISA_EXT_MAX)
+      return 0;
+
+  return (g_hart_isa_ext_all >> ext) & 0x1;
+}
+
 /**
   @brief   This API reads MPIDR system regiser and return the Affinity bits
            1. Caller       -  Test Suite, VAL
@@ -184,6 +506,18 @@ val_hart_get_index_mpid(uint64_t hart_id)
 
   HART_INFO_ENTRY *entry;
   uint32_t i = g_hart_info_table->header.num_of_hart;
+  uint32_t slot;
+
+  if (g_hart_map != NULL) {
+      slot = val_hart_map_slot(hart_id);
+      while (g_hart_map[slot].index != HART_MAP_EMPTY) {
+          if (g_hart_map[slot].hart_id == hart_id)
+              return g_hart_map[slot].index;
+          slot = (slot + 1) & g_hart_map_mask;
+      }
+
+      return 0x0;  //Return index 0 as a safe failsafe value
+  }
 
   entry = g_hart_info_table->hart_info;
 
@@ -202,9 +536,114 @@ val_hart_get_index_mpid(uint64_t hart_id)
 }
 
 
+/**
+  @brief   Parks the calling secondary HART until the dispatcher hands it a
+           new payload or asks it to shut down. The HART marks itself parked
+           in its mailbox and polls the mailbox sequence number.
+           1. Caller       -  val_test_entry
+           2. Prerequisite -  val_allocate_shared_mem
+  @param   mem - Mailbox of the calling HART
+  @return  VAL_PARK_CMD_RUN or VAL_PARK_CMD_EXIT
+**/
+static uint32_t
+val_hart_park(volatile VAL_SHARED_MEM_t *mem)
+{
+  uint64_t seq;
+
+  /* The dispatcher only bumps the sequence of a parked HART, so it is stable here */
+  val_data_cache_ops_by_va((addr_t)&mem->park_seq, INVALIDATE);
+  seq = mem->park_seq;
+
+  mem->park_state = VAL_HART_PARKED;
+  val_data_cache_ops_by_va((addr_t)&mem->park_state, CLEAN_AND_INVALIDATE);
+
+  do {
+      ArmCallPause();
+      val_data_cache_ops_by_va((addr_t)&mem->park_seq, INVALIDATE);
+  } while (mem->park_seq == seq);
+
+  ArmExecuteMemoryBarrier();
+  val_data_cache_ops_by_va((addr_t)&mem->park_cmd, INVALIDATE);
+  return mem->park_cmd;
+}
+
+/**
+  @brief   Hands a payload to a parked secondary HART through its mailbox.
+           1. Caller       -  val_execute_on_pe, val_execute_on_pe_async
+           2. Prerequisite -  val_allocate_shared_mem
+  @param   index - Index of the HART
+  @param   cmd   - VAL_PARK_CMD_RUN or VAL_PARK_CMD_EXIT
+  @param   payload - Function pointer of the test to be executed on the HART
+  @param   test_input - arguments to be passed to the test.
+  @return  1 if the HART was parked and took the command, 0 otherwise
+**/
+static uint32_t
+val_hart_unpark(uint32_t index, uint32_t cmd, void (*payload)(void), uint64_t test_input)
+{
+  volatile VAL_SHARED_MEM_t *mem = val_get_shared_mem_entry(index);
+
+  val_data_cache_ops_by_va((addr_t)&mem->park_state, INVALIDATE);
+  if (mem->park_state != VAL_HART_PARKED)
+      return 0;
+
+  mem->data0 = (uint64_t)payload;
+  mem->data1 = test_input;
+  mem->park_cmd = cmd;
+  mem->park_state = VAL_HART_BUSY;
+  val_data_cache_ops_by_va((addr_t)&mem->data0, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&mem->park_cmd, CLEAN_AND_INVALIDATE);
+
+  /* Payload and command must be visible before the HART sees the new sequence */
+  ArmExecuteMemoryBarrier();
+  mem->park_seq++;
+  val_data_cache_ops_by_va((addr_t)&mem->park_seq, CLEAN_AND_INVALIDATE);
+
+  return 1;
+}
+
+/**
+  @brief   Releases all parked secondary HARTs so that they power themselves
+           off, and waits for them to do so.
+           1. Caller       -  val_free_shared_mem, val_dispatch_benchmark
+           2. Prerequisite -  val_allocate_shared_mem
+  @param   None
+  @return  None
+**/
+void
+val_hart_park_shutdown(void)
+{
+  uint32_t i;
+  uint32_t remaining;
+  uint32_t num_hart = val_hart_get_num();
+  VAL_TIMEOUT_t timeout;
+  volatile VAL_SHARED_MEM_t *mem;
+
+  for (i = 0; i < num_hart; i++)
+      val_hart_unpark(i, VAL_PARK_CMD_EXIT, NULL, 0);
+
+  val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+  do {
+      remaining = 0;
+      for (i = 0; i < num_hart; i++) {
+          mem = val_get_shared_mem_entry(i);
+          val_data_cache_ops_by_va((addr_t)&mem->park_state, INVALIDATE);
+          if ((mem->park_state == VAL_HART_BUSY) && (mem->park_cmd == VAL_PARK_CMD_EXIT))
+              remaining++;
+      }
+
+      if (!remaining)
+          return;
+      val_timeout_backoff(&timeout);
+  } while (!val_timeout_expired(&timeout));
+
+  val_print(ACS_PRINT_WARN, "\n       %d parked HARTs did not shut down", remaining);
+}
+
 /**
   @brief   'C' Entry point for Secondary HART.
-           Uses PSCI_CPU_OFF to switch off HART after payload execution.
+           Runs the payload and then parks the HART for the next payload.
+           Uses PSCI_CPU_OFF to switch off HART when parking is disabled or
+           when the parked HART is asked to shut down.
            1. Caller       -  PAL code
            2. Prerequisite -  Stack pointer for this HART is setup by PAL
   @param   None
@@ -213,12 +652,28 @@ val_hart_get_index_mpid(uint64_t hart_id)
 void
 val_test_entry(void)
 {
+  uint32_t index;
   uint64_t test_arg;
   ARM_SMC_ARGS smc_args;
   void (*vector)(uint64_t args);
+  volatile VAL_SHARED_MEM_t *mem;
+
+  index = val_hart_get_index_mpid(val_hart_get_mpid());
+  mem = val_get_shared_mem_entry(index);
+
+  mem->park_cmd = VAL_PARK_CMD_RUN;
+  mem->park_state = VAL_HART_BUSY;
+  val_data_cache_ops_by_va((addr_t)&mem->park_state, CLEAN_AND_INVALIDATE);
+
+  do {
+      val_get_test_data(index, (uint64_t *)&vector, &test_arg);
+      vector(test_arg);
+
+      val_data_cache_ops_by_va((addr_t)&g_hart_park, INVALIDATE);
+  } while (g_hart_park && (val_hart_park(mem) == VAL_PARK_CMD_RUN));
 
-  val_get_test_data(val_hart_get_index_mpid(val_hart_get_mpid()), (uint64_t *)&vector, &test_arg);
-  vector(test_arg);
+  mem->park_state = VAL_HART_OFF;
+  val_data_cache_ops_by_va((addr_t)&mem->park_state, CLEAN_AND_INVALIDATE);
 
   // We have completed our TEST code. So, switch off the HART now
   smc_args.Arg0 = ARM_SMC_ID_PSCI_CPU_OFF;
@@ -241,14 +696,22 @@ void
 val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t test_input)
 {
 
-  int timeout = TIMEOUT_LARGE;
+  VAL_TIMEOUT_t timeout;
+
   if (index > g_hart_info_table->header.num_of_hart) {
       val_print(ACS_PRINT_ERR, "Input Index exceeds Num of HART %x\n", index);
       val_report_status(index, RESULT_FAIL(0, 0xFF), NULL);
       return;
   }
 
+  val_timeout_start(&timeout, TIMEOUT_LARGE_US);
   do {
+      /* A parked HART takes the payload from its mailbox without a CPU_ON */
+      if (val_hart_unpark(index, VAL_PARK_CMD_RUN, payload, test_input)) {
+          val_print(ACS_PRINT_INFO, "\n       Payload handed to parked HART %d", index);
+          return;
+      }
+
       g_smc_args.Arg0 = ARM_SMC_ID_PSCI_CPU_ON_AARCH64;
 
       /* Set the TEST function pointer in a shared memory location. This location is
@@ -258,10 +721,15 @@ val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t test_input)
       val_set_test_data(index, (uint64_t)payload, test_input);
       pal_hart_execute_payload(&g_smc_args);
 
-  } while (g_smc_args.Arg0 == (uint64_t)ARM_SMC_PSCI_RET_ALREADY_ON && timeout--);
+      if (g_smc_args.Arg0 != (uint64_t)ARM_SMC_PSCI_RET_ALREADY_ON)
+          break;
+      val_timeout_backoff(&timeout);
+  } while (!val_timeout_expired(&timeout));
 
-  if (g_smc_args.Arg0 == (uint64_t)ARM_SMC_PSCI_RET_ALREADY_ON)
+  if (g_smc_args.Arg0 == (uint64_t)ARM_SMC_PSCI_RET_ALREADY_ON) {
       val_print(ACS_PRINT_ERR, "\n       PSCI_CPU_ON: cpu already on", 0);
+      val_print_flush();
+  }
   else {
       if(g_smc_args.Arg0 == 0) {
           val_print(ACS_PRINT_INFO, "\n       PSCI_CPU_ON: success", 0);
@@ -274,6 +742,39 @@ val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t test_input)
   val_set_status(index, RESULT_FAIL(0, 0x120 - (int)g_smc_args.Arg0));
 }
 
+/**
+  @brief   This API hands a test to a parked secondary HART, or else issues a
+           single PSCI_CPU_ON request to start it on the HART, without retrying. Used for broadcast dispatch where
+           the caller retries HARTs that are still on in round-robin order.
+           1. Caller       -  val_run_test_payload
+           2. Prerequisite -  val_create_peinfo_table
+  @param   index - Index of the HART to be woken up
+  @param   payload - Function pointer of the test to be executed on the HART
+  @param   test_input - arguments to be passed to the test.
+  @return  PSCI_CPU_ON return code, 0 if the HART was started
+**/
+int32_t
+val_execute_on_pe_async(uint32_t index, void (*payload)(void), uint64_t test_input)
+{
+  ARM_SMC_ARGS smc_args;
+
+  if (index >= g_hart_info_table->header.num_of_hart) {
+      val_print(ACS_PRINT_ERR, "Input Index exceeds Num of HART %x\n", index);
+      return ARM_SMC_PSCI_RET_INVALID_PARAMS;
+  }
+
+  if (val_hart_unpark(index, VAL_PARK_CMD_RUN, payload, test_input))
+      return ARM_SMC_PSCI_RET_SUCCESS;
+
+  smc_args.Arg0 = ARM_SMC_ID_PSCI_CPU_ON_AARCH64;
+  smc_args.Arg1 = val_hart_get_mpid_index(index);
+
+  val_set_test_data(index, (uint64_t)payload, test_input);
+  pal_hart_execute_payload(&smc_args);
+
+  return (int32_t)smc_args.Arg0;
+}
+
 /**
   @brief   This API installs the Exception handler pointed
            by the function pointer to the input exception type.
@@ -374,6 +875,7 @@ val_hart_default_esr(uint64_t interrupt_type, void *context)
     val_set_status(index, RESULT_FAIL(0, 1));
     val_hart_update_elr(context, g_exception_ret_addr);
     val_print(ACS_PRINT_TEST, "\n        exception return\n", 0);
+    val_print_flush();
 }
 
 /**
@@ -16,13 +16,12 @@ IOMMU_INFO_TABLE  *g_iommu_info_table;
 uint32_t
 val_iommu_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 {
-  uint32_t status, i;
+  uint32_t status;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_IOMMU_TEST_NUM_BASE) {
-          val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all IOMMU tests\n", 0);
-          return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_IOMMU_TEST_NUM_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all IOMMU tests\n", 0);
+      return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
@@ -45,6 +44,20 @@ val_iommu_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
   return status;
 }
 
+/**
+  @brief   This API returns the number of bytes needed for the IOMMU info table,
+           as counted by the PAL layer, so that the caller can allocate it exactly.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  None.
+  @param   None
+  @return  Size of the IOMMU info table in bytes
+**/
+uint32_t
+val_iommu_get_info_table_size(void)
+{
+  return sizeof(IOMMU_INFO_TABLE) + (pal_iommu_get_info_entry_count() * sizeof(IOMMU_INFO_ENTRY));
+}
+
 /**
   @brief   This API will call PAL layer to fill in the IOMMU information
            into the g_iommu_info_table pointer.
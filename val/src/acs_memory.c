@@ -26,6 +26,16 @@ MEMORY_INFO_TABLE  *g_memory_info_table;
 
 #define SIZE_4KB   0x00001000
 
+#define MEM_INFO_INDEX_INVALID  0xFFFFFFFF
+#define MEM_INFO_NUM_TYPE       (MEMORY_TYPE_LAST_ENTRY - MEMORY_TYPE_DEVICE)
+
+/* Entries of the sorted table, excluding the MEMORY_TYPE_LAST_ENTRY marker */
+static uint32_t g_memory_info_count;
+
+/* Table indices grouped by type, g_memory_type_start[t] is the first index of type t */
+static uint32_t *g_memory_type_index;
+static uint32_t g_memory_type_start[MEM_INFO_NUM_TYPE + 1];
+
 #ifdef TARGET_BM_BOOT
 /**
  *   @brief    Add regions assigned to host into its translation table data structure.
@@ -70,13 +80,12 @@ uint32_t
 val_memory_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 {
 
-  uint32_t status, i;
+  uint32_t status;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_MEMORY_MAP_TEST_BASE) {
-        val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Memory tests\n", 0);
-        return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_MEMORY_MAP_TEST_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Memory tests\n", 0);
+      return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
@@ -123,9 +132,145 @@ val_memory_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 void
 val_memory_free_info_table()
 {
+  if (g_memory_type_index != NULL)
+      pal_mem_free(g_memory_type_index);
+  g_memory_type_index = NULL;
+
   pal_mem_free((void *)g_memory_info_table);
 }
 
+/**
+  @brief   This API returns the number of bytes needed for the memory info table,
+           as counted by the PAL layer, so that the caller can allocate it exactly.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  None.
+  @param   None
+  @return  Size of the memory info table in bytes
+**/
+uint32_t
+val_memory_get_info_table_size(void)
+{
+  return sizeof(MEMORY_INFO_TABLE) + (pal_memory_get_info_entry_count() * sizeof(MEM_INFO_BLOCK));
+}
+
+/**
+  @brief   Moves an entry down a max-heap of memory info blocks ordered by
+           physical address, until both children are below it.
+  @param   info   - memory info blocks
+  @param   root   - index of the entry to move down
+  @param   count  - number of entries in the heap
+  @return  None
+**/
+static void
+val_memory_sift_down(MEM_INFO_BLOCK *info, uint32_t root, uint32_t count)
+{
+  MEM_INFO_BLOCK tmp;
+  uint32_t       child;
+
+  while ((child = (2 * root) + 1) < count) {
+      if ((child + 1 < count) && (info[child + 1].phy_addr > info[child].phy_addr))
+          child++;
+      if (info[root].phy_addr >= info[child].phy_addr)
+          return;
+
+      tmp = info[root];
+      info[root] = info[child];
+      info[child] = tmp;
+      root = child;
+  }
+}
+
+/**
+  @brief   Sorts the memory info table by physical address, then merges
+           entries that are contiguous in physical address space, and in
+           virtual address space when it is reported, and have the same type
+           and flags. Address lookups can then
+           use a binary search.
+  @param   None
+  @return  None
+**/
+static void
+val_memory_sort_info_table(void)
+{
+  MEM_INFO_BLOCK *info = g_memory_info_table->info;
+  MEM_INFO_BLOCK tmp;
+  uint32_t       count = 0;
+  uint32_t       i, last;
+
+  while (info[count].type != MEMORY_TYPE_LAST_ENTRY)
+      count++;
+
+  /* Heap sort, in place and O(n log n) for any map the firmware reports */
+  for (i = count / 2; i > 0; i--)
+      val_memory_sift_down(info, i - 1, count);
+  for (i = count; i > 1; i--) {
+      tmp = info[0];
+      info[0] = info[i - 1];
+      info[i - 1] = tmp;
+      val_memory_sift_down(info, 0, i - 1);
+  }
+
+  last = 0;
+  for (i = 1; i < count; i++) {
+      if ((info[i].type == info[last].type) &&
+          (info[i].flags == info[last].flags) &&
+          (info[i].phy_addr == info[last].phy_addr + info[last].size) &&
+          (((info[i].virt_addr == 0) && (info[last].virt_addr == 0)) ||
+           (info[i].virt_addr == info[last].virt_addr + info[last].size))) {
+          info[last].size += info[i].size;
+          continue;
+      }
+      info[++last] = info[i];
+  }
+
+  g_memory_info_count = (count == 0) ? 0 : last + 1;
+  info[g_memory_info_count].type = MEMORY_TYPE_LAST_ENTRY;
+
+  val_print(ACS_PRINT_INFO, " Memory map entries : %d", count);
+  val_print(ACS_PRINT_INFO, " merged to %d\n", g_memory_info_count);
+}
+
+/**
+  @brief   Groups the table indices by memory type, so that the Nth entry of
+           a type is found without a scan. The lookups scan the table if the
+           index cannot be allocated.
+  @param   None
+  @return  None
+**/
+static void
+val_memory_create_type_index(void)
+{
+  uint32_t fill[MEM_INFO_NUM_TYPE];
+  uint32_t i, type;
+
+  val_memory_set(g_memory_type_start, sizeof(g_memory_type_start), 0);
+  if (g_memory_info_count == 0)
+      return;
+
+  g_memory_type_index = pal_mem_alloc(g_memory_info_count * sizeof(uint32_t));
+  if (g_memory_type_index == NULL)
+      return;
+
+  for (i = 0; i < g_memory_info_count; i++) {
+      type = g_memory_info_table->info[i].type;
+      if ((type < MEMORY_TYPE_DEVICE) || (type >= MEMORY_TYPE_LAST_ENTRY)) {
+          pal_mem_free(g_memory_type_index);
+          g_memory_type_index = NULL;
+          return;
+      }
+      g_memory_type_start[type - MEMORY_TYPE_DEVICE + 1]++;
+  }
+  for (type = 0; type < MEM_INFO_NUM_TYPE; type++) {
+      g_memory_type_start[type + 1] += g_memory_type_start[type];
+      fill[type] = g_memory_type_start[type];
+  }
+
+  for (i = 0; i < g_memory_info_count; i++) {
+      type = g_memory_info_table->info[i].type - MEMORY_TYPE_DEVICE;
+      g_memory_type_index[fill[type]++] = i;
+  }
+}
+
 /**
   @brief   This function will call PAL layer to fill all relevant peripheral
            information into the g_peripheral_info_table pointer.
@@ -145,6 +290,8 @@ val_memory_create_info_table(uint64_t *memory_info_table)
 
   pal_memory_create_info_table(g_memory_info_table);
 
+  val_memory_sort_info_table();
+  val_memory_create_type_index();
 }
 #endif
 
@@ -156,13 +303,20 @@ val_memory_create_info_table(uint64_t *memory_info_table)
            2. Prerequisite -
   @param   type     - type of memory being requested
   @param   instance - instance is '0' based and incremented to get different ranges
-  @return  index
+  @return  index, MEM_INFO_INDEX_INVALID if there is no such entry
 **/
 static uint32_t
 val_memory_get_entry_index(uint32_t type, uint32_t instance)
 {
   uint32_t  i = 0;
 
+  if (g_memory_type_index != NULL) {
+      type -= MEMORY_TYPE_DEVICE;
+      if (instance >= g_memory_type_start[type + 1] - g_memory_type_start[type])
+          return MEM_INFO_INDEX_INVALID;
+      return g_memory_type_index[g_memory_type_start[type] + instance];
+  }
+
   while (g_memory_info_table->info[i].type != MEMORY_TYPE_LAST_ENTRY) {
       if (g_memory_info_table->info[i].type == type) {
           if (instance == 0)
@@ -173,7 +327,7 @@ val_memory_get_entry_index(uint32_t type, uint32_t instance)
       }
       i++;
   }
-  return 0xFF;
+  return MEM_INFO_INDEX_INVALID;
 }
 
 /**
@@ -203,10 +357,10 @@ val_memory_get_addr(MEMORY_INFO_e mem_type, uint32_t instance, uint64_t *attr)
           i = val_memory_get_entry_index(MEMORY_TYPE_NORMAL, instance);
           break;
       default:
-          i = 0xFF;
+          i = MEM_INFO_INDEX_INVALID;
           break;
   }
-  if (i != 0xFF) {
+  if (i != MEM_INFO_INDEX_INVALID) {
       *attr = g_memory_info_table->info[i].flags;
       return g_memory_info_table->info[i].phy_addr;
   }
@@ -229,17 +383,23 @@ uint64_t
 val_memory_get_info(addr_t addr, uint64_t *attr)
 {
 
-  uint32_t index = 0;
+  MEM_INFO_BLOCK *info = g_memory_info_table->info;
+  uint32_t low = 0;
+  uint32_t high = g_memory_info_count;
+  uint32_t mid;
+
+  /* Find the last entry that starts at or below addr */
+  while (low < high) {
+      mid = low + ((high - low) >> 1);
+      if (info[mid].phy_addr <= addr)
+          low = mid + 1;
+      else
+          high = mid;
+  }
 
-  while (g_memory_info_table->info[index].type != MEMORY_TYPE_LAST_ENTRY) {
-      if ((addr >= g_memory_info_table->info[index].phy_addr) &&
-        (addr < (g_memory_info_table->info[index].phy_addr +
-        g_memory_info_table->info[index].size))) {
-          *attr =  g_memory_info_table->info[index].flags;
-          return g_memory_info_table->info[index].type;
-       }
-       index++;
-      // val_print(ACS_PRINT_INFO," .", 0);
+  if ((low != 0) && (addr < info[low - 1].phy_addr + info[low - 1].size)) {
+      *attr = info[low - 1].flags;
+      return info[low - 1].type;
   }
 
   return MEM_TYPE_NOT_POPULATED;
@@ -259,16 +419,14 @@ uint64_t
 val_get_max_memory()
 {
 
-  uint32_t index = 0;
-  uint64_t addr = 0;
+  MEM_INFO_BLOCK *last;
 
-  while (g_memory_info_table->info[index].type != MEMORY_TYPE_LAST_ENTRY) {
-      if ((g_memory_info_table->info[index].phy_addr) > addr)
-              addr = (g_memory_info_table->info[index].phy_addr +
-                      g_memory_info_table->info[index].size);
-      index++;
-  }
-  return addr;
+  /* The table is sorted, the last entry has the highest base */
+  if (g_memory_info_count == 0)
+      return 0;
+
+  last = &g_memory_info_table->info[g_memory_info_count - 1];
+  return last->phy_addr + last->size;
 
 }
 
@@ -61,13 +61,12 @@ val_mng_create_info_table(uint64_t *mng_info_table)
 uint32_t
 val_mng_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 {
-  uint32_t status, i;
+  uint32_t status;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_MNG_TEST_NUM_BASE) {
-        val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all MNG tests\n", 0);
-        return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_MNG_TEST_NUM_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all MNG tests\n", 0);
+      return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
@@ -29,6 +29,455 @@ uint32_t pcie_bdf_table_list_flag;
 
 uint64_t
 pal_get_mcfg_ptr(void);
+
+/* Per-segment tables of ECAM base addresses, indexed by bus number */
+static addr_t *g_pcie_ecam_lookup[PCIE_MAX_SEG];
+static uint32_t g_pcie_ecam_lookup_valid;
+
+/* Capability cache, an open addressed hash map from BDF to the capability
+   lists of the Function, filled on the first capability lookup */
+#define PCIE_CAP_CACHE_MAX_CAP     16
+#define PCIE_CAP_CACHE_MAX_ECAP    32
+#define PCIE_CAP_CACHE_MIN_SLOTS   64
+#define PCIE_CAP_CACHE_HASH_MULT   0x9E3779B1
+
+#define PCIE_CAP_CACHE_IN_USE      0x1
+#define PCIE_CAP_CACHE_CAP_VALID   0x2   /* cap[] holds the whole capability list */
+#define PCIE_CAP_CACHE_ECAP_VALID  0x4   /* ecap[] holds the whole extended list */
+#define PCIE_CAP_CACHE_CAP_WALK    0x8   /* list longer than cap[], walk config space */
+#define PCIE_CAP_CACHE_ECAP_WALK   0x10  /* list longer than ecap[], walk config space */
+
+typedef struct {
+  uint32_t bdf;
+  uint16_t flags;
+  uint8_t  num_cap;
+  uint8_t  num_ecap;
+  uint16_t cap[PCIE_CAP_CACHE_MAX_CAP];    /* Capability ID << 8 | offset, in list order */
+  uint32_t ecap[PCIE_CAP_CACHE_MAX_ECAP];  /* Capability ID << 16 | offset, in list order */
+} PCIE_CAP_CACHE_ENTRY;
+
+static PCIE_CAP_CACHE_ENTRY *g_pcie_cap_cache;
+static uint32_t g_pcie_cap_cache_mask;
+static uint32_t g_pcie_cap_cache_used;
+static uint64_t g_pcie_cap_cache_owner;
+
+/**
+  @brief   This API returns the ECAM base of the region decoding the given
+           segment and bus by walking all the ECAM regions in the info table.
+           Used to build the ECAM lookup and as a fallback when it is absent.
+  @param   segment - PCIe segment number
+  @param   bus     - PCIe bus number
+
+  @return  ECAM base address, 0 if no region decodes the segment and bus
+**/
+static addr_t
+val_pcie_find_ecam_region(uint32_t segment, uint32_t bus)
+{
+  uint32_t i;
+  uint32_t num_ecam;
+
+  num_ecam = g_pcie_info_table->num_entries;
+  for (i = 0; i < num_ecam; i++)
+  {
+      if ((bus >= g_pcie_info_table->block[i].start_bus_num) &&
+          (bus <= g_pcie_info_table->block[i].end_bus_num) &&
+          (segment == g_pcie_info_table->block[i].segment_num))
+          return g_pcie_info_table->block[i].ecam_base;
+  }
+
+  return 0;
+}
+
+/**
+  @brief   This API returns the ECAM base of the region decoding the given
+           segment and bus. Resolves in constant time once the ECAM lookup
+           is built by val_pcie_create_info_table.
+  @param   segment - PCIe segment number
+  @param   bus     - PCIe bus number
+
+  @return  ECAM base address, 0 if no region decodes the segment and bus
+**/
+static addr_t
+val_pcie_lookup_ecam_base(uint32_t segment, uint32_t bus)
+{
+  addr_t *bus_table;
+
+  if (!g_pcie_ecam_lookup_valid)
+      return val_pcie_find_ecam_region(segment, bus);
+
+  bus_table = g_pcie_ecam_lookup[segment];
+  if (bus_table == NULL)
+      return 0;
+
+  return bus_table[bus];
+}
+
+/**
+  @brief   This API frees the ECAM lookup tables
+
+  @param   None
+
+  @return  None
+**/
+static void
+val_pcie_free_ecam_lookup(void)
+{
+  uint32_t seg;
+
+  g_pcie_ecam_lookup_valid = 0;
+
+  for (seg = 0; seg < PCIE_MAX_SEG; seg++) {
+      if (g_pcie_ecam_lookup[seg] != NULL) {
+          pal_mem_free((void *)g_pcie_ecam_lookup[seg]);
+          g_pcie_ecam_lookup[seg] = NULL;
+      }
+  }
+}
+
+/**
+  @brief   This API builds the segment and bus indexed ECAM lookup from the
+           ECAM regions in g_pcie_info_table. A bus table is allocated only
+           for segments that have an ECAM region. When regions overlap, the
+           first region in the info table wins, matching the linear walk.
+           1. Caller       -  val_pcie_create_info_table
+           2. Prerequisite -  g_pcie_info_table populated
+  @param   None
+
+  @return  0 if success, 1 if the lookup could not be built
+**/
+static uint32_t
+val_pcie_create_ecam_lookup(void)
+{
+  uint32_t i;
+  uint32_t seg;
+  uint32_t bus;
+  uint32_t end_bus;
+  uint32_t num_ecam;
+  uint32_t line_size;
+  addr_t   *bus_table;
+  addr_t   addr;
+
+  val_pcie_free_ecam_lookup();
+
+  num_ecam = g_pcie_info_table->num_entries;
+  for (i = 0; i < num_ecam; i++)
+  {
+      seg = g_pcie_info_table->block[i].segment_num;
+
+      /* Segments beyond the BDF encoding can never be addressed */
+      if (seg >= PCIE_MAX_SEG) {
+          val_print(ACS_PRINT_WARN, "\n       ECAM segment %x not addressable", seg);
+          continue;
+      }
+
+      bus_table = g_pcie_ecam_lookup[seg];
+      if (bus_table == NULL) {
+          bus_table = pal_mem_calloc(PCIE_MAX_BUS, sizeof(addr_t));
+          if (bus_table == NULL) {
+              val_print(ACS_PRINT_ERR, "\n       ECAM lookup allocation failed", 0);
+              val_pcie_free_ecam_lookup();
+              return 1;
+          }
+          g_pcie_ecam_lookup[seg] = bus_table;
+      }
+
+      end_bus = g_pcie_info_table->block[i].end_bus_num;
+      if (end_bus >= PCIE_MAX_BUS)
+          end_bus = PCIE_MAX_BUS - 1;
+
+      for (bus = g_pcie_info_table->block[i].start_bus_num; bus <= end_bus; bus++) {
+          if (bus_table[bus] == 0)
+              bus_table[bus] = g_pcie_info_table->block[i].ecam_base;
+      }
+  }
+
+  g_pcie_ecam_lookup_valid = 1;
+
+  /* Secondary harts may look up config space with their caches off */
+  line_size = val_hart_get_cache_line_size();
+  for (seg = 0; seg < PCIE_MAX_SEG; seg++) {
+      bus_table = g_pcie_ecam_lookup[seg];
+      if (bus_table == NULL)
+          continue;
+
+      for (addr = (addr_t)bus_table; addr < (addr_t)&bus_table[PCIE_MAX_BUS]; addr += line_size)
+          val_data_cache_ops_by_va(addr, CLEAN_AND_INVALIDATE);
+  }
+
+  for (addr = (addr_t)g_pcie_ecam_lookup; addr < (addr_t)&g_pcie_ecam_lookup[PCIE_MAX_SEG];
+       addr += line_size)
+      val_data_cache_ops_by_va(addr, CLEAN_AND_INVALIDATE);
+
+  val_data_cache_ops_by_va((addr_t)&g_pcie_ecam_lookup_valid, CLEAN_AND_INVALIDATE);
+  return 0;
+}
+
+/**
+  @brief   Returns the capability cache slot at which the probe for a BDF starts
+
+  @param   bdf  - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   mask - Number of slots minus one
+  @return  Slot index
+**/
+static uint32_t
+val_pcie_cap_cache_slot(uint32_t bdf, uint32_t mask)
+{
+  return (uint32_t)(((uint64_t)bdf * PCIE_CAP_CACHE_HASH_MULT) >> 16) & mask;
+}
+
+/**
+  @brief   This API frees the capability cache. All Functions are looked up
+           through config space again until the cache is refilled.
+
+  @param   None
+
+  @return  None
+**/
+static void
+val_pcie_free_cap_cache(void)
+{
+  if (g_pcie_cap_cache != NULL) {
+      pal_mem_free((void *)g_pcie_cap_cache);
+      g_pcie_cap_cache = NULL;
+  }
+
+  g_pcie_cap_cache_mask = 0;
+  g_pcie_cap_cache_used = 0;
+}
+
+/**
+  @brief   This API doubles the number of capability cache slots, allocating
+           the first set of slots if there are none, and rehashes the
+           cached Functions into them.
+
+  @param   None
+
+  @return  0 if success, 1 if the slots could not be allocated
+**/
+static uint32_t
+val_pcie_grow_cap_cache(void)
+{
+  uint32_t i;
+  uint32_t slot;
+  uint32_t num_slots;
+  PCIE_CAP_CACHE_ENTRY *cache;
+
+  num_slots = g_pcie_cap_cache ? (2 * (g_pcie_cap_cache_mask + 1)) : PCIE_CAP_CACHE_MIN_SLOTS;
+
+  cache = pal_mem_calloc(num_slots, sizeof(PCIE_CAP_CACHE_ENTRY));
+  if (cache == NULL)
+      return 1;
+
+  if (g_pcie_cap_cache != NULL) {
+      for (i = 0; i <= g_pcie_cap_cache_mask; i++) {
+          if (!(g_pcie_cap_cache[i].flags & PCIE_CAP_CACHE_IN_USE))
+              continue;
+
+          slot = val_pcie_cap_cache_slot(g_pcie_cap_cache[i].bdf, num_slots - 1);
+          while (cache[slot].flags & PCIE_CAP_CACHE_IN_USE)
+              slot = (slot + 1) & (num_slots - 1);
+
+          cache[slot] = g_pcie_cap_cache[i];
+      }
+      pal_mem_free((void *)g_pcie_cap_cache);
+  }
+
+  g_pcie_cap_cache = cache;
+  g_pcie_cap_cache_mask = num_slots - 1;
+  return 0;
+}
+
+/**
+  @brief   This API returns the capability cache entry of a Function.
+           The cache is only used by the HART that created the PCIe info
+           table. Other HARTs walk config space, so the cache needs no
+           locking.
+
+  @param   bdf    - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   create - Add an empty entry if the Function is not cached
+
+  @return  Cache entry, NULL if the Function is not cached and not added
+**/
+static PCIE_CAP_CACHE_ENTRY *
+val_pcie_get_cap_cache(uint32_t bdf, uint32_t create)
+{
+  uint32_t slot;
+  PCIE_CAP_CACHE_ENTRY *entry;
+
+  if (val_hart_get_mpid() != g_pcie_cap_cache_owner)
+      return NULL;
+
+  if (g_pcie_cap_cache != NULL) {
+      slot = val_pcie_cap_cache_slot(bdf, g_pcie_cap_cache_mask);
+      while (g_pcie_cap_cache[slot].flags & PCIE_CAP_CACHE_IN_USE) {
+          if (g_pcie_cap_cache[slot].bdf == bdf)
+              return &g_pcie_cap_cache[slot];
+          slot = (slot + 1) & g_pcie_cap_cache_mask;
+      }
+  }
+
+  if (!create)
+      return NULL;
+
+  /* Keep the map at most half full */
+  if ((g_pcie_cap_cache == NULL) ||
+      ((2 * (g_pcie_cap_cache_used + 1)) > (g_pcie_cap_cache_mask + 1))) {
+      if (val_pcie_grow_cap_cache())
+          return NULL;
+  }
+
+  slot = val_pcie_cap_cache_slot(bdf, g_pcie_cap_cache_mask);
+  while (g_pcie_cap_cache[slot].flags & PCIE_CAP_CACHE_IN_USE)
+      slot = (slot + 1) & g_pcie_cap_cache_mask;
+
+  entry = &g_pcie_cap_cache[slot];
+  entry->bdf = bdf;
+  entry->flags = PCIE_CAP_CACHE_IN_USE;
+  g_pcie_cap_cache_used++;
+
+  return entry;
+}
+
+/**
+  @brief   This API walks one capability list of a Function and records it
+           in the capability cache entry of the Function. A list that does
+           not fit in the entry is marked to be walked on every lookup.
+           Nothing is recorded if the Function does not respond.
+
+  @param   bdf      - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   cid_type - PCI capability or Extended PCIe capability
+  @param   entry    - Capability cache entry of the Function
+
+  @return  None
+**/
+static void
+val_pcie_fill_cap_cache(uint32_t bdf, uint32_t cid_type, PCIE_CAP_CACHE_ENTRY *entry)
+{
+  uint32_t reg_value;
+  uint32_t next_cap_offset;
+  uint32_t num = 0;
+
+  if (cid_type == PCIE_CAP) {
+
+      if ((val_pcie_read_cfg(bdf, TYPE01_CPR, &reg_value) != PCIE_SUCCESS) ||
+          (reg_value == PCIE_UNKNOWN_RESPONSE))
+          return;
+
+      next_cap_offset = (reg_value & TYPE01_CPR_MASK);
+      while (next_cap_offset)
+      {
+          if (num == PCIE_CAP_CACHE_MAX_CAP) {
+              entry->flags |= PCIE_CAP_CACHE_CAP_WALK;
+              return;
+          }
+
+          val_pcie_read_cfg(bdf, next_cap_offset, &reg_value);
+          entry->cap[num++] = ((reg_value & PCIE_CIDR_MASK) << 8) | next_cap_offset;
+          next_cap_offset = ((reg_value >> PCIE_NCPR_SHIFT) & PCIE_NCPR_MASK);
+      }
+
+      entry->num_cap = num;
+      entry->flags |= PCIE_CAP_CACHE_CAP_VALID;
+  } else if (cid_type == PCIE_ECAP)
+  {
+
+      next_cap_offset = PCIE_ECAP_START;
+      while (next_cap_offset)
+      {
+          if (num == PCIE_CAP_CACHE_MAX_ECAP) {
+              entry->flags |= PCIE_CAP_CACHE_ECAP_WALK;
+              return;
+          }
+
+          if ((val_pcie_read_cfg(bdf, next_cap_offset, &reg_value) != PCIE_SUCCESS) ||
+              (reg_value == PCIE_UNKNOWN_RESPONSE))
+              return;
+
+          entry->ecap[num++] = ((reg_value & PCIE_ECAP_CIDR_MASK) << 16) | next_cap_offset;
+          next_cap_offset = ((reg_value >> PCIE_ECAP_NCPR_SHIFT) & PCIE_ECAP_NCPR_MASK);
+      }
+
+      entry->num_ecap = num;
+      entry->flags |= PCIE_CAP_CACHE_ECAP_VALID;
+  }
+}
+
+/**
+  @brief   This API drops the cached capability lists of a Function, or of
+           all Functions, so that the next capability lookup reads them
+           from config space again. Called when a Function is reset.
+
+  @param   bdf - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF, or
+                 PCIE_CAP_CACHE_ALL_BDF for all Functions
+
+  @return  None
+**/
+void
+val_pcie_cap_cache_invalidate(uint32_t bdf)
+{
+  PCIE_CAP_CACHE_ENTRY *entry;
+
+  if (g_pcie_cap_cache == NULL)
+      return;
+
+  if (bdf == PCIE_CAP_CACHE_ALL_BDF) {
+      val_pcie_free_cap_cache();
+      return;
+  }
+
+  entry = val_pcie_get_cap_cache(bdf, 0);
+  if (entry != NULL)
+      entry->flags = PCIE_CAP_CACHE_IN_USE;
+}
+
+/**
+  @brief   This API invalidates the capability cache on config writes that
+           reset Functions. Setting Initiate Function Level Reset resets
+           the Function. Setting Secondary Bus Reset in the Bridge Control
+           register resets every Function below the bridge.
+
+  @param   bdf    - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param   offset - Register offset within the Function config space
+  @param   data   - Data written to the config space
+
+  @return  None
+**/
+static void
+val_pcie_cap_cache_check_reset(uint32_t bdf, uint32_t offset, uint32_t data)
+{
+  uint32_t i;
+  PCIE_CAP_CACHE_ENTRY *entry;
+
+  if (g_pcie_cap_cache == NULL)
+      return;
+
+  if ((offset == TYPE01_ILR) && (data & BRIDGE_CTRL_SBR_SET)) {
+      val_pcie_cap_cache_invalidate(PCIE_CAP_CACHE_ALL_BDF);
+      return;
+  }
+
+  if (!(data & DCTLR_FLR_SET))
+      return;
+
+  entry = val_pcie_get_cap_cache(bdf, 0);
+  if (entry == NULL)
+      return;
+
+  /* Without the PCIe capability offset, any such write may be the reset */
+  if (!(entry->flags & PCIE_CAP_CACHE_CAP_VALID)) {
+      entry->flags = PCIE_CAP_CACHE_IN_USE;
+      return;
+  }
+
+  for (i = 0; i < entry->num_cap; i++) {
+      if ((entry->cap[i] >> 8) == CID_PCIECS) {
+          if (offset == (uint32_t)((entry->cap[i] & 0xFF) + DCTLR_OFFSET))
+              entry->flags = PCIE_CAP_CACHE_IN_USE;
+          return;
+      }
+  }
+}
+
 /**
   @brief   This API reads 32-bit data from PCIe config space pointed by Bus,
            Device, Function and register offset.
@@ -49,7 +498,6 @@ val_pcie_read_cfg_width(uint32_t bdf, uint32_t offset, void *data, PCI_WIDTH_TYP
   uint32_t segment = PCIE_EXTRACT_BDF_SEG(bdf);
   uint32_t cfg_addr;
   addr_t   ecam_base = 0;
-  uint32_t i = 0;
 
 
   if ((bus >= PCIE_MAX_BUS) || (dev >= PCIE_MAX_DEV) || (func >= PCIE_MAX_FUNC)) {
@@ -62,17 +510,7 @@ val_pcie_read_cfg_width(uint32_t bdf, uint32_t offset, void *data, PCI_WIDTH_TYP
       return PCIE_NO_MAPPING;
   }
 
-  while (i < (uint32_t)val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0))
-  {
-
-      if ((bus >= (uint32_t)val_pcie_get_info(PCIE_INFO_START_BUS, i)) &&
-           (bus <= (uint32_t)val_pcie_get_info(PCIE_INFO_END_BUS, i)) &&
-           (segment == (uint32_t)val_pcie_get_info(PCIE_INFO_SEGMENT, i))) {
-          ecam_base = val_pcie_get_info(PCIE_INFO_ECAM, i);
-          break;
-      }
-      i++;
-  }
+  ecam_base = val_pcie_lookup_ecam_base(segment, bus);
 
   if (ecam_base == 0) {
       val_print(ACS_PRINT_ERR, "\n       PCIe_CFG_RD ECAM Base is zero %.8x", bdf);
@@ -156,7 +594,6 @@ val_pcie_write_cfg(uint32_t bdf, uint32_t offset, uint32_t data)
   uint32_t segment  = PCIE_EXTRACT_BDF_SEG(bdf);
   uint32_t cfg_addr;
   addr_t   ecam_base = 0;
-  uint32_t i = 0;
 
 
   if ((bus >= PCIE_MAX_BUS) || (dev >= PCIE_MAX_DEV) || (func >= PCIE_MAX_FUNC)) {
@@ -169,17 +606,7 @@ val_pcie_write_cfg(uint32_t bdf, uint32_t offset, uint32_t data)
       return;
   }
 
-  while (i < (uint32_t)val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0))
-  {
-
-      if ((bus >= (uint32_t)val_pcie_get_info(PCIE_INFO_START_BUS, i)) &&
-           (bus <= (uint32_t)val_pcie_get_info(PCIE_INFO_END_BUS, i)) &&
-           (segment == (uint32_t)val_pcie_get_info(PCIE_INFO_SEGMENT, i))) {
-          ecam_base = val_pcie_get_info(PCIE_INFO_ECAM, i);
-          break;
-      }
-      i++;
-  }
+  ecam_base = val_pcie_lookup_ecam_base(segment, bus);
 
   if (ecam_base == 0) {
       val_print(ACS_PRINT_ERR, "\n       PCIe_CFG_WR ECAM Base is zero %.8x", bdf);
@@ -191,6 +618,8 @@ val_pcie_write_cfg(uint32_t bdf, uint32_t offset, uint32_t data)
                (dev * PCIE_MAX_FUNC * 4096) + (func * 4096);
 
   pal_mmio_write(ecam_base + cfg_addr + offset, data);
+
+  val_pcie_cap_cache_check_reset(bdf, offset, data);
 }
 
 /**
@@ -255,9 +684,7 @@ uint64_t val_pcie_get_bdf_config_addr(uint32_t bdf)
   uint32_t func     = PCIE_EXTRACT_BDF_FUNC(bdf);
   uint32_t segment  = PCIE_EXTRACT_BDF_SEG(bdf);
   uint32_t cfg_addr;
-  uint32_t num_ecam;
   addr_t   ecam_base = 0;
-  uint32_t i = 0;
 
   if ((bus >= PCIE_MAX_BUS) || (dev >= PCIE_MAX_DEV) || (func >= PCIE_MAX_FUNC)) {
      val_print(ACS_PRINT_ERR, "\n       Invalid Bus/Dev/Func  %x", bdf);
@@ -269,18 +696,7 @@ uint64_t val_pcie_get_bdf_config_addr(uint32_t bdf)
       return 0;
   }
 
-  num_ecam = (uint32_t)val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0);
-  while (i < num_ecam)
-  {
-
-      if ((bus >= (uint32_t)val_pcie_get_info(PCIE_INFO_START_BUS, i)) &&
-           (bus <= (uint32_t)val_pcie_get_info(PCIE_INFO_END_BUS, i)) &&
-           (segment == (uint32_t)val_pcie_get_info(PCIE_INFO_SEGMENT, i))) {
-          ecam_base = val_pcie_get_info(PCIE_INFO_ECAM, i);
-          break;
-      }
-      i++;
-  }
+  ecam_base = val_pcie_lookup_ecam_base(segment, bus);
 
   if (ecam_base == 0) {
       val_print(ACS_PRINT_ERR, "\n       BDF config Read PCIe_CFG: ECAM Base is zero %x", bdf);
@@ -323,14 +739,13 @@ void val_pcie_enumerate(void)
 uint32_t
 val_pcie_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 {
-  uint32_t status, i;
+  uint32_t status;
   uint32_t num_ecam = 0;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_PCIE_TEST_NUM_BASE) {
-          val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all PCIe tests\n", 0);
-          return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_PCIE_TEST_NUM_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all PCIe tests\n", 0);
+      return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
@@ -521,6 +936,20 @@ val_pcie_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 //   }
 // }
 
+/**
+  @brief   This API returns the number of bytes needed for the PCIe info table,
+           as counted by the PAL layer, so that the caller can allocate it exactly.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  None.
+  @param   None
+  @return  Size of the PCIe info table in bytes
+**/
+uint32_t
+val_pcie_get_info_table_size(void)
+{
+  return sizeof(PCIE_INFO_TABLE) + (pal_pcie_get_info_entry_count() * sizeof(PCIE_INFO_BLOCK));
+}
+
 /**
   @brief   This API will call PAL layer to fill in the PCIe information
            into the g_pcie_info_table pointer.
@@ -543,6 +972,10 @@ val_pcie_create_info_table(uint64_t *pcie_info_table)
 
   g_pcie_info_table = (PCIE_INFO_TABLE *)pcie_info_table;
 
+  /* Capability lookups from this HART are cached */
+  val_pcie_free_cap_cache();
+  g_pcie_cap_cache_owner = val_hart_get_mpid();
+
   pal_pcie_create_info_table(g_pcie_info_table);
 
   num_ecam = (uint32_t)val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0);
@@ -550,6 +983,13 @@ val_pcie_create_info_table(uint64_t *pcie_info_table)
   if (num_ecam == 0)
       return;
 
+  /* Index the ECAM regions so config accesses resolve their base directly */
+  if (val_pcie_create_ecam_lookup())
+      val_print(ACS_PRINT_WARN, " ECAM lookup not built, using region walk\n", 0);
+
+  if (g_perf_mode)
+      val_pcie_cfg_access_benchmark(PCIE_CFG_BENCH_ITERATIONS);
+
   // val_pcie_enumerate();
 
   /* Create the list of valid Pcie Device Functions */
@@ -791,9 +1231,69 @@ val_pcie_bdf_table_ptr()
 void
 val_pcie_free_info_table()
 {
+  val_pcie_free_cap_cache();
+  val_pcie_free_ecam_lookup();
   pal_mem_free((void *)g_pcie_info_table);
 }
 
+/**
+  @brief   This API measures the config space read rate through the ECAM
+           region walk and through the segment/bus ECAM lookup, and prints
+           the accesses per second for each. The last ECAM region is used
+           as it is the worst case for the region walk.
+           1. Caller       -  val_pcie_create_info_table
+           2. Prerequisite -  val_pcie_create_info_table
+  @param   num_iter - Number of config reads per measurement
+
+  @return  None
+**/
+void
+val_pcie_cfg_access_benchmark(uint32_t num_iter)
+{
+  uint32_t i;
+  uint32_t bdf;
+  uint32_t data;
+  uint32_t num_ecam;
+  uint32_t lookup_valid;
+  uint64_t start;
+  uint64_t walk_us;
+  uint64_t lookup_us;
+
+  num_ecam = (uint32_t)val_pcie_get_info(PCIE_INFO_NUM_ECAM, 0);
+  if ((num_ecam == 0) || (num_iter == 0))
+      return;
+
+  bdf = PCIE_CREATE_BDF((uint32_t)val_pcie_get_info(PCIE_INFO_SEGMENT, num_ecam - 1),
+                        (uint32_t)val_pcie_get_info(PCIE_INFO_START_BUS, num_ecam - 1),
+                        0, 0);
+
+  lookup_valid = g_pcie_ecam_lookup_valid;
+
+  /* Region walk used before the ECAM lookup was introduced */
+  g_pcie_ecam_lookup_valid = 0;
+  start = val_timer_get_counter();
+  for (i = 0; i < num_iter; i++)
+      val_pcie_read_cfg(bdf, TYPE01_VIDR, &data);
+  walk_us = val_timer_ticks_to_us(val_timer_get_counter() - start);
+
+  g_pcie_ecam_lookup_valid = lookup_valid;
+  start = val_timer_get_counter();
+  for (i = 0; i < num_iter; i++)
+      val_pcie_read_cfg(bdf, TYPE01_VIDR, &data);
+  lookup_us = val_timer_ticks_to_us(val_timer_get_counter() - start);
+
+  val_print(ACS_PRINT_TEST, "\n PCIE_PERF: Cfg reads per measurement :    %d", num_iter);
+  val_print(ACS_PRINT_TEST, "\n PCIE_PERF: Region walk (us)          :    %ld", walk_us);
+  if (walk_us)
+      val_print(ACS_PRINT_TEST, "  (%ld accesses/s)", (num_iter * 1000000ULL) / walk_us);
+  val_print(ACS_PRINT_TEST, "\n PCIE_PERF: ECAM lookup (us)          :    %ld", lookup_us);
+  if (lookup_us)
+      val_print(ACS_PRINT_TEST, "  (%ld accesses/s)", (num_iter * 1000000ULL) / lookup_us);
+  if (!lookup_valid)
+      val_print(ACS_PRINT_TEST, "\n PCIE_PERF: ECAM lookup not built, both use region walk", 0);
+  val_print(ACS_PRINT_TEST, "\n", 0);
+}
+
 
 /**
   @brief   This API is the single entry point to return all PCIe related information
@@ -1277,6 +1777,8 @@ val_pcie_device_port_type(uint32_t bdf)
 /**
   @brief  Find a Function's config capability offset matching it's input parameter
           cid. cid_offset set to the matching cpability offset w.r.t. zero.
+          The capability lists of the Function are read once and served
+          from the capability cache until the Function is reset.
 
   @param  bdf        - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
   @param  cid_type   - PCI capability or Extended PCIe capability
@@ -1292,6 +1794,39 @@ val_pcie_find_capability(uint32_t bdf, uint32_t cid_type, uint32_t cid, uint32_t
   uint32_t reg_value;
   uint32_t next_cap_offset;
   uint32_t ret;
+  uint32_t i;
+  PCIE_CAP_CACHE_ENTRY *entry;
+
+  entry = val_pcie_get_cap_cache(bdf, 1);
+  if (entry != NULL) {
+      if (cid_type == PCIE_CAP) {
+          if (!(entry->flags & (PCIE_CAP_CACHE_CAP_VALID | PCIE_CAP_CACHE_CAP_WALK)))
+              val_pcie_fill_cap_cache(bdf, cid_type, entry);
+
+          if (entry->flags & PCIE_CAP_CACHE_CAP_VALID) {
+              for (i = 0; i < entry->num_cap; i++) {
+                  if ((entry->cap[i] >> 8) == cid) {
+                      *cid_offset = entry->cap[i] & 0xFF;
+                      return PCIE_SUCCESS;
+                  }
+              }
+              return PCIE_CAP_NOT_FOUND;
+          }
+      } else if (cid_type == PCIE_ECAP) {
+          if (!(entry->flags & (PCIE_CAP_CACHE_ECAP_VALID | PCIE_CAP_CACHE_ECAP_WALK)))
+              val_pcie_fill_cap_cache(bdf, cid_type, entry);
+
+          if (entry->flags & PCIE_CAP_CACHE_ECAP_VALID) {
+              for (i = 0; i < entry->num_ecap; i++) {
+                  if ((entry->ecap[i] >> 16) == cid) {
+                      *cid_offset = entry->ecap[i] & 0xFFFF;
+                      return PCIE_SUCCESS;
+                  }
+              }
+              return PCIE_CAP_NOT_FOUND;
+          }
+      }
+  }
 
   if (cid_type == PCIE_CAP) {
 
@@ -1821,8 +2356,217 @@ uint32_t val_pcie_bitfield_check(uint32_t bdf, uint64_t *bitfield_entry)
   return 0;
 }
 
+/**
+  @brief  Returns the number of config accesses val_pcie_bitfield_check
+          makes for a bit-field entry whose capability is present.
+
+  @param  attr      - Bit-field attribute
+  @param  value_ok  - 1 if the configured value check passes
+  @return Number of config reads and writes
+**/
+static uint32_t
+val_pcie_bitfield_access_cost(uint32_t attr, uint32_t value_ok)
+{
+  /* Read, write back and read again to get the value */
+  if (!value_ok)
+      return 3;
+
+  /* Toggle, read back and restore for the writable ones */
+  if ((attr == READ_WRITE) || (attr == STICKY_RW))
+      return 6;
+
+  return 5;
+}
+
+/**
+  @brief  Returns the key bit-field entries are grouped by, made of register
+          type, capability ID and word aligned register offset.
+
+  @param  bf_entry  - Bit-field entry
+  @return Group key
+**/
+static uint64_t
+val_pcie_bitfield_group_key(pcie_cfgreg_bitfield_entry *bf_entry)
+{
+  uint64_t id = 0;
+
+  if (bf_entry->reg_type == PCIE_CAP)
+      id = bf_entry->cap_id;
+  else if (bf_entry->reg_type == PCIE_ECAP)
+      id = bf_entry->ecap_id;
+
+  return ((uint64_t)bf_entry->reg_type << 48) | (id << 16) |
+         (bf_entry->reg_offset & ~WORD_ALIGN_MASK);
+}
+
+/**
+  @brief  Checks all bit-field entries of one register of a device with one
+          read of the register and, if attributes are to be checked, one
+          combined write probe. Read-only fields and read-write fields are
+          toggled, RsvdZ fields are written 0, and every field is compared
+          against what its attribute expects. Entries failing any comparison
+          are run again through val_pcie_bitfield_check, which reports them
+          exactly as the per-entry check does.
+
+  @param  bdf       - Segment/Bus/Dev/Func in the format of PCIE_CREATE_BDF
+  @param  group     - Bit-field entries of the same register, applicable to bdf
+  @param  num_entry - Number of entries in group
+  @param  stats     - Pass/fail and config access counters to update
+  @return None
+**/
+static void
+val_pcie_bitfield_check_group(uint32_t bdf, pcie_cfgreg_bitfield_entry **group,
+                              uint32_t num_entry, PCIE_BITFIELD_STATS *stats)
+{
+  uint32_t i;
+  uint32_t cap_base;
+  uint32_t reg_offset;
+  uint32_t reg_value;
+  uint32_t probe_value;
+  uint32_t readback;
+  uint32_t field;
+  uint32_t mask;
+  uint32_t shift;
+  uint32_t flip_mask = 0;
+  uint32_t zero_mask = 0;
+  uint32_t num_probe = 0;
+  uint32_t value_ok[BITFIELD_GROUP_MAX];
+  uint32_t recheck[BITFIELD_GROUP_MAX];
+  uint32_t status = PCIE_SUCCESS;
+  pcie_cfgreg_bitfield_entry *bf_entry = group[0];
+
+  switch (bf_entry->reg_type)
+  {
+      case HEADER:
+          cap_base = 0;
+          break;
+      case PCIE_CAP:
+          status = val_pcie_find_capability(bdf, PCIE_CAP, bf_entry->cap_id, &cap_base);
+          break;
+      case PCIE_ECAP:
+          status = val_pcie_find_capability(bdf, PCIE_ECAP, bf_entry->ecap_id, &cap_base);
+          break;
+      default:
+          status = PCIE_CAP_NOT_FOUND;
+          break;
+  }
+
+  /* Leave the reporting of a missing capability to the per-entry check */
+  if (status != PCIE_SUCCESS)
+  {
+      for (i = 0; i < num_entry; i++) {
+          if (val_pcie_bitfield_check(bdf, (void *)group[i]))
+              stats->num_fails++;
+          else
+              stats->num_pass++;
+      }
+      return;
+  }
+
+  reg_offset = cap_base + (bf_entry->reg_offset & ~WORD_ALIGN_MASK);
+
+  /* Write the value back once to clear the status bits, as the per-entry check does */
+  val_pcie_read_cfg(bdf, reg_offset, &reg_value);
+  val_pcie_write_cfg(bdf, reg_offset, reg_value);
+  val_pcie_read_cfg(bdf, reg_offset, &reg_value);
+  stats->num_access += 3;
+
+  for (i = 0; i < num_entry; i++)
+  {
+      bf_entry = group[i];
+      shift = REG_SHIFT(bf_entry->reg_offset & WORD_ALIGN_MASK, bf_entry->start);
+      mask = REG_MASK(bf_entry->end, bf_entry->start) << shift;
+      field = (reg_value & mask) >> shift;
+
+      value_ok[i] = (field == bf_entry->cfg_value);
+      recheck[i] = !value_ok[i];
+      stats->num_access_unbatched += val_pcie_bitfield_access_cost(bf_entry->attr, value_ok[i]);
+      if (!value_ok[i])
+          continue;
+
+      switch (bf_entry->attr)
+      {
+          case HW_INIT:
+          case READ_ONLY:
+          case STICKY_RO:
+          case READ_WRITE:
+          case STICKY_RW:
+              flip_mask |= mask;
+              break;
+          case RSVDZ_RO:
+              zero_mask |= mask;
+              break;
+          case RSVDP_RO:
+              break;
+          default:
+              recheck[i] = 1;
+              continue;
+      }
+      num_probe++;
+  }
+
+  if (num_probe)
+  {
+      probe_value = (reg_value ^ flip_mask) & ~zero_mask;
+      val_pcie_write_cfg(bdf, reg_offset, probe_value);
+      val_pcie_read_cfg(bdf, reg_offset, &readback);
+      stats->num_access += 2;
+
+      for (i = 0; i < num_entry; i++)
+      {
+          if (recheck[i])
+              continue;
+
+          bf_entry = group[i];
+          shift = REG_SHIFT(bf_entry->reg_offset & WORD_ALIGN_MASK, bf_entry->start);
+          mask = REG_MASK(bf_entry->end, bf_entry->start) << shift;
+
+          switch (bf_entry->attr)
+          {
+              case READ_WRITE:
+              case STICKY_RW:
+                  /* Software can alter these bits */
+                  recheck[i] = ((readback & mask) != (probe_value & mask));
+                  break;
+              case RSVDP_RO:
+                  /* Must return 0 when read */
+                  recheck[i] = ((readback & mask) != 0);
+                  break;
+              default:
+                  /* Software must not alter these bits */
+                  recheck[i] = ((readback & mask) != (reg_value & mask));
+                  break;
+          }
+      }
+
+      /* Restore the original register value */
+      if (readback != reg_value) {
+          val_pcie_write_cfg(bdf, reg_offset, reg_value);
+          stats->num_access++;
+      }
+  }
+
+  for (i = 0; i < num_entry; i++)
+  {
+      if (recheck[i])
+      {
+          stats->num_access += val_pcie_bitfield_access_cost(group[i]->attr, value_ok[i]);
+          if (val_pcie_bitfield_check(bdf, (void *)group[i]))
+              stats->num_fails++;
+          else
+              stats->num_pass++;
+          continue;
+      }
+
+      val_print(ACS_PRINT_INFO, "\n       BDF 0x%x : PASS", bdf);
+      stats->num_pass++;
+  }
+}
+
 /**
   @brief  Returns if a PCIe config register bitfields are as per bsa specification.
+          Entries are grouped by register so that each register of a device
+          is read once and probed with one write for all of its bit-fields.
 
   @param  bf_info_table - table of registers and their bit-fields for checking
   @param  num_bitfield_entries - Number of entries
@@ -1837,16 +2581,39 @@ val_pcie_register_bitfields_check(uint64_t *bf_info_table, uint32_t num_bitfield
   uint32_t bdf;
   uint32_t dp_type;
   uint32_t tbl_index;
-  uint32_t num_fails;
-  uint32_t num_pass;
   uint32_t index;
+  uint32_t entry;
+  uint32_t sorted;
+  uint32_t num_group;
+  uint32_t level;
+  uint32_t *order;
+  uint64_t key;
+  uint64_t group_key;
   pcie_cfgreg_bitfield_entry *bf_entry;
+  pcie_cfgreg_bitfield_entry *group[BITFIELD_GROUP_MAX];
+  PCIE_BITFIELD_STATS stats = {0};
 
-  num_fails = num_pass = tbl_index = 0;
+  tbl_index = 0;
+  bf_entry = (pcie_cfgreg_bitfield_entry *)&(bf_info_table[0]);
 
   val_print(ACS_PRINT_INFO, "\n       Number of bit-field entries to check %d",
             num_bitfield_entries);
 
+  /*
+   * Order the entries by register, keeping the table order within a register.
+   * Without memory for the order, only neighbouring entries are grouped.
+   */
+  order = pal_mem_alloc(num_bitfield_entries * sizeof(uint32_t));
+  for (index = 0; order && (index < num_bitfield_entries); index++)
+  {
+      key = val_pcie_bitfield_group_key(&bf_entry[index]);
+      for (sorted = index;
+           (sorted > 0) && (val_pcie_bitfield_group_key(&bf_entry[order[sorted - 1]]) > key);
+           sorted--)
+          order[sorted] = order[sorted - 1];
+      order[sorted] = index;
+  }
+
   while (tbl_index < g_pcie_bdf_table->num_entries)
   {
       bdf = g_pcie_bdf_table->device[tbl_index++].bdf;
@@ -1857,35 +2624,45 @@ val_pcie_register_bitfields_check(uint64_t *bf_info_table, uint32_t num_bitfield
       /* Get the Function's device/port type from bdf */
       dp_type = val_pcie_device_port_type(bdf);
 
-      /* Set variables to iterate over all bit-field entries */
-      bf_entry = (pcie_cfgreg_bitfield_entry *)&(bf_info_table[0]);
-
+      num_group = 0;
+      group_key = 0;
       for (index = 0; index < num_bitfield_entries; index++)
       {
           /*
            * Skip this entry checking, if the Function
            * is not part of it's device/port bit mask.
            */
-          if (!(dp_type & bf_entry->dev_port_bitmask))
-          {
-              bf_entry++;
+          entry = order ? order[index] : index;
+          if (!(dp_type & bf_entry[entry].dev_port_bitmask))
               continue;
-          }
 
-          /* Check for the compliance */
-          if (val_pcie_bitfield_check(bdf, (void *)bf_entry))
-              num_fails++;
-          else
-              num_pass++;
+          key = val_pcie_bitfield_group_key(&bf_entry[entry]);
+          if (num_group && ((key != group_key) || (num_group == BITFIELD_GROUP_MAX)))
+          {
+              val_pcie_bitfield_check_group(bdf, group, num_group, &stats);
+              num_group = 0;
+          }
 
-          /* Adjust the pointer to next bf */
-          bf_entry++;
+          group_key = key;
+          group[num_group++] = &bf_entry[entry];
       }
+
+      if (num_group)
+          val_pcie_bitfield_check_group(bdf, group, num_group, &stats);
   }
 
+  if (order)
+      pal_mem_free((void *)order);
+
+  level = g_perf_mode ? ACS_PRINT_TEST : ACS_PRINT_INFO;
+  val_print(level, "\n       Bit-field config accesses : %d", stats.num_access);
+  val_print(level, ", saved by grouping : %d",
+            (stats.num_access_unbatched > stats.num_access) ?
+            (stats.num_access_unbatched - stats.num_access) : 0);
+
   /* Return register check status */
-  if (num_pass > 0 || num_fails > 0)
-      return num_fails;
+  if (stats.num_pass > 0 || stats.num_fails > 0)
+      return stats.num_fails;
   else
       return ACS_STATUS_SKIP;
 }
@@ -21,15 +21,14 @@
 #include "include/bsa_acs_pgt.h"
 #include "include/bsa_acs_memory.h"
 
-#define get_min(a, b) ((a) < (b))?(a):(b)
-
 #define PGT_DEBUG_LEVEL ACS_PRINT_INFO
 
+/* Table page arenas that are live at the same time, beyond this pages are allocated one by one */
+#define PGT_ARENA_MAX   32
+
 static uint32_t page_size;
 static uint32_t bits_per_level;
 static uint64_t pgt_addr_mask;
-uint64_t is_values_init = 0;
-uint64_t offset = 0;
 
 typedef struct
 {
@@ -42,126 +41,123 @@ typedef struct
     uint32_t nbits;
 } tt_descriptor_t;
 
+/* Contiguous run of table pages allocated for the tables under one root */
 typedef struct {
-    uint32_t l0_index;
-    uint32_t l1_index;
-    uint32_t l2_index;
-    uint32_t l3_index;
-    uint64_t size_used;
-} acs_pgt_t;
+    uint64_t root;       /* Physical base of the root table, 0 while the root is not known */
+    uint64_t *base;
+    uint32_t num_pages;
+} pgt_arena_t;
 
-static acs_pgt_t acs_pgt_info;
+/* State of one val_pgt_create call */
+typedef struct {
+    uint32_t count_only;    /* Walk without writing, to size the arena */
+    uint32_t pages_needed;
+    uint32_t arena_slot;
+    uint64_t *arena_next;
+    uint32_t arena_free;
+    pgt_stats_t stats;
+} pgt_build_t;
+
+static pgt_arena_t pgt_arena[PGT_ARENA_MAX];
+static pgt_build_t pgt_build;
+static pgt_stats_t pgt_last_stats;
 
-void setup_acs_pgt_values(void)
-{
-    acs_pgt_info.l0_index = 0;
-    acs_pgt_info.l1_index = 0;
-    acs_pgt_info.l2_index = 0;
-    acs_pgt_info.l3_index = 0;
-    acs_pgt_info.size_used = 0;
-}
+/**
+  @brief  Returns a zeroed table page, from the arena of the current call when
+          it has pages left. When only counting, returns NULL and counts the page.
 
+  @param  None
 
-static
-uint32_t get_pgt_index(uint32_t level)
+  @return Virtual address of the table page, NULL when counting or on failure
+**/
+static uint64_t *pgt_alloc_table(void)
 {
-    switch (level)
-    {
-        case(PGT_LEVEL_0):
-            return acs_pgt_info.l0_index;
-        case(PGT_LEVEL_1):
-            return acs_pgt_info.l1_index;
-        case(PGT_LEVEL_2):
-            return acs_pgt_info.l2_index;
-        case(PGT_LEVEL_3):
-            return acs_pgt_info.l3_index;
-        default:
-            return 0;
+    uint64_t *table;
+
+    if (pgt_build.count_only) {
+        pgt_build.pages_needed++;
+        return NULL;
+    }
+
+    if (pgt_build.arena_free) {
+        table = pgt_build.arena_next;
+        pgt_build.arena_next += page_size / sizeof(uint64_t);
+        pgt_build.arena_free--;
+    } else {
+        table = val_memory_alloc_pages(1);
+        if (table == NULL) {
+            val_print(ACS_PRINT_ERR, "\n       pgt_alloc_table: page allocation failed     ", 0);
+            return NULL;
+        }
+        val_memory_set(table, page_size, 0);
     }
+
+    pgt_build.stats.pages_used++;
+    return table;
 }
 
-static
-void increment_pgt_index(uint32_t level, uint32_t max_index)
+/**
+  @brief  Allocates the arena for the table pages counted by the sizing walk,
+          and zeroes it with a single call.
+
+  @param  num_pages  Number of table pages
+
+  @return None. Tables are allocated one by one if there is no arena.
+**/
+static void pgt_alloc_arena(uint32_t num_pages)
 {
-    switch (level)
-    {
-        case(PGT_LEVEL_1):
-            if (acs_pgt_info.l1_index == (max_index - 1)) {
-                acs_pgt_info.l1_index = 0;
-                acs_pgt_info.l0_index++;
-            }
-            break;
+    uint32_t slot;
 
-        case(PGT_LEVEL_2):
-            if (acs_pgt_info.l2_index == (max_index - 1)) {
-                acs_pgt_info.l2_index = 0;
-                acs_pgt_info.l1_index++;
-            }
+    for (slot = 0; slot < PGT_ARENA_MAX; slot++)
+        if (pgt_arena[slot].base == NULL)
             break;
 
-        case(PGT_LEVEL_3):
-            if (acs_pgt_info.l3_index == (max_index - 1)) {
-                acs_pgt_info.l3_index = 0;
-                acs_pgt_info.l2_index++;
-            } else
-                acs_pgt_info.l3_index++;
-            break;
-        default:
-            break;
-    }
-}
+    if (slot == PGT_ARENA_MAX)
+        return;
 
-static
-uint32_t get_entries_per_level(uint32_t page_size)
-{
-    switch (page_size)
-    {
-        case(PAGE_SIZE_4K):   //4kb granule
-            return MAX_ENTRIES_4K;
-        case(PAGE_SIZE_16K):  //16kb granule
-            return MAX_ENTRIES_16K;
-        case(PAGE_SIZE_64K):  //64kb granule
-            return MAX_ENTRIES_64K;
-        default:
-            val_print(ACS_PRINT_ERR, "\n       %llx granularity not supported.", page_size);
-            return 0;
-    }
+    pgt_build.arena_next = val_memory_alloc_pages(num_pages);
+    if (pgt_build.arena_next == NULL)
+        return;
+
+    val_memory_set(pgt_build.arena_next, num_pages * page_size, 0);
+    pgt_arena[slot].root = 0;
+    pgt_arena[slot].base = pgt_build.arena_next;
+    pgt_arena[slot].num_pages = num_pages;
+    pgt_build.arena_slot = slot;
+    pgt_build.arena_free = num_pages;
 }
 
-static
-uint64_t get_block_size(uint32_t level)
-{
-    uint32_t entries = get_entries_per_level(page_size);
-    switch (level)
-    {
-        case(PGT_LEVEL_0):  // For L0 table translation
-            if (page_size == PAGE_SIZE_4K)
-                return (uint64_t)(page_size * entries * entries * entries);
-            else if (page_size == PAGE_SIZE_16K)
-                return (uint64_t)(page_size * entries * entries * 2); // only 2 lookup tables in L0
-            else {
-                val_print(ACS_PRINT_ERR, "\n       L0 tables not supported for page size %llx",
-                                                                                        page_size);
-                return 0;
-            }
+/**
+  @brief  Frees a table page, unless it belongs to an arena of the root,
+          which is freed as a whole.
 
-        case(PGT_LEVEL_1):  // For L1 table translation
-            if (page_size == PAGE_SIZE_4K || page_size == PAGE_SIZE_16K)
-                return (uint64_t)(page_size * entries * entries);
-            else
-                return (uint64_t)(page_size * entries * 64); // 64 Lookup tables in L1 (64KB Gran)
+  @param  root   Physical base of the root table
+  @param  table  Virtual address of the table page
 
-        case(PGT_LEVEL_2):  // For L2 table translation
-            return (uint64_t)(page_size * entries);
-        case(PGT_LEVEL_3):  // For L3 table translation
-            return (uint64_t)(page_size);
-        default:
-            return 0;
+  @return None
+**/
+static void pgt_free_table(uint64_t root, uint64_t *table)
+{
+    uint32_t slot;
+
+    for (slot = 0; slot < PGT_ARENA_MAX; slot++) {
+        if ((pgt_arena[slot].base != NULL) && (pgt_arena[slot].root == root) &&
+            (table >= pgt_arena[slot].base) &&
+            (table < pgt_arena[slot].base +
+                     ((uint64_t)pgt_arena[slot].num_pages * page_size / sizeof(uint64_t))))
+            return;
     }
+
+    val_memory_free_pages(table, 1);
 }
 
 /**
-  @brief  This API fills the translation table
+  @brief  This API fills the translation table for an input range that lies
+          within this table. An entry fully covered by the range, with input
+          and output addresses aligned to its size, is written as a block.
+          Otherwise the range of the entry is filled in the next level table.
+          In the sizing walk nothing is written, tables that would be
+          allocated are counted and walked as empty tables.
 
   @param  tt_desc   Translation Table Descriptor
   @param  mem_desc  Memory Descriptor
@@ -172,106 +168,93 @@ static
 uint32_t fill_translation_table(tt_descriptor_t tt_desc, memory_region_descriptor_t *mem_desc)
 {
     uint64_t block_size = 0x1ull << tt_desc.size_log2;
-    uint64_t input_address, output_address, filled_tables, table_index, max_allowed_mem;
+    uint64_t input_address = tt_desc.input_base;
+    uint64_t output_address = tt_desc.output_base;
+    uint64_t entry_top, table_index, num_pages, page_desc, i;
     uint64_t *tt_base_next_level, *table_desc;
+    uint32_t new_table;
     tt_descriptor_t tt_desc_next_level;
 
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.level: %d     ", tt_desc.level);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.input_base: 0x%llx     ", tt_desc.input_base);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.input_top: 0x%llx     ", tt_desc.input_top);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.output_base: 0x%llx     ", tt_desc.output_base);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.size_log2: %d     ", tt_desc.size_log2);
-    val_print(PGT_DEBUG_LEVEL, "\n       tt_desc.nbits: %d     ", tt_desc.nbits);
+    table_index = (input_address >> tt_desc.size_log2) & ((0x1ull << tt_desc.nbits) - 1);
 
-    if (!is_values_init) {
-        setup_acs_pgt_values();
-        is_values_init = 1;
+    if (tt_desc.level == 3)
+    {
+        if (pgt_build.count_only)
+            return 0;
+
+        //Create level 3 page descriptor entries
+        num_pages = ((tt_desc.input_top - input_address) >> tt_desc.size_log2) + 1;
+        page_desc = PGT_ENTRY_PAGE_MASK | PGT_ENTRY_VALID_MASK;
+        page_desc |= (output_address & ~(uint64_t)(page_size - 1));
+        page_desc |= mem_desc->attributes;
+        for (i = 0; i < num_pages; i++, page_desc += page_size)
+            tt_desc.tt_base[table_index + i] = page_desc;
+
+        pgt_build.stats.entries_written += num_pages;
+        return 0;
     }
 
-    for (input_address = tt_desc.input_base, output_address = tt_desc.output_base;
-         input_address < tt_desc.input_top;
-         input_address += (block_size - offset), output_address += (block_size - offset))
+    while (1)
     {
-        table_index = input_address >> tt_desc.size_log2 & ((0x1ull << tt_desc.nbits) - 1);
-        table_desc = &tt_desc.tt_base[table_index];
-
-        val_print(PGT_DEBUG_LEVEL, "\n       table_index = %d     ", table_index);
+        entry_top = input_address | (block_size - 1);
+        if (entry_top > tt_desc.input_top)
+            entry_top = tt_desc.input_top;
 
-        if (tt_desc.level == 3)
-        {
-            //Create level 3 page descriptor entry
-            *table_desc = PGT_ENTRY_PAGE_MASK | PGT_ENTRY_VALID_MASK;
-            *table_desc |= (output_address & ~(uint64_t)(page_size - 1));
-            *table_desc |= mem_desc->attributes;
-            val_print(PGT_DEBUG_LEVEL, "\n       page_descriptor = 0x%llx     ", *table_desc);
-            /* Keep a count of number of L3 tables filled. If the number exceedes the limit, move
-               to next L2 table and continue.  */
-            increment_pgt_index(tt_desc.level, get_entries_per_level(page_size));
-            offset = 0;
-            continue;
-        }
+        table_index = (input_address >> tt_desc.size_log2) & ((0x1ull << tt_desc.nbits) - 1);
+        table_desc = (tt_desc.tt_base != NULL) ? &tt_desc.tt_base[table_index] : NULL;
 
         //Are input and output addresses eligible for being described via block descriptor?
         if ((input_address & (block_size - 1)) == 0 &&
              (output_address & (block_size - 1)) == 0 &&
-             tt_desc.input_top >= (input_address + block_size - 1)) {
-            //Create a block descriptor entry
-            *table_desc = PGT_ENTRY_BLOCK_MASK | PGT_ENTRY_VALID_MASK;
-            *table_desc |= (output_address & ~(block_size - 1));
-            *table_desc |= mem_desc->attributes;
-            val_print(PGT_DEBUG_LEVEL, "\n       block_descriptor = 0x%llx     ", *table_desc);
-            increment_pgt_index(tt_desc.level, get_entries_per_level(page_size));
-            offset = 0;
-            continue;
-        }
-        /*
-        If there's no descriptor populated at current index of this page_table, or
-        If there's a block descriptor, allocate new page, else use the already populated address.
-        Block descriptor info will be overwritten in case its there.
-        */
-        if (*table_desc == 0 || IS_PGT_ENTRY_BLOCK(*table_desc))
-        {
-            tt_base_next_level = val_memory_alloc_pages(1);
-            if (tt_base_next_level == NULL)
-            {
-                val_print(ACS_PRINT_ERR,
-                "\n       fill_translation_table: page allocation failed     ",
-                0);
-                return ACS_STATUS_ERR;
+             (entry_top - input_address) == (block_size - 1)) {
+            if (!pgt_build.count_only) {
+                //Create a block descriptor entry
+                *table_desc = PGT_ENTRY_BLOCK_MASK | PGT_ENTRY_VALID_MASK;
+                *table_desc |= (output_address & ~(block_size - 1));
+                *table_desc |= mem_desc->attributes;
+                pgt_build.stats.entries_written++;
+                pgt_build.stats.block_entries++;
             }
-            val_memory_set(tt_base_next_level, page_size, 0);
-        }
-        else
-            tt_base_next_level = val_memory_phys_to_virt(*table_desc & pgt_addr_mask);
-
-        tt_desc_next_level.tt_base    = tt_base_next_level;
-        tt_desc_next_level.input_base = input_address;
-        filled_tables                 = get_pgt_index(tt_desc.level + 1);
-        offset                        = filled_tables * get_block_size(tt_desc.level + 1);
-
-        val_print(PGT_DEBUG_LEVEL, "       filled_tables in next level = 0x%llx", filled_tables);
-        val_print(PGT_DEBUG_LEVEL, "       offset = 0x%llx", offset);
-
-        // Calculate the maximum allowed mem addr that can be mapped for the L0/L1/L2 table.
-        // This prevents overwriting page tables.
-        max_allowed_mem                = input_address + block_size - offset - 1;
-        tt_desc_next_level.input_top   = get_min(tt_desc.input_top, max_allowed_mem);
-        tt_desc_next_level.output_base = output_address;
-        tt_desc_next_level.level       = tt_desc.level + 1;
-        tt_desc_next_level.size_log2   = tt_desc.size_log2 - bits_per_level;
-        tt_desc_next_level.nbits       = bits_per_level;
-        increment_pgt_index(tt_desc.level, get_entries_per_level(page_size));
-
-        if (fill_translation_table(tt_desc_next_level, mem_desc))
-        {
-            val_memory_free_pages(tt_base_next_level, 1);
-            return ACS_STATUS_ERR;
+        } else {
+            /*
+            If there's no descriptor populated at current index of this page_table, or
+            If there's a block descriptor, allocate new page, else use the already populated address.
+            Block descriptor info will be overwritten in case its there.
+            */
+            new_table = (table_desc == NULL) || (*table_desc == 0) || IS_PGT_ENTRY_BLOCK(*table_desc);
+            if (new_table) {
+                tt_base_next_level = pgt_alloc_table();
+                if ((tt_base_next_level == NULL) && !pgt_build.count_only)
+                    return ACS_STATUS_ERR;
+            }
+            else
+                tt_base_next_level = val_memory_phys_to_virt(*table_desc & pgt_addr_mask);
+
+            /* Link the new table first, so that val_pgt_destroy finds it if filling fails */
+            if (new_table && !pgt_build.count_only) {
+                *table_desc = PGT_ENTRY_TABLE_MASK | PGT_ENTRY_VALID_MASK;
+                *table_desc |= (uint64_t)val_memory_virt_to_phys(tt_base_next_level) &
+                               ~(uint64_t)(page_size - 1);
+                pgt_build.stats.entries_written++;
+            }
+
+            tt_desc_next_level.tt_base     = tt_base_next_level;
+            tt_desc_next_level.input_base  = input_address;
+            tt_desc_next_level.input_top   = entry_top;
+            tt_desc_next_level.output_base = output_address;
+            tt_desc_next_level.level       = tt_desc.level + 1;
+            tt_desc_next_level.size_log2   = tt_desc.size_log2 - bits_per_level;
+            tt_desc_next_level.nbits       = bits_per_level;
+
+            if (fill_translation_table(tt_desc_next_level, mem_desc))
+                return ACS_STATUS_ERR;
         }
 
-        *table_desc = PGT_ENTRY_TABLE_MASK | PGT_ENTRY_VALID_MASK;
-        *table_desc |= (uint64_t)val_memory_virt_to_phys(tt_base_next_level) &
-                       ~(uint64_t)(page_size - 1);
-        val_print(PGT_DEBUG_LEVEL, "\n      table_descriptor = 0x%llx     ", *table_desc);
+        if (entry_top == tt_desc.input_top)
+            break;
+
+        output_address += entry_top - input_address + 1;
+        input_address = entry_top + 1;
     }
     return 0;
 }
@@ -300,6 +283,8 @@ static uint32_t log2_page_size(uint64_t size)
   @brief Create stage 1 or stage 2 page table, with given memory addresses and attributes
          Note: This API updates existing translation table if pgt_desc->pgt_base is not NULL
                else it created new table and updated pgt_desc->pgt_base with the address.
+         The regions are first walked without writing to count the table pages
+         they need, which are then allocated as one arena and zeroed at once.
   @param mem_desc - Array of memory addresses and attributes needed for page table creation.
   @param pgt_desc - Data structure for output page table base and input translation attributes.
   @return status
@@ -307,10 +292,16 @@ static uint32_t log2_page_size(uint64_t size)
 uint32_t val_pgt_create(memory_region_descriptor_t *mem_desc, pgt_descriptor_t *pgt_desc)
 {
     uint64_t *tt_base;
+    uint64_t start;
     tt_descriptor_t tt_desc;
-    uint32_t num_pgt_levels, page_size_log2;
+    pgt_descriptor_t failed_pgt_desc;
+    uint32_t num_pgt_levels, page_size_log2, pass;
     memory_region_descriptor_t *mem_desc_iter;
 
+    start = val_timer_get_counter();
+    val_memory_set(&pgt_build, sizeof(pgt_build), 0);
+    pgt_build.arena_slot = PGT_ARENA_MAX;
+
     page_size = val_memory_page_size();
     page_size_log2 = log2_page_size(page_size);
     bits_per_level = page_size_log2 - 3;
@@ -319,40 +310,25 @@ uint32_t val_pgt_create(memory_region_descriptor_t *mem_desc, pgt_descriptor_t *
     val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_create: nbits_per_level = %d    ", bits_per_level);
     val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_create: page_size_log2 = %d     ", page_size_log2);
 
-    /* check whether input page descriptor has base addr of translation table
-       to use. If the pgt_base member is NULL allocate a page to create a new
-       table, else update existing translation table */
-    if (pgt_desc->pgt_base == (uint64_t) NULL) {
-        tt_base = (uint64_t *) val_memory_alloc_pages(1);
-        if (tt_base == NULL) {
-            val_print(ACS_PRINT_ERR, "\n      val_pgt_create: page allocation failed     ", 0);
-            return ACS_STATUS_ERR;
-        }
-        val_memory_set(tt_base, page_size, 0);
-    }
-    else
-        tt_base = (uint64_t *) pgt_desc->pgt_base;
-
-    tt_desc.tt_base = tt_base;
     pgt_addr_mask = ((0x1ull << (pgt_desc->ias - page_size_log2)) - 1) << page_size_log2;
 
     for (mem_desc_iter = mem_desc; mem_desc_iter->length != 0; ++mem_desc_iter)
     {
         val_print(PGT_DEBUG_LEVEL,
                   "      val_pgt_create: input addr = 0x%x     ",
-                  mem_desc->virtual_address);
+                  mem_desc_iter->virtual_address);
         val_print(PGT_DEBUG_LEVEL,
                   "      val_pgt_create: output addr = 0x%x     ",
-                  mem_desc->physical_address);
-        val_print(PGT_DEBUG_LEVEL, "      val_pgt_create: length = 0x%x\n     ", mem_desc->length);
-        if ((mem_desc->virtual_address & (uint64_t)(page_size - 1)) != 0 ||
-            (mem_desc->physical_address & (uint64_t)(page_size - 1)) != 0)
+                  mem_desc_iter->physical_address);
+        val_print(PGT_DEBUG_LEVEL, "      val_pgt_create: length = 0x%x\n     ", mem_desc_iter->length);
+        if ((mem_desc_iter->virtual_address & (uint64_t)(page_size - 1)) != 0 ||
+            (mem_desc_iter->physical_address & (uint64_t)(page_size - 1)) != 0)
             {
                 val_print(ACS_PRINT_ERR, "\n       val_pgt_create: addr alignment err     ", 0);
                 return ACS_STATUS_ERR;
             }
 
-        if (mem_desc->physical_address >= (0x1ull << pgt_desc->oas))
+        if (mem_desc_iter->physical_address >= (0x1ull << pgt_desc->oas))
         {
             val_print(ACS_PRINT_ERR,
                       "\n       val_pgt_create: output address size error     ",
@@ -360,34 +336,85 @@ uint32_t val_pgt_create(memory_region_descriptor_t *mem_desc, pgt_descriptor_t *
             return ACS_STATUS_ERR;
         }
 
-        if (mem_desc->virtual_address >= (0x1ull << pgt_desc->ias))
+        if (mem_desc_iter->virtual_address >= (0x1ull << pgt_desc->ias))
         {
             val_print(ACS_PRINT_WARN,
                       "\n       val_pgt_create: input address size error, "
                       "truncating to %d-bits     ",
                       pgt_desc->ias);
-            mem_desc->virtual_address &= ((0x1ull << pgt_desc->ias) - 1);
+            mem_desc_iter->virtual_address &= ((0x1ull << pgt_desc->ias) - 1);
+        }
+    }
+
+    /* Pass 0 sizes the arena, pass 1 fills the tables */
+    for (pass = 0; pass < 2; pass++)
+    {
+        pgt_build.count_only = (pass == 0);
+
+        /* check whether input page descriptor has base addr of translation table
+           to use. If the pgt_base member is NULL allocate a page to create a new
+           table, else update existing translation table */
+        if (pgt_desc->pgt_base == (uint64_t) NULL) {
+            tt_base = pgt_alloc_table();
+            if ((tt_base == NULL) && !pgt_build.count_only) {
+                val_print(ACS_PRINT_ERR, "\n      val_pgt_create: page allocation failed     ", 0);
+                return ACS_STATUS_ERR;
+            }
         }
+        else
+            tt_base = (uint64_t *) pgt_desc->pgt_base;
 
-        tt_desc.input_base = mem_desc->virtual_address & ((0x1ull << pgt_desc->ias) - 1);
-        tt_desc.input_top = tt_desc.input_base + mem_desc->length - 1;
-        tt_desc.output_base = mem_desc->physical_address & ((0x1ull << pgt_desc->oas) - 1);
-        tt_desc.level = 4 - num_pgt_levels;
-        tt_desc.size_log2 = (num_pgt_levels - 1) * bits_per_level + page_size_log2;
-        tt_desc.nbits = pgt_desc->ias - tt_desc.size_log2;
+        if (!pgt_build.count_only && (pgt_build.arena_slot != PGT_ARENA_MAX))
+            pgt_arena[pgt_build.arena_slot].root = (uint64_t)val_memory_virt_to_phys(tt_base);
 
-        if (fill_translation_table(tt_desc, mem_desc))
+        tt_desc.tt_base = tt_base;
+        for (mem_desc_iter = mem_desc; mem_desc_iter->length != 0; ++mem_desc_iter)
         {
-            val_memory_free_pages(tt_base, 1);
-            return ACS_STATUS_ERR;
+            tt_desc.input_base = mem_desc_iter->virtual_address & ((0x1ull << pgt_desc->ias) - 1);
+            tt_desc.input_top = tt_desc.input_base + mem_desc_iter->length - 1;
+            tt_desc.output_base = mem_desc_iter->physical_address & ((0x1ull << pgt_desc->oas) - 1);
+            tt_desc.level = 4 - num_pgt_levels;
+            tt_desc.size_log2 = (num_pgt_levels - 1) * bits_per_level + page_size_log2;
+            tt_desc.nbits = pgt_desc->ias - tt_desc.size_log2;
+
+            if (fill_translation_table(tt_desc, mem_desc_iter))
+            {
+                /* Free the tables of a new translation table, an existing one keeps them */
+                if (pgt_desc->pgt_base == (uint64_t) NULL) {
+                    failed_pgt_desc = *pgt_desc;
+                    failed_pgt_desc.pgt_base = (uint64_t)val_memory_virt_to_phys(tt_base);
+                    val_pgt_destroy(failed_pgt_desc);
+                }
+                return ACS_STATUS_ERR;
+            }
         }
+
+        if (pgt_build.count_only && pgt_build.pages_needed)
+            pgt_alloc_arena(pgt_build.pages_needed);
     }
 
     pgt_desc->pgt_base = (uint64_t)val_memory_virt_to_phys(tt_base);
 
+    pgt_build.stats.time_us = val_timer_ticks_to_us(val_timer_get_counter() - start);
+    pgt_last_stats = pgt_build.stats;
+    val_print(PGT_DEBUG_LEVEL, "\n       val_pgt_create: table pages = %d", pgt_last_stats.pages_used);
+    val_print(PGT_DEBUG_LEVEL, " entries = %ld", pgt_last_stats.entries_written);
+    val_print(PGT_DEBUG_LEVEL, " blocks = %ld", pgt_last_stats.block_entries);
+    val_print(PGT_DEBUG_LEVEL, " time (us) = %ld\n", pgt_last_stats.time_us);
+
     return 0;
 }
 
+/**
+  @brief Returns the statistics of the last successful val_pgt_create call.
+  @param stats - Table pages added, descriptors written and time taken.
+  @return None
+**/
+void val_pgt_get_stats(pgt_stats_t *stats)
+{
+    *stats = pgt_last_stats;
+}
+
 /**
   @brief Get attributes of a page corresponding to a given virtual address.
   @param pgt_desc - page table base and translation attributes.
@@ -463,7 +490,7 @@ uint64_t val_pgt_get_attributes(pgt_descriptor_t pgt_desc, uint64_t virtual_addr
 
   @return 0 if Success
 **/
-static void free_translation_table(uint64_t *tt_base, uint32_t bits_at_this_level,
+static void free_translation_table(uint64_t root, uint64_t *tt_base, uint32_t bits_at_this_level,
                                    uint32_t this_level)
 {
     uint32_t index;
@@ -480,11 +507,8 @@ static void free_translation_table(uint64_t *tt_base, uint32_t bits_at_this_leve
             tt_base_next_virt = val_memory_phys_to_virt((tt_base[index] & pgt_addr_mask));
             if (tt_base_next_virt == NULL)
                 continue;
-            free_translation_table(tt_base_next_virt, bits_per_level, this_level+1);
-            val_print(PGT_DEBUG_LEVEL,
-                      "\n       free_translation_table: tt_base_next_virt = %llx     ",
-                      (uint64_t)tt_base_next_virt);
-            val_memory_free_pages(tt_base_next_virt, 1);
+            free_translation_table(root, tt_base_next_virt, bits_per_level, this_level+1);
+            pgt_free_table(root, tt_base_next_virt);
         }
     }
 }
@@ -496,7 +520,7 @@ static void free_translation_table(uint64_t *tt_base, uint32_t bits_at_this_leve
 **/
 void val_pgt_destroy(pgt_descriptor_t pgt_desc)
 {
-    uint32_t page_size_log2, num_pgt_levels;
+    uint32_t page_size_log2, num_pgt_levels, slot;
     uint64_t *pgt_base_virt = val_memory_phys_to_virt(pgt_desc.pgt_base);
 
     if (!pgt_desc.pgt_base)
@@ -509,8 +533,16 @@ void val_pgt_destroy(pgt_descriptor_t pgt_desc)
     pgt_addr_mask = ((0x1ull << (pgt_desc.ias - page_size_log2)) - 1) << page_size_log2;
     num_pgt_levels = (pgt_desc.ias - page_size_log2 + bits_per_level - 1)/bits_per_level;
 
-    free_translation_table(pgt_base_virt,
+    free_translation_table(pgt_desc.pgt_base, pgt_base_virt,
                            pgt_desc.ias - ((num_pgt_levels - 1) * bits_per_level + page_size_log2),
                            4 - num_pgt_levels);
-    val_memory_free_pages(pgt_base_virt, 1);
+    pgt_free_table(pgt_desc.pgt_base, pgt_base_virt);
+
+    /* The arenas go last, the walk above reads tables that are in them */
+    for (slot = 0; slot < PGT_ARENA_MAX; slot++) {
+        if ((pgt_arena[slot].base != NULL) && (pgt_arena[slot].root == pgt_desc.pgt_base)) {
+            val_memory_free_pages(pgt_arena[slot].base, pgt_arena[slot].num_pages);
+            pgt_arena[slot].base = NULL;
+        }
+    }
 }
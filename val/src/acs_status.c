@@ -17,9 +17,34 @@
 
 #include "include/bsa_acs_val.h"
 #include "include/bsa_acs_common.h"
+#include "include/val_interface.h"
 
 extern uint32_t g_override_skip;
 
+/* Structured result records are built in a line buffer and written out
+   through pal_result_write whenever it fills up */
+#define VAL_RESULT_LINE_MAX  512
+
+typedef struct {
+  uint32_t stream;
+  uint32_t len;
+  char8_t  data[VAL_RESULT_LINE_MAX];
+} VAL_RESULT_LINE_t;
+
+static uint32_t g_result_test_num;
+static char8_t  *g_result_desc;
+static uint32_t g_result_junit_open;
+
+/* Module names by test number / 100 */
+static char8_t *g_module_name[] = {
+  "HART", "Memory", "IIC", "SMMU", "Timer", "Wakeup", "Peripheral",
+  "Watchdog", "PCIe", "Exerciser", "QoS", "MNG", "IOMMU"
+};
+
+/* Fails to build if VAL_NUM_MODULE and g_module_name drift apart */
+typedef char val_module_name_check[((sizeof(g_module_name) / sizeof(g_module_name[0])) ==
+                                    VAL_NUM_MODULE) ? 1 : -1];
+
 /**
   @brief  Parse the input status and print the appropriate information to console
           1. Caller       - Application layer
@@ -57,6 +82,7 @@ val_report_status(uint32_t index, uint32_t status, char8_t *ruleid)
                                                          status & STATUS_MASK);
         }
         val_print(ACS_PRINT_ERR, "     : Result:  FAIL\n", 0);
+        val_print_flush();
     }
     else
       if (IS_TEST_SKIP(status)) {
@@ -93,8 +119,7 @@ val_set_status(uint32_t index, uint32_t status)
 {
   volatile VAL_SHARED_MEM_t *mem;
 
-  mem = (VAL_SHARED_MEM_t *) pal_mem_get_shared_addr();
-  mem = mem + index;
+  mem = val_get_shared_mem_entry(index);
   mem->status = status;
 
   val_data_cache_ops_by_va((addr_t)&mem->status, CLEAN_AND_INVALIDATE);
@@ -112,8 +137,7 @@ val_get_status(uint32_t index)
 {
   volatile VAL_SHARED_MEM_t *mem;
 
-  mem = (VAL_SHARED_MEM_t *) pal_mem_get_shared_addr();
-  mem = mem + index;
+  mem = val_get_shared_mem_entry(index);
 
   val_data_cache_ops_by_va((addr_t)&mem->status, INVALIDATE);
 
@@ -121,3 +145,333 @@ val_get_status(uint32_t index)
 
 }
 
+/**
+  @brief  Return the name of the module a test belongs to
+
+  @param  test_num  unique test number
+
+  @return Module name, "Unknown" for a test number outside of all modules
+**/
+char8_t *
+val_get_module_name(uint32_t test_num)
+{
+  if ((test_num / 100) == (ACS_HOST_TEST_NUM_BASE / 100))
+      return "Host";
+
+  if ((test_num / 100) >= VAL_NUM_MODULE)
+      return "Unknown";
+
+  return g_module_name[test_num / 100];
+}
+
+static void
+val_result_line_flush(VAL_RESULT_LINE_t *line)
+{
+  if (line->len)
+      pal_result_write(line->stream, line->data, line->len);
+  line->len = 0;
+}
+
+static void
+val_result_putc(VAL_RESULT_LINE_t *line, char8_t c)
+{
+  if (line->len == VAL_RESULT_LINE_MAX)
+      val_result_line_flush(line);
+  line->data[line->len++] = c;
+}
+
+static void
+val_result_puts(VAL_RESULT_LINE_t *line, char8_t *str)
+{
+  while (*str)
+      val_result_putc(line, *str++);
+}
+
+/**
+  @brief  Append a decimal number, zero padded to at least min_digits
+
+  @param  line        line buffer
+  @param  value       number to append
+  @param  min_digits  minimum number of digits
+
+  @return None
+**/
+static void
+val_result_putu(VAL_RESULT_LINE_t *line, uint64_t value, uint32_t min_digits)
+{
+  char8_t  digits[20];
+  uint32_t n = 0;
+
+  do {
+      digits[n++] = '0' + (value % 10);
+      value /= 10;
+  } while (value && (n < sizeof(digits)));
+
+  while (n < min_digits && (n < sizeof(digits)))
+      digits[n++] = '0';
+
+  while (n)
+      val_result_putc(line, digits[--n]);
+}
+
+/**
+  @brief  Append a string escaped for the stream of the line, as a JSON
+          string body or an XML attribute value. Trailing blanks, which
+          pad the test descriptions for the console, are dropped.
+
+  @param  line  line buffer
+  @param  str   string to append, NULL appends nothing
+
+  @return None
+**/
+static void
+val_result_put_escaped(VAL_RESULT_LINE_t *line, char8_t *str)
+{
+  uint32_t i, len = 0;
+  char8_t  c;
+
+  if (str == NULL)
+      return;
+
+  for (i = 0; str[i]; i++)
+      if (str[i] != ' ')
+          len = i + 1;
+
+  for (i = 0; i < len; i++) {
+      c = str[i];
+      if ((c == '\n') || (c == '\r') || (c == '\t'))
+          c = ' ';
+
+      if (line->stream == ACS_RESULT_JSON) {
+          if ((c == '"') || (c == '\\'))
+              val_result_putc(line, '\\');
+          if ((uint8_t)c >= 0x20)
+              val_result_putc(line, c);
+          continue;
+      }
+
+      switch (c) {
+      case '&':
+          val_result_puts(line, "&amp;");
+          break;
+      case '<':
+          val_result_puts(line, "&lt;");
+          break;
+      case '>':
+          val_result_puts(line, "&gt;");
+          break;
+      case '"':
+          val_result_puts(line, "&quot;");
+          break;
+      default:
+          if ((uint8_t)c >= 0x20)
+              val_result_putc(line, c);
+      }
+  }
+}
+
+static char8_t *
+val_result_status_name(uint32_t status)
+{
+  if (IS_TEST_PASS(status))
+      return "PASS";
+  if (IS_TEST_FAIL(status))
+      return "FAIL";
+  if (IS_TEST_SKIP(status))
+      return "SKIP";
+  if (IS_RESULT_PENDING(status))
+      return "PENDING";
+
+  return "UNKNOWN";
+}
+
+static void
+val_result_junit_header(void)
+{
+  VAL_RESULT_LINE_t line = { .stream = ACS_RESULT_JUNIT, .len = 0 };
+
+  if (g_result_junit_open)
+      return;
+
+  val_result_puts(&line, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+  val_result_puts(&line, "<testsuites>\n<testsuite name=\"BSA ACS\">\n");
+  val_result_line_flush(&line);
+  g_result_junit_open = 1;
+}
+
+/**
+  @brief  Remember the description of the test which is starting, for
+          its structured result record
+          1. Caller       - val_initialize_test
+          2. Prerequisite - None
+
+  @param  test_num  unique test number
+  @param  desc      test description
+
+  @return None
+**/
+void
+val_result_begin_test(uint32_t test_num, char8_t *desc)
+{
+  g_result_test_num = test_num;
+  g_result_desc = desc;
+}
+
+/**
+  @brief  Write the structured result record of a completed test to every
+          enabled result stream: a JSON line, and a JUnit XML testcase.
+          The record holds the test number, rule ID, overall status and
+          failure checkpoint, the status of every HART and the elapsed
+          time.
+          1. Caller       - val_check_for_error
+          2. Prerequisite - val_set_status
+
+  @param  test_num    unique test number
+  @param  ruleid      rule ID of the test, may be NULL
+  @param  num_hart    number of HART the test ran on
+  @param  status      overall status of the test
+  @param  elapsed_us  time from test start to report
+
+  @return None
+**/
+void
+val_result_write_test(uint32_t test_num, char8_t *ruleid, uint32_t num_hart,
+                      uint32_t status, uint64_t elapsed_us)
+{
+  uint32_t i, first, last;
+  uint32_t hart_status;
+  char8_t  *desc;
+  VAL_RESULT_LINE_t line;
+
+  desc = (test_num == g_result_test_num) ? g_result_desc : NULL;
+
+  /* A single HART test runs on the primary HART, not on HART 0 */
+  first = 0;
+  last = num_hart;
+  if (num_hart == 1) {
+      first = val_hart_get_index_mpid(val_hart_get_mpid());
+      last = first + 1;
+  }
+
+  if (pal_result_stream_enabled(ACS_RESULT_JSON)) {
+      line.stream = ACS_RESULT_JSON;
+      line.len = 0;
+
+      val_result_puts(&line, "{\"test\":");
+      val_result_putu(&line, test_num, 1);
+      val_result_puts(&line, ",\"module\":\"");
+      val_result_puts(&line, val_get_module_name(test_num));
+      val_result_puts(&line, "\",\"rule\":");
+      if (ruleid) {
+          val_result_putc(&line, '"');
+          val_result_put_escaped(&line, ruleid);
+          val_result_putc(&line, '"');
+      } else {
+          val_result_puts(&line, "null");
+      }
+      val_result_puts(&line, ",\"desc\":\"");
+      val_result_put_escaped(&line, desc);
+      val_result_puts(&line, "\",\"status\":\"");
+      val_result_puts(&line, val_result_status_name(status));
+      val_result_puts(&line, "\",\"checkpoint\":");
+      val_result_putu(&line, status & STATUS_MASK, 1);
+      val_result_puts(&line, ",\"elapsed_us\":");
+      val_result_putu(&line, elapsed_us, 1);
+      val_result_puts(&line, ",\"harts\":[");
+      for (i = first; i < last; i++) {
+          hart_status = val_get_status(i);
+          if (i != first)
+              val_result_putc(&line, ',');
+          val_result_puts(&line, "{\"hart\":");
+          val_result_putu(&line, i, 1);
+          val_result_puts(&line, ",\"status\":\"");
+          val_result_puts(&line, val_result_status_name(hart_status));
+          val_result_puts(&line, "\",\"checkpoint\":");
+          val_result_putu(&line, hart_status & STATUS_MASK, 1);
+          val_result_putc(&line, '}');
+      }
+      val_result_puts(&line, "]}\n");
+      val_result_line_flush(&line);
+  }
+
+  if (pal_result_stream_enabled(ACS_RESULT_JUNIT)) {
+      val_result_junit_header();
+
+      line.stream = ACS_RESULT_JUNIT;
+      line.len = 0;
+
+      val_result_puts(&line, "<testcase classname=\"");
+      val_result_puts(&line, val_get_module_name(test_num));
+      val_result_puts(&line, "\" name=\"");
+      val_result_putu(&line, test_num, 1);
+      if (desc) {
+          val_result_puts(&line, " : ");
+          val_result_put_escaped(&line, desc);
+      }
+      val_result_puts(&line, "\" time=\"");
+      val_result_putu(&line, elapsed_us / 1000000, 1);
+      val_result_putc(&line, '.');
+      val_result_putu(&line, elapsed_us % 1000000, 6);
+      val_result_puts(&line, "\"");
+
+      if (IS_TEST_PASS(status)) {
+          val_result_puts(&line, "/>\n");
+      } else {
+          val_result_puts(&line, ">\n");
+          val_result_puts(&line, IS_TEST_SKIP(status) ? "<skipped" : "<failure");
+          val_result_puts(&line, " message=\"");
+          if (ruleid) {
+              val_result_put_escaped(&line, ruleid);
+              val_result_putc(&line, ' ');
+          }
+          val_result_puts(&line, "checkpoint ");
+          val_result_putu(&line, status & STATUS_MASK, 1);
+          val_result_puts(&line, "\"/>\n");
+
+          /* Per-HART results only matter when something did not pass */
+          if (!IS_TEST_SKIP(status)) {
+              val_result_puts(&line, "<system-out>");
+              for (i = first; i < last; i++) {
+                  hart_status = val_get_status(i);
+                  if (IS_TEST_PASS(hart_status))
+                      continue;
+                  val_result_puts(&line, "HART ");
+                  val_result_putu(&line, i, 1);
+                  val_result_puts(&line, " ");
+                  val_result_puts(&line, val_result_status_name(hart_status));
+                  val_result_puts(&line, " checkpoint ");
+                  val_result_putu(&line, hart_status & STATUS_MASK, 1);
+                  val_result_putc(&line, '\n');
+              }
+              val_result_puts(&line, "</system-out>\n");
+          }
+          val_result_puts(&line, "</testcase>\n");
+      }
+      val_result_line_flush(&line);
+  }
+}
+
+/**
+  @brief  Complete the structured result streams and write them out. The
+          JUnit XML document is closed, so no record can follow.
+          1. Caller       - Application layer, at the end of the run
+          2. Prerequisite - None
+
+  @param  None
+
+  @return None
+**/
+void
+val_result_close(void)
+{
+  VAL_RESULT_LINE_t line = { .stream = ACS_RESULT_JUNIT, .len = 0 };
+
+  if (pal_result_stream_enabled(ACS_RESULT_JUNIT)) {
+      val_result_junit_header();
+      val_result_puts(&line, "</testsuite>\n</testsuites>\n");
+      val_result_line_flush(&line);
+      g_result_junit_open = 0;
+  }
+
+  pal_result_flush();
+}
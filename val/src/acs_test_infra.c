@@ -18,12 +18,48 @@
 #include "include/bsa_acs_val.h"
 #include "include/bsa_acs_hart.h"
 #include "include/bsa_acs_common.h"
+#include "include/bsa_std_smc.h"
 #include "sys_arch_src/gic/bsa_exception.h"
 
 #include "include/val_interface.h"
 
 uint32_t g_override_skip;
 
+/* Per-HART mailboxes, each aligned and padded to whole cache lines */
+static addr_t   g_shared_mem_base;
+static uint32_t g_shared_mem_stride;
+
+/* Status updates per HART for the mailbox benchmark payload */
+static uint32_t g_mailbox_bench_iter;
+
+/* Per-HART dispatch and completion timestamps for broadcast dispatch */
+#define VAL_INVALID_TIMESTAMP 0xFFFFFFFFFFFFFFFFULL
+static uint64_t *g_dispatch_ts;
+static uint64_t *g_complete_ts;
+
+/* Timing of one test from val_initialize_test to val_check_for_error */
+typedef struct {
+  uint32_t test_num;
+  uint32_t num_hart;
+  uint64_t start;          /* val_initialize_test decided to run the test */
+  uint64_t dispatch;       /* first payload run started */
+  uint64_t run_end;        /* last payload run returned */
+  uint64_t report;         /* val_check_for_error entered */
+  uint64_t payload_ticks;  /* time in the payload on this HART */
+  uint64_t run_ticks;      /* time in val_run_test_payload* */
+  uint64_t slowest_ticks;  /* slowest secondary HART, dispatch to completion */
+  uint32_t slowest_hart;
+} VAL_TEST_PROFILE_t;
+
+static VAL_TEST_PROFILE_t g_test_profile[VAL_PROFILE_MAX_TESTS];
+static uint32_t g_num_profile;
+static uint32_t g_num_profile_dropped;
+static VAL_TEST_PROFILE_t *g_cur_profile;
+
+/* Start of the current test, kept even when its profile record is dropped */
+static uint64_t g_cur_test_start;
+static uint32_t g_cur_test_open;
+
 /**
   @brief  This API calls PAL layer to print a formatted string
           to the output console.
@@ -50,6 +86,128 @@ val_print(uint32_t level, char8_t *string, uint64_t data)
 
 }
 
+/**
+  @brief  This API calls PAL layer to write out any buffered log output.
+          Called at test and module boundaries, on test failure, on timeout and
+          on exit so that the log is not lost if the run stops.
+          1. Caller       - Application layer, VAL
+          2. Prerequisite - None.
+
+  @return        None
+ **/
+void
+val_print_flush(void)
+{
+#ifndef TARGET_BM_BOOT
+  pal_print_flush();
+#endif
+}
+
+/**
+  @brief  Start the profile record of a test that is about to run
+
+  @param test_num   unique test number
+  @param num_hart   the number of HART the test runs on
+
+  @return None
+ **/
+static void
+val_profile_open(uint32_t test_num, uint32_t num_hart)
+{
+  VAL_TEST_PROFILE_t *prof;
+
+  g_cur_profile = NULL;
+  g_cur_test_open = 1;
+  g_cur_test_start = val_timer_get_counter();
+
+  if (g_num_profile >= VAL_PROFILE_MAX_TESTS) {
+      if (!g_num_profile_dropped)
+          val_print(ACS_PRINT_DEBUG, "\n       Test profile full, later tests are not profiled\n", 0);
+      g_num_profile_dropped++;
+      return;
+  }
+
+  prof = &g_test_profile[g_num_profile++];
+  pal_mem_set(prof, sizeof(VAL_TEST_PROFILE_t), 0);
+  prof->test_num = test_num;
+  prof->num_hart = num_hart;
+  prof->start = g_cur_test_start;
+  g_cur_profile = prof;
+}
+
+/**
+  @brief  Add one payload run to the profile record of the current test.
+          Runs outside of a test, such as the benchmarks, are not recorded.
+
+  @param run_start      time the run started
+  @param payload_ticks  time spent in the payload on this HART
+  @param num_hart       the number of HART the payload ran on
+  @param my_index       index of this HART
+  @param broadcast      the per-HART timestamps of a broadcast are valid
+
+  @return None
+ **/
+static void
+val_profile_run(uint64_t run_start, uint64_t payload_ticks, uint32_t num_hart,
+                uint32_t my_index, uint32_t broadcast)
+{
+  uint32_t i;
+  uint64_t latency;
+  VAL_TEST_PROFILE_t *prof = g_cur_profile;
+
+  if (prof == NULL)
+      return;
+
+  if (!prof->dispatch)
+      prof->dispatch = run_start;
+  prof->run_end = val_timer_get_counter();
+  prof->run_ticks += prof->run_end - run_start;
+  prof->payload_ticks += payload_ticks;
+
+  if (!broadcast)
+      return;
+
+  for (i = 0; i < num_hart; i++) {
+      if ((i == my_index) || (g_dispatch_ts[i] == VAL_INVALID_TIMESTAMP) ||
+          (g_complete_ts[i] == VAL_INVALID_TIMESTAMP))
+          continue;
+
+      latency = g_complete_ts[i] - g_dispatch_ts[i];
+      if (latency >= prof->slowest_ticks) {
+          prof->slowest_ticks = latency;
+          prof->slowest_hart = i;
+      }
+  }
+}
+
+/**
+  @brief  Close the profile record of the current test
+
+  @param  None
+
+  @return Ticks from the start of the test, 0 if no test is open. Tests
+          without a profile record are timed too.
+ **/
+static uint64_t
+val_profile_close(void)
+{
+  VAL_TEST_PROFILE_t *prof = g_cur_profile;
+  uint64_t now;
+
+  if (!g_cur_test_open)
+      return 0;
+
+  now = val_timer_get_counter();
+  g_cur_test_open = 0;
+
+  if (prof != NULL) {
+      prof->report = now;
+      g_cur_profile = NULL;
+  }
+
+  return now - g_cur_test_start;
+}
+
 /**
   @brief  This API prints out module header to the output console.
           1. Caller       - Application layer
@@ -95,6 +253,7 @@ val_print_test_end(uint32_t status, char8_t *string)
   }
 
   val_print(ACS_PRINT_TEST, "\n", 0);
+  val_print_flush();
 
 }
 
@@ -260,6 +419,146 @@ val_mmio_write64(addr_t addr, uint64_t data)
   pal_mmio_write64(addr, data);
 }
 
+/* Test selection compiled into one bit per test number, so that checking a
+   test against the -skip, -t and -m lists is a single bit test.
+   g_select_skip        - test numbers on the -skip list.
+   g_select_run         - tests selected by -t, or by -m through their module.
+   g_select_module_skip - modules skipped by a -skip entry that is exactly
+                          the module ID, one bit per module.
+   g_select_module_run  - modules selected by a -m entry that is exactly the
+                          module ID, or holding a test selected by -t. */
+#define VAL_SELECT_WORDS      (VAL_TEST_NUM_MAX / 32)
+#define VAL_MODULE_STRIDE     100
+#define VAL_MODULE_BIT(num)   (1u << ((num) / VAL_MODULE_STRIDE))
+
+static uint32_t g_select_skip[VAL_SELECT_WORDS];
+static uint32_t g_select_run[VAL_SELECT_WORDS];
+static uint32_t g_select_module_skip;
+static uint32_t g_select_module_run;
+static uint32_t g_select_active;
+
+/* One bit per module must fit in g_select_module_skip/run */
+typedef char val_select_module_bits_check[(VAL_TEST_NUM_MAX / VAL_MODULE_STRIDE < 32) ? 1 : -1];
+
+static void
+val_select_set_range(uint32_t *map, uint32_t first, uint32_t last)
+{
+  uint32_t i;
+
+  if (last >= VAL_TEST_NUM_MAX)
+      last = VAL_TEST_NUM_MAX - 1;
+
+  for (i = first; i <= last; i++)
+      map[i / 32] |= (1u << (i % 32));
+}
+
+static uint32_t
+val_select_is_set(uint32_t *map, uint32_t num)
+{
+  if (num >= VAL_TEST_NUM_MAX)
+      return 0;
+
+  return (map[num / 32] >> (num % 32)) & 1;
+}
+
+/**
+  @brief  This API adds a test or module number range to one of the user
+          selection lists. A single number is passed as first == last.
+          Only a single number that is exactly a module ID selects or
+          skips a whole module, a range never does.
+          1. Caller       - Application layer, while parsing the options
+          2. Prerequisite - None.
+
+  @param list   VAL_SELECT_SKIP, VAL_SELECT_TEST or VAL_SELECT_MODULE
+  @param first  first test or module number of the range
+  @param last   last test or module number of the range, inclusive
+
+  @return         ACS_STATUS_ERR  - if the list or the range is invalid
+                  ACS_STATUS_PASS - if the range was added
+ **/
+uint32_t
+val_test_select_add(uint32_t list, uint32_t first, uint32_t last)
+{
+  uint32_t module_id, i;
+
+  if ((first > last) || (last >= VAL_TEST_NUM_MAX))
+      return ACS_STATUS_ERR;
+
+  module_id = ((first == last) && ((first % VAL_MODULE_STRIDE) == 0));
+
+  switch (list) {
+  case VAL_SELECT_SKIP:
+      if (module_id)
+          g_select_module_skip |= VAL_MODULE_BIT(first);
+      val_select_set_range(g_select_skip, first, last);
+      break;
+  case VAL_SELECT_TEST:
+      /* A module runs if any of its tests is selected */
+      val_select_set_range(g_select_run, first, last);
+      for (i = first / VAL_MODULE_STRIDE; i <= last / VAL_MODULE_STRIDE; i++)
+          g_select_module_run |= (1u << i);
+      g_select_active = 1;
+      break;
+  case VAL_SELECT_MODULE:
+      if (!module_id)
+          return ACS_STATUS_ERR;
+      /* Module M selects tests M + 1 .. M + 99 */
+      val_select_set_range(g_select_run, first + 1, first + VAL_MODULE_STRIDE - 1);
+      g_select_module_run |= VAL_MODULE_BIT(first);
+      g_select_active = 1;
+      break;
+  default:
+      return ACS_STATUS_ERR;
+  }
+
+  return ACS_STATUS_PASS;
+}
+
+/**
+  @brief  This API adds the g_skip_test_num, g_execute_tests and
+          g_execute_modules arrays to the user selection lists. Entries
+          at or above VAL_TEST_NUM_MAX are placeholders and are ignored.
+          1. Caller       - Application layer, before running the tests
+          2. Prerequisite - None.
+
+  @param  None
+
+  @return None
+ **/
+void
+val_test_select_init(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < g_num_skip; i++)
+      (void)val_test_select_add(VAL_SELECT_SKIP, g_skip_test_num[i], g_skip_test_num[i]);
+
+  for (i = 0; i < g_num_tests; i++)
+      (void)val_test_select_add(VAL_SELECT_TEST, g_execute_tests[i], g_execute_tests[i]);
+
+  for (i = 0; i < g_num_modules; i++)
+      (void)val_test_select_add(VAL_SELECT_MODULE, g_execute_modules[i], g_execute_modules[i]);
+}
+
+/**
+  @brief  This API checks if the module ID is on the -skip list.
+          1. Caller       - Test suite
+          2. Prerequisite - None.
+
+  @param module_base Base number of the module
+
+  @return         ACS_STATUS_SKIP - if the user has overriden to skip the module
+                  ACS_STATUS_PASS - if the module is not on the -skip list
+ **/
+uint32_t
+val_check_skip_module_id(uint32_t module_base)
+{
+  if ((module_base < VAL_TEST_NUM_MAX) && (g_select_module_skip & VAL_MODULE_BIT(module_base)))
+      return ACS_STATUS_SKIP;
+
+  return ACS_STATUS_PASS;
+}
+
 /**
   @brief  This API checks if all the tests in the current module needs to be skipped.
           Skip if no tests are to be executed with user override options.
@@ -274,26 +573,10 @@ val_mmio_write64(addr_t addr, uint64_t data)
 uint32_t
 val_check_skip_module(uint32_t module_base)
 {
-  uint32_t i, skip_module = 0;
-
-  /* Case 1 - Don't skip the module if the module number is mentioned in -m option parameters */
-  for (i = 0; i < g_num_modules; i++) {
-      if (g_execute_modules[i] == module_base) {
-          skip_module++;
-      }
-  }
-
-  /* Case 2 - Don't skip the module if any of module's tests are in -t option parameters  */
-  for (i = 0; i < g_num_tests; i++) {
-      if ((g_execute_tests[i] - module_base) < 100) {
-          skip_module++;
-      }
-  }
-
-  /* Skip the module if neither of above 2 cases are true */
-  if ((!skip_module) && (g_num_tests || g_num_modules)) {
+  /* Skip the module if neither -m nor -t selects any of its tests */
+  if (g_select_active &&
+      ((module_base >= VAL_TEST_NUM_MAX) || !(g_select_module_run & VAL_MODULE_BIT(module_base))))
       return ACS_STATUS_SKIP;
-  }
 
   return ACS_STATUS_PASS;
 }
@@ -323,35 +606,20 @@ val_initialize_test(uint32_t test_num, char8_t *desc, uint32_t num_hart)
       val_set_status(i, RESULT_PENDING(test_num));
 
   /* Skip the test if it one of the -skip option parameters */
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == test_num) {
-          val_set_status(index, RESULT_SKIP(test_num, 0));
-          return ACS_STATUS_SKIP;
-      }
-  }
-
-  /* Don't skip if test_num is one of the -t option parameters */
-  for (i = 0; i < g_num_tests; i++) {
-      if (test_num == g_execute_tests[i]) {
-          g_override_skip++;
-      }
-  }
-
-  /* Don't skip if the test belongs to one of the modules in -m option parameters */
-  for (i = 0; i < g_num_modules; i++) {
-      if ((test_num - g_execute_modules[i]) > 0 &&
-          (test_num - g_execute_modules[i]) < 100)
-      {
-          g_override_skip++;
-      }
+  if (val_select_is_set(g_select_skip, test_num)) {
+      val_set_status(index, RESULT_SKIP(test_num, 0));
+      return ACS_STATUS_SKIP;
   }
 
-  if ((!g_override_skip) && (g_num_tests || g_num_modules)) {
+  /* Skip the test unless -t or -m selects it, when either is given */
+  if (g_select_active && !val_select_is_set(g_select_run, test_num)) {
       val_set_status(index, RESULT_SKIP(test_num, 0));
       return ACS_STATUS_SKIP;
   }
 
   g_override_skip = 1;
+  val_profile_open(test_num, num_hart);
+  val_result_begin_test(test_num, desc);
 
   val_print(ACS_PRINT_ERR, "%4d : ", test_num); //Always print this
   val_print(ACS_PRINT_TEST, desc, 0);
@@ -363,6 +631,25 @@ val_initialize_test(uint32_t test_num, char8_t *desc, uint32_t num_hart)
   return ACS_STATUS_PASS;
 }
 
+/**
+  @brief  Free the per-HART dispatch timestamps
+
+  @param  None
+
+  @result None
+**/
+static void
+val_free_dispatch_ts(void)
+{
+  if (g_dispatch_ts != NULL)
+      pal_mem_free((void *)g_dispatch_ts);
+  if (g_complete_ts != NULL)
+      pal_mem_free((void *)g_complete_ts);
+
+  g_dispatch_ts = NULL;
+  g_complete_ts = NULL;
+}
+
 /**
   @brief  Allocate memory which is to be shared across PEs
 
@@ -373,9 +660,41 @@ val_initialize_test(uint32_t test_num, char8_t *desc, uint32_t num_hart)
 void
 val_allocate_shared_mem()
 {
+  uint32_t i;
+  uint32_t line_size;
+  volatile VAL_SHARED_MEM_t *mem;
+
+  /* Give each HART whole cache lines so that no two HARTs share a line */
+  line_size = val_hart_get_cache_line_size();
+  g_shared_mem_stride = (sizeof(VAL_SHARED_MEM_t) + line_size - 1) & ~(line_size - 1);
+
+  /* One extra entry of slack to align the first mailbox to a cache line */
+  pal_mem_allocate_shared(val_hart_get_num() + 1, g_shared_mem_stride);
+  g_shared_mem_base = (pal_mem_get_shared_addr() + line_size - 1) & ~((addr_t)line_size - 1);
+
+  val_data_cache_ops_by_va((addr_t)&g_shared_mem_base, CLEAN_AND_INVALIDATE);
+  val_data_cache_ops_by_va((addr_t)&g_shared_mem_stride, CLEAN_AND_INVALIDATE);
+
+  /* Every secondary HART starts off, nothing is parked yet */
+  for (i = 0; i < val_hart_get_num(); i++) {
+      mem = val_get_shared_mem_entry(i);
+      mem->park_state = VAL_HART_OFF;
+      mem->park_cmd = VAL_PARK_CMD_RUN;
+      mem->park_seq = 0;
+      val_data_cache_ops_by_va((addr_t)&mem->park_state, CLEAN_AND_INVALIDATE);
+      val_data_cache_ops_by_va((addr_t)&mem->park_seq, CLEAN_AND_INVALIDATE);
+  }
 
-  pal_mem_allocate_shared(val_hart_get_num(), sizeof(VAL_SHARED_MEM_t));
+  val_print(ACS_PRINT_INFO, "\n Shared mailbox cache line size %d", line_size);
+  val_print(ACS_PRINT_INFO, " stride %d\n", g_shared_mem_stride);
 
+  /* Timestamps used by broadcast dispatch, sequential dispatch is used if absent */
+  g_dispatch_ts = pal_mem_alloc(val_hart_get_num() * sizeof(uint64_t));
+  g_complete_ts = pal_mem_alloc(val_hart_get_num() * sizeof(uint64_t));
+  if ((g_dispatch_ts == NULL) || (g_complete_ts == NULL)) {
+      val_print(ACS_PRINT_WARN, "\n Dispatch timestamps not allocated", 0);
+      val_free_dispatch_ts();
+  }
 }
 
 /**
@@ -391,7 +710,179 @@ void
 val_free_shared_mem()
 {
 
+  /* Parked HARTs poll their mailbox, release them before it goes away */
+  if (g_shared_mem_base)
+      val_hart_park_shutdown();
+
   pal_mem_free_shared();
+  g_shared_mem_base = 0;
+  val_free_dispatch_ts();
+}
+
+/**
+  @brief  Payload of the mailbox benchmark. Each HART repeatedly updates the
+          status in its own mailbox and finally reports a pass.
+
+  @param  None
+
+  @result None
+**/
+static void
+val_shared_mem_bench_payload(void)
+{
+  uint32_t i;
+  uint32_t index = val_hart_get_index_mpid(val_hart_get_mpid());
+
+  for (i = 0; i < g_mailbox_bench_iter; i++)
+      val_set_status(index, RESULT_PENDING(0));
+
+  val_set_status(index, RESULT_PASS(0, 1));
+}
+
+/**
+  @brief  Measures the shared mailbox status update throughput as the number
+          of HARTs updating their mailbox concurrently grows, doubling the
+          HART count on each step. The measured time includes the dispatch
+          of the payload to the secondary HARTs.
+        1. Caller       - Application Layer
+        2. Prerequisite - val_allocate_shared_mem
+
+  @param  num_iter   Status updates issued by each HART
+
+  @result None
+**/
+void
+val_shared_mem_benchmark(uint32_t num_iter)
+{
+  uint32_t i;
+  uint32_t num_hart;
+  uint32_t num_run;
+  uint32_t my_index;
+  uint64_t start;
+  uint64_t elapsed_us;
+  uint32_t total_hart = val_hart_get_num();
+
+  if ((total_hart == 0) || (num_iter == 0))
+      return;
+
+  my_index = val_hart_get_index_mpid(val_hart_get_mpid());
+  g_mailbox_bench_iter = num_iter;
+  val_data_cache_ops_by_va((addr_t)&g_mailbox_bench_iter, CLEAN_AND_INVALIDATE);
+
+  val_print(ACS_PRINT_TEST, "\n MAILBOX_PERF: Status updates per HART :    %d", num_iter);
+
+  num_hart = 1;
+  while (1) {
+      for (i = 0; i < total_hart; i++)
+          val_set_status(i, RESULT_PENDING(0));
+
+      start = val_timer_get_counter();
+      val_run_test_payload(0, num_hart, val_shared_mem_bench_payload, 0);
+      elapsed_us = val_timer_ticks_to_us(val_timer_get_counter() - start);
+
+      /* The payload always runs on this HART, even when outside the range */
+      num_run = (my_index < num_hart) ? num_hart : num_hart + 1;
+
+      val_print(ACS_PRINT_TEST, "\n MAILBOX_PERF: HARTs %4d", num_run);
+      val_print(ACS_PRINT_TEST, "  time %ld us", elapsed_us);
+      if (elapsed_us)
+          val_print(ACS_PRINT_TEST, "  (%ld updates/s)",
+                    ((uint64_t)num_run * num_iter * 1000000) / elapsed_us);
+
+      if (num_hart == total_hart)
+          break;
+
+      num_hart = (num_hart * 2 > total_hart) ? total_hart : num_hart * 2;
+  }
+
+  val_print(ACS_PRINT_TEST, "\n", 0);
+}
+
+/**
+  @brief  Payload of the dispatch benchmark, only reports a pass.
+
+  @param  None
+
+  @result None
+**/
+static void
+val_dispatch_bench_payload(void)
+{
+  val_set_status(val_hart_get_index_mpid(val_hart_get_mpid()), RESULT_PASS(0, 1));
+}
+
+/**
+  @brief  Measures the time to dispatch an empty payload to every HART and
+          collect its status, first with the secondary HARTs powered off
+          after each payload and then with them parked between payloads.
+          The parking setting of the run is restored afterwards.
+        1. Caller       - Application Layer
+        2. Prerequisite - val_allocate_shared_mem
+
+  @param  num_iter   Dispatches timed for each model
+
+  @result None
+**/
+void
+val_dispatch_benchmark(uint32_t num_iter)
+{
+  uint32_t i;
+  uint32_t iter;
+  uint32_t model;
+  uint32_t park_mode = g_hart_park;
+  uint32_t num_hart = val_hart_get_num();
+  uint64_t start = 0;
+  uint64_t elapsed_us;
+
+  if ((num_hart < 2) || (num_iter == 0))
+      return;
+
+  val_print(ACS_PRINT_TEST, "\n DISPATCH_PERF: HARTs %d", num_hart);
+  val_print(ACS_PRINT_TEST, "  dispatches per model %d", num_iter);
+
+  for (model = 0; model < 2; model++) {
+      /* Model 0 powers the HARTs off after each payload, model 1 parks them */
+      val_hart_park_shutdown();
+      g_hart_park = model;
+      val_data_cache_ops_by_va((addr_t)&g_hart_park, CLEAN_AND_INVALIDATE);
+
+      /* The HARTs are powered on by the first dispatch, keep it out of the timing */
+      for (iter = 0; iter <= num_iter; iter++) {
+          if (iter == 1)
+              start = val_timer_get_counter();
+
+          for (i = 0; i < num_hart; i++)
+              val_set_status(i, RESULT_PENDING(0));
+          val_run_test_payload(0, num_hart, val_dispatch_bench_payload, 0);
+      }
+      elapsed_us = val_timer_ticks_to_us(val_timer_get_counter() - start);
+
+      val_print(ACS_PRINT_TEST, model ? "\n DISPATCH_PERF: Parked HARTs    : %ld us per dispatch" :
+                                        "\n DISPATCH_PERF: CPU_ON/CPU_OFF  : %ld us per dispatch",
+                elapsed_us / num_iter);
+  }
+
+  g_hart_park = park_mode;
+  val_data_cache_ops_by_va((addr_t)&g_hart_park, CLEAN_AND_INVALIDATE);
+  if (!park_mode)
+      val_hart_park_shutdown();
+
+  val_print(ACS_PRINT_TEST, "\n", 0);
+}
+
+/**
+  @brief  Returns the shared mailbox of the HART identified by index
+          1. Caller       - VAL
+          2. Prerequisite - val_allocate_shared_mem
+
+  @param index     the HART Index
+
+  @return        Pointer to the mailbox of the HART
+ **/
+volatile VAL_SHARED_MEM_t *
+val_get_shared_mem_entry(uint32_t index)
+{
+  return (VAL_SHARED_MEM_t *)(g_shared_mem_base + ((addr_t)index * g_shared_mem_stride));
 }
 
 /**
@@ -418,14 +909,13 @@ val_set_test_data(uint32_t index, uint64_t addr, uint64_t test_data)
       return;
   }
 
-  mem = (VAL_SHARED_MEM_t *)pal_mem_get_shared_addr();
-  mem = mem + index;
+  mem = val_get_shared_mem_entry(index);
 
   mem->data0 = addr;
   mem->data1 = test_data;
 
+  /* The mailbox starts on a cache line, data0 and data1 share that line */
   val_data_cache_ops_by_va((addr_t)&mem->data0, CLEAN_AND_INVALIDATE);
-  val_data_cache_ops_by_va((addr_t)&mem->data1, CLEAN_AND_INVALIDATE);
 }
 
 /**
@@ -453,11 +943,9 @@ val_get_test_data(uint32_t index, uint64_t *data0, uint64_t *data1)
       return;
   }
 
-  mem = (VAL_SHARED_MEM_t *) pal_mem_get_shared_addr();
-  mem = mem + index;
+  mem = val_get_shared_mem_entry(index);
 
   val_data_cache_ops_by_va((addr_t)&mem->data0, INVALIDATE);
-  val_data_cache_ops_by_va((addr_t)&mem->data1, INVALIDATE);
 
   *data0 = mem->data0;
   *data1 = mem->data1;
@@ -472,22 +960,24 @@ val_get_test_data(uint32_t index, uint64_t *data0, uint64_t *data1)
 
   @param test_num  Unique test number
   @param num_hart    Number of HART who are executing this test
-  @param timeout   integer value ob expiry the API will timeout and return
+  @param timeout_us  time in microseconds after which the API will timeout and return
 
   @return        None
  **/
 
 static void
-val_wait_for_test_completion(uint32_t test_num, uint32_t num_hart, uint32_t timeout)
+val_wait_for_test_completion(uint32_t test_num, uint32_t num_hart, uint64_t timeout_us)
 {
 
   uint32_t i = 0, j = 0;
+  VAL_TIMEOUT_t timeout;
 
   //For single HART tests, there is no need to wait for the results
   if (num_hart == 1)
       return;
 
-  while(--timeout)
+  val_timeout_start(&timeout, timeout_us);
+  do
   {
       j = 0;
       for (i = 0; i < num_hart; i++)
@@ -499,9 +989,180 @@ val_wait_for_test_completion(uint32_t test_num, uint32_t num_hart, uint32_t time
       //If None of the HART have the status as Pending, return
       if (!j)
           return;
-  }
+
+      val_timeout_backoff(&timeout);
+  } while (!val_timeout_expired(&timeout));
   //We are here if we timed-out, set the last index HART as failed
   val_set_status(j-1, RESULT_FAIL(test_num, 0xF));
+  val_print_flush();
+}
+
+/**
+  @brief  Starts the payload on all secondary HARTs together. CPU_ON is
+          issued to every target HART in turn, and HARTs which are still
+          on from a previous test are retried in the next pass instead of
+          stalling the dispatch of the remaining HARTs.
+
+  @param test_num   unique test number
+  @param num_hart   The number of PEs to run this test on
+  @param my_index   Index of the HART dispatching the test
+  @param payload    Function pointer of the test entry function
+  @param test_input optional parameter for the test payload
+
+  @return        None
+ **/
+static void
+val_dispatch_broadcast(uint32_t test_num, uint32_t num_hart, uint32_t my_index,
+                       void (*payload)(void), uint64_t test_input)
+{
+  uint32_t i;
+  uint32_t pending;
+  int32_t  ret;
+  VAL_TIMEOUT_t timeout;
+  (void) test_num;
+
+  for (i = 0; i < num_hart; i++) {
+      g_dispatch_ts[i] = VAL_INVALID_TIMESTAMP;
+      g_complete_ts[i] = VAL_INVALID_TIMESTAMP;
+  }
+
+  /* This HART is a target only when it lies within the dispatch range */
+  pending = (my_index < num_hart) ? (num_hart - 1) : num_hart;
+  val_timeout_start(&timeout, TIMEOUT_LARGE_US);
+  while (pending)
+  {
+      for (i = 0; i < num_hart; i++) {
+          if ((i == my_index) || (g_dispatch_ts[i] != VAL_INVALID_TIMESTAMP))
+              continue;
+
+          ret = val_execute_on_pe_async(i, payload, test_input);
+          if (ret == ARM_SMC_PSCI_RET_ALREADY_ON)
+              continue;
+
+          g_dispatch_ts[i] = val_timer_get_counter();
+          pending--;
+
+          if (ret != ARM_SMC_PSCI_RET_SUCCESS) {
+              val_print(ACS_PRINT_ERR, "\n       PSCI_CPU_ON: failure[%d]", ret);
+              val_set_status(i, RESULT_FAIL(0, 0x120 - ret));
+              /* Nothing to wait for on this HART */
+              g_complete_ts[i] = g_dispatch_ts[i];
+          }
+      }
+
+      /* Remaining HARTs are still on, give them time to turn off */
+      if (!pending || val_timeout_expired(&timeout))
+          break;
+      val_timeout_backoff(&timeout);
+  }
+
+  if (!pending)
+      return;
+
+  for (i = 0; i < num_hart; i++) {
+      if ((i == my_index) || (g_dispatch_ts[i] != VAL_INVALID_TIMESTAMP))
+          continue;
+
+      val_print(ACS_PRINT_ERR, "\n       PSCI_CPU_ON: cpu already on %d", i);
+      val_set_status(i, RESULT_FAIL(0, 0x120 - ARM_SMC_PSCI_RET_ALREADY_ON));
+  }
+  val_print_flush();
+}
+
+/**
+  @brief  Single completion barrier for a broadcast dispatch. Waits until no
+          dispatched HART has a pending status and records the completion
+          time of each HART as it is observed. HARTs still pending at
+          timeout are marked as failed.
+
+  @param test_num   unique test number
+  @param num_hart   The number of PEs the test was dispatched to
+  @param my_index   Index of the HART dispatching the test
+  @param timeout_us time in microseconds before giving up
+
+  @return        None
+ **/
+static void
+val_wait_for_broadcast_completion(uint32_t test_num, uint32_t num_hart, uint32_t my_index,
+                                  uint64_t timeout_us)
+{
+  uint32_t i;
+  uint32_t remaining;
+  VAL_TIMEOUT_t timeout;
+
+  val_timeout_start(&timeout, timeout_us);
+  do {
+      remaining = 0;
+      for (i = 0; i < num_hart; i++) {
+          if ((i == my_index) || (g_dispatch_ts[i] == VAL_INVALID_TIMESTAMP) ||
+              (g_complete_ts[i] != VAL_INVALID_TIMESTAMP))
+              continue;
+
+          if (IS_RESULT_PENDING(val_get_status(i)))
+              remaining++;
+          else
+              g_complete_ts[i] = val_timer_get_counter();
+      }
+
+      if (!remaining)
+          break;
+      val_timeout_backoff(&timeout);
+  } while (!val_timeout_expired(&timeout));
+
+  if (!remaining)
+      return;
+
+  for (i = 0; i < num_hart; i++) {
+      if ((i == my_index) || (g_dispatch_ts[i] == VAL_INVALID_TIMESTAMP) ||
+          (g_complete_ts[i] != VAL_INVALID_TIMESTAMP))
+          continue;
+
+      val_print(ACS_PRINT_ERR, "\n       Timed out waiting for HART %d", i);
+      val_set_status(i, RESULT_FAIL(test_num, 0xF));
+  }
+  val_print_flush();
+}
+
+/**
+  @brief  Prints the dispatch to completion latency of each HART of the last
+          broadcast dispatch, followed by the slowest HART.
+
+  @param num_hart   The number of PEs the test was dispatched to
+  @param my_index   Index of the HART dispatching the test
+
+  @return        None
+ **/
+static void
+val_report_dispatch_latency(uint32_t num_hart, uint32_t my_index)
+{
+  uint32_t i;
+  uint32_t level;
+  uint32_t max_index = my_index;
+  uint64_t latency_us;
+  uint64_t max_latency_us = 0;
+
+  level = g_perf_mode ? ACS_PRINT_TEST : ACS_PRINT_DEBUG;
+
+  for (i = 0; i < num_hart; i++) {
+      if ((i == my_index) || (g_dispatch_ts[i] == VAL_INVALID_TIMESTAMP) ||
+          (g_complete_ts[i] == VAL_INVALID_TIMESTAMP))
+          continue;
+
+      latency_us = val_timer_ticks_to_us(g_complete_ts[i] - g_dispatch_ts[i]);
+      val_print(level, "\n       HART %3d", i);
+      val_print(level, " dispatch to completion : %ld us", latency_us);
+
+      if (latency_us >= max_latency_us) {
+          max_latency_us = latency_us;
+          max_index = i;
+      }
+  }
+
+  if (max_index == my_index)
+      return;
+
+  val_print(level, "\n       Slowest HART %d", max_index);
+  val_print(level, " : %ld us", max_latency_us);
 }
 
 /**
@@ -522,10 +1183,25 @@ val_run_test_payload(uint32_t test_num, uint32_t num_hart, void (*payload)(void)
 
   uint32_t my_index = val_hart_get_index_mpid(val_hart_get_mpid());
   uint32_t i;
+  uint64_t run_start;
+  uint64_t payload_ticks;
 
+  run_start = val_timer_get_counter();
   payload();  //this is test run separately on present HART
-  if (num_hart == 1)
+  payload_ticks = val_timer_get_counter() - run_start;
+  if (num_hart == 1) {
+      val_profile_run(run_start, payload_ticks, num_hart, my_index, 0);
+      return;
+  }
+
+  /* Start all other HART together and wait on a single completion barrier */
+  if ((g_dispatch_ts != NULL) && (g_complete_ts != NULL)) {
+      val_dispatch_broadcast(test_num, num_hart, my_index, payload, test_input);
+      val_wait_for_broadcast_completion(test_num, num_hart, my_index, TIMEOUT_LARGE_US);
+      val_report_dispatch_latency(num_hart, my_index);
+      val_profile_run(run_start, payload_ticks, num_hart, my_index, 1);
       return;
+  }
 
   //Now run the test on all other HART
   for (i = 0; i < num_hart; i++) {
@@ -533,7 +1209,64 @@ val_run_test_payload(uint32_t test_num, uint32_t num_hart, void (*payload)(void)
           val_execute_on_pe(i, payload, test_input);
   }
 
-  val_wait_for_test_completion(test_num, num_hart, TIMEOUT_LARGE);
+  val_wait_for_test_completion(test_num, num_hart, TIMEOUT_LARGE_US);
+  val_profile_run(run_start, payload_ticks, num_hart, my_index, 0);
+}
+
+/**
+  @brief  This API Executes the payload function on this HART and the
+          secondary PEs at the same time. Unlike val_run_test_payload, the
+          secondary PEs are started before the payload runs here, for
+          payloads that split work between the PEs.
+          1. Caller       - Application layer
+          2. Prerequisite - val_hart_create_info_table
+
+  @param test_num   unique test number
+  @param num_hart   The number of PEs to run this test on
+  @param payload    Function pointer of the test entry function
+  @param test_input optional parameter for the test payload
+
+  @return        None
+ **/
+void
+val_run_test_payload_concurrent(uint32_t test_num, uint32_t num_hart, void (*payload)(void),
+                                uint64_t test_input)
+{
+
+  uint32_t my_index = val_hart_get_index_mpid(val_hart_get_mpid());
+  uint32_t i;
+  uint64_t run_start;
+  uint64_t payload_start;
+  uint64_t payload_ticks;
+
+  run_start = val_timer_get_counter();
+  if (num_hart == 1) {
+      payload();
+      val_profile_run(run_start, val_timer_get_counter() - run_start, num_hart, my_index, 0);
+      return;
+  }
+
+  if ((g_dispatch_ts != NULL) && (g_complete_ts != NULL)) {
+      val_dispatch_broadcast(test_num, num_hart, my_index, payload, test_input);
+      payload_start = val_timer_get_counter();
+      payload();
+      payload_ticks = val_timer_get_counter() - payload_start;
+      val_wait_for_broadcast_completion(test_num, num_hart, my_index, TIMEOUT_LARGE_US);
+      val_report_dispatch_latency(num_hart, my_index);
+      val_profile_run(run_start, payload_ticks, num_hart, my_index, 1);
+      return;
+  }
+
+  for (i = 0; i < num_hart; i++) {
+      if (i != my_index)
+          val_execute_on_pe(i, payload, test_input);
+  }
+
+  payload_start = val_timer_get_counter();
+  payload();
+  payload_ticks = val_timer_get_counter() - payload_start;
+  val_wait_for_test_completion(test_num, num_hart, TIMEOUT_LARGE_US);
+  val_profile_run(run_start, payload_ticks, num_hart, my_index, 0);
 }
 
 /**
@@ -554,36 +1287,39 @@ val_check_for_error(uint32_t test_num, uint32_t num_hart, char8_t *ruleid)
   uint32_t status = 0;
   uint32_t error_flag = 0;
   uint32_t my_index = val_hart_get_index_mpid(val_hart_get_mpid());
-  (void) test_num;
+  uint64_t elapsed_ticks;
+
+  elapsed_ticks = val_profile_close();
 
   /* this special case is needed when the Main HART is not the first entry
      of hart_info_table but num_hart is 1 for SOC tests */
   if (num_hart == 1) {
       status = val_get_status(my_index);
       val_report_status(my_index, status, ruleid);
-      if (IS_TEST_PASS(status)) {
-          g_bsa_tests_pass++;
-          return ACS_STATUS_PASS;
+  } else {
+      for (i = 0; i < num_hart; i++) {
+          status = val_get_status(i);
+          //val_print(ACS_PRINT_ERR, "Status %4x\n", status);
+          if (IS_TEST_FAIL_SKIP(status)) {
+              val_report_status(i, status, ruleid);
+              error_flag += 1;
+              break;
+          }
       }
-      if (IS_TEST_SKIP(status))
-          return ACS_STATUS_SKIP;
 
-      g_bsa_tests_fail++;
-      return ACS_STATUS_FAIL;
+      if (!error_flag)
+          val_report_status(my_index, status, ruleid);
   }
 
-  for (i = 0; i < num_hart; i++) {
-      status = val_get_status(i);
-      //val_print(ACS_PRINT_ERR, "Status %4x\n", status);
-      if (IS_TEST_FAIL_SKIP(status)) {
-          val_report_status(i, status, ruleid);
-          error_flag += 1;
-          break;
-      }
-  }
+  /* Tests skipped by the user options are not reported */
+  if (g_override_skip)
+      val_result_write_test(test_num, ruleid, num_hart, status,
+                            val_timer_ticks_to_us(elapsed_ticks));
 
-  if (!error_flag)
-      val_report_status(my_index, status, ruleid);
+  /* Write out the output of this test, so that a later test which hangs
+     cannot lose it */
+  val_print_flush();
+  pal_result_flush();
 
   if (IS_TEST_PASS(status)) {
       g_bsa_tests_pass++;
@@ -596,6 +1332,124 @@ val_check_for_error(uint32_t test_num, uint32_t num_hart, char8_t *ruleid)
   return ACS_STATUS_FAIL;
 }
 
+/**
+  @brief  Prints the timing profile of the tests run so far: the slowest
+          tests, the total time of each module, and how the total splits
+          into test setup, payload, dispatch and wait, and reporting.
+          Setup runs from val_initialize_test to the first payload run,
+          reporting from the last payload run to val_check_for_error.
+        1. Caller       - Application Layer
+        2. Prerequisite - None
+
+  @param  num_slowest   Number of slowest tests to list, at most
+                        VAL_PROFILE_NUM_SLOWEST
+
+  @result None
+**/
+void
+val_profile_report(uint32_t num_slowest)
+{
+  uint32_t i, j, n;
+  uint32_t level;
+  uint32_t module;
+  uint32_t num_module = VAL_NUM_MODULE + 1;
+  uint32_t num_top = 0;
+  uint32_t top[VAL_PROFILE_NUM_SLOWEST];
+  /* One slot per module, and the last one for the host simulation tests */
+  uint32_t module_tests[VAL_NUM_MODULE + 1];
+  uint64_t module_ticks[VAL_NUM_MODULE + 1];
+  uint64_t total, run_start, run_end;
+  uint64_t setup_ticks = 0, payload_ticks = 0, wait_ticks = 0, report_ticks = 0;
+  VAL_TEST_PROFILE_t *prof;
+
+  level = g_perf_mode ? ACS_PRINT_TEST : ACS_PRINT_DEBUG;
+
+  if (num_slowest > VAL_PROFILE_NUM_SLOWEST)
+      num_slowest = VAL_PROFILE_NUM_SLOWEST;
+
+  for (i = 0; i < num_module; i++) {
+      module_tests[i] = 0;
+      module_ticks[i] = 0;
+  }
+
+  n = g_num_profile;
+  for (i = 0; i < n; i++) {
+      prof = &g_test_profile[i];
+      if (!prof->report)
+          continue;
+
+      total = prof->report - prof->start;
+      module = prof->test_num / 100;
+      if (module == (ACS_HOST_TEST_NUM_BASE / 100))
+          module = VAL_NUM_MODULE;
+      if (module < num_module) {
+          module_tests[module]++;
+          module_ticks[module] += total;
+      }
+
+      /* Tests which never ran a payload count as setup only */
+      run_start = prof->dispatch ? prof->dispatch : prof->report;
+      run_end = prof->dispatch ? prof->run_end : prof->report;
+      setup_ticks += run_start - prof->start;
+      payload_ticks += prof->payload_ticks;
+      wait_ticks += prof->run_ticks - prof->payload_ticks;
+      report_ticks += prof->report - run_end;
+
+      /* Keep the slowest tests sorted, slowest first */
+      for (j = num_top; j > 0; j--) {
+          if ((g_test_profile[top[j - 1]].report - g_test_profile[top[j - 1]].start) >= total)
+              break;
+          if (j < num_slowest)
+              top[j] = top[j - 1];
+      }
+      if (j < num_slowest) {
+          top[j] = i;
+          if (num_top < num_slowest)
+              num_top++;
+      }
+  }
+
+  val_print(level, "\n\n      *** Test profile ***", 0);
+  val_print(level, "\n       Tests timed : %d", n);
+  if (g_num_profile_dropped)
+      val_print(level, ", not timed : %d", g_num_profile_dropped);
+
+  val_print(level, "\n\n       Slowest tests (us)", 0);
+  val_print(level, "\n       Test      Total      Setup    Payload   Dispatch     Report  Slowest HART", 0);
+  for (i = 0; i < num_top; i++) {
+      prof = &g_test_profile[top[i]];
+      run_start = prof->dispatch ? prof->dispatch : prof->report;
+      run_end = prof->dispatch ? prof->run_end : prof->report;
+      val_print(level, "\n       %4d", prof->test_num);
+      val_print(level, " %10ld", val_timer_ticks_to_us(prof->report - prof->start));
+      val_print(level, " %10ld", val_timer_ticks_to_us(run_start - prof->start));
+      val_print(level, " %10ld", val_timer_ticks_to_us(prof->payload_ticks));
+      val_print(level, " %10ld", val_timer_ticks_to_us(prof->run_ticks - prof->payload_ticks));
+      val_print(level, " %10ld", val_timer_ticks_to_us(prof->report - run_end));
+      if (prof->slowest_ticks) {
+          val_print(level, "  %4d", prof->slowest_hart);
+          val_print(level, " : %ld", val_timer_ticks_to_us(prof->slowest_ticks));
+      }
+  }
+
+  val_print(level, "\n\n       Module totals (us)", 0);
+  for (i = 0; i < num_module; i++) {
+      if (!module_tests[i])
+          continue;
+      val_print(level, "\n       ", 0);
+      val_print(level, val_get_module_name((i < VAL_NUM_MODULE) ? (i * 100) : ACS_HOST_TEST_NUM_BASE), 0);
+      val_print(level, " : %d tests", module_tests[i]);
+      val_print(level, ", %ld", val_timer_ticks_to_us(module_ticks[i]));
+  }
+
+  val_print(level, "\n\n       Time split (us)", 0);
+  val_print(level, "\n       Setup             : %ld", val_timer_ticks_to_us(setup_ticks));
+  val_print(level, "\n       Payload           : %ld", val_timer_ticks_to_us(payload_ticks));
+  val_print(level, "\n       Dispatch and wait : %ld", val_timer_ticks_to_us(wait_ticks));
+  val_print(level, "\n       Report            : %ld\n", val_timer_ticks_to_us(report_ticks));
+  val_print_flush();
+}
+
 /**
   @brief  Clean and Invalidate the Data cache line containing
           the input address tag
@@ -35,13 +35,12 @@ TIMER_INFO_TABLE  *g_timer_info_table;
 uint32_t
 val_timer_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 {
-  uint32_t status, i;
+  uint32_t status;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_TIMER_TEST_NUM_BASE) {
-          val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Timer tests\n", 0);
-          return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_TIMER_TEST_NUM_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Timer tests\n", 0);
+      return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
@@ -322,6 +321,20 @@ val_timer_set_vir_el2(uint64_t timeout)
 
 }
 
+/**
+  @brief   This API returns the number of bytes needed for the Timer info table,
+           as counted by the PAL layer, so that the caller can allocate it exactly.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  None.
+  @param   None
+  @return  Size of the Timer info table in bytes
+**/
+uint32_t
+val_timer_get_info_table_size(void)
+{
+  return sizeof(TIMER_INFO_TABLE) + (pal_timer_get_info_entry_count() * sizeof(TIMER_INFO_GTBLOCK));
+}
+
 /**
   @brief   This API will call PAL layer to fill in the Timer information
            into the g_timer_info_table pointer.
@@ -439,3 +452,131 @@ val_timer_skip_if_cntbase_access_not_allowed(uint64_t index)
       return ACS_STATUS_SKIP;
 
 }
+
+/**
+  @brief  This API returns the current value of the hart time counter.
+          Used as a time base for measuring elapsed time within the suite.
+
+  @param  None
+
+  @return Time counter value
+**/
+uint64_t
+val_timer_get_counter(void)
+{
+  return pal_timer_get_counter();
+}
+
+/**
+  @brief  This API converts a number of time counter ticks to microseconds
+          using the counter frequency reported by the platform.
+
+  @param  ticks  Number of counter ticks
+
+  @return Elapsed time in microseconds, 0 if counter frequency is unknown
+**/
+uint64_t
+val_timer_ticks_to_us(uint64_t ticks)
+{
+  uint64_t counter_freq;
+
+  counter_freq = val_get_counter_frequency();
+  if (counter_freq == 0)
+      return 0;
+
+  /* Split the conversion to avoid overflowing ticks * 1000000 */
+  return ((ticks / counter_freq) * 1000000) +
+         (((ticks % counter_freq) * 1000000) / counter_freq);
+}
+
+/**
+  @brief  This API converts microseconds to a number of time counter ticks
+          using the counter frequency reported by the platform.
+
+  @param  us  Time in microseconds
+
+  @return Number of counter ticks, 0 if counter frequency is unknown
+**/
+uint64_t
+val_timer_us_to_ticks(uint64_t us)
+{
+  uint64_t counter_freq;
+
+  counter_freq = val_get_counter_frequency();
+
+  return ((us / 1000000) * counter_freq) + (((us % 1000000) * counter_freq) / 1000000);
+}
+
+/**
+  @brief  This API starts a wall clock timeout measured against the time
+          counter. When the counter frequency is unknown the timeout falls
+          back to counting one poll per microsecond.
+
+  @param  timeout     Timeout state to initialise
+  @param  timeout_us  Timeout length in microseconds
+
+  @return None
+**/
+void
+val_timeout_start(VAL_TIMEOUT_t *timeout, uint64_t timeout_us)
+{
+  timeout->start       = val_timer_get_counter();
+  timeout->ticks       = val_timer_us_to_ticks(timeout_us);
+  timeout->polls       = timeout_us;
+  timeout->backoff     = val_timer_us_to_ticks(1);
+  timeout->max_backoff = val_timer_us_to_ticks(VAL_POLL_BACKOFF_MAX_US);
+
+  if (timeout->backoff == 0)
+      timeout->backoff = 1;
+}
+
+/**
+  @brief  This API checks whether a timeout started with val_timeout_start
+          has expired.
+
+  @param  timeout  Timeout state
+
+  @return 1 if the timeout has expired, 0 otherwise
+**/
+uint32_t
+val_timeout_expired(VAL_TIMEOUT_t *timeout)
+{
+  if (timeout->ticks)
+      return ((val_timer_get_counter() - timeout->start) >= timeout->ticks);
+
+  if (timeout->polls == 0)
+      return 1;
+
+  timeout->polls--;
+  return 0;
+}
+
+/**
+  @brief  This API waits before the next poll of a condition guarded by the
+          timeout. The delay starts at one microsecond and doubles on every
+          call up to VAL_POLL_BACKOFF_MAX_US, so that slow events are not
+          polled flat out.
+
+  @param  timeout  Timeout state
+
+  @return None
+**/
+void
+val_timeout_backoff(VAL_TIMEOUT_t *timeout)
+{
+  uint64_t start;
+
+  /* No time base to wait against, the poll count bounds the timeout */
+  if (timeout->ticks == 0)
+      return;
+
+  start = val_timer_get_counter();
+  while ((val_timer_get_counter() - start) < timeout->backoff)
+      ;
+
+  timeout->backoff <<= 1;
+  if (timeout->backoff > timeout->max_backoff)
+      timeout->backoff = timeout->max_backoff;
+  if (timeout->backoff == 0)
+      timeout->backoff = 1;
+}
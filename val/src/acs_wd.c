@@ -34,13 +34,12 @@ WD_INFO_TABLE  *g_wd_info_table;
 uint32_t
 val_wd_execute_tests(uint32_t num_hart, uint32_t *g_sw_view)
 {
-  uint32_t status, i;
+  uint32_t status;
 
-  for (i = 0; i < g_num_skip; i++) {
-      if (g_skip_test_num[i] == ACS_WD_TEST_NUM_BASE) {
-          val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Watchdog tests\n", 0);
-          return ACS_STATUS_SKIP;
-      }
+  /* Skip the module if its module ID is one of the -skip option parameters */
+  if (val_check_skip_module_id(ACS_WD_TEST_NUM_BASE)) {
+      val_print(ACS_PRINT_INFO, "\n       USER Override - Skipping all Watchdog tests\n", 0);
+      return ACS_STATUS_SKIP;
   }
 
   /* Check if there are any tests to be executed in current module with user override options*/
@@ -108,6 +107,20 @@ val_wd_get_info(uint32_t index, WD_INFO_TYPE_e info_type)
   }
 }
 
+/**
+  @brief   This API returns the number of bytes needed for the Watchdog info table,
+           as counted by the PAL layer, so that the caller can allocate it exactly.
+           1. Caller       -  Application layer.
+           2. Prerequisite -  None.
+  @param   None
+  @return  Size of the Watchdog info table in bytes
+**/
+uint32_t
+val_wd_get_info_table_size(void)
+{
+  return sizeof(WD_INFO_TABLE) + (pal_wd_get_info_entry_count() * sizeof(WD_INFO_BLOCK));
+}
+
 /**
   @brief   This API will call PAL layer to fill in the Watchdog information
            into the address pointed by g_wd_info_table pointer.
@@ -46,7 +46,8 @@ do { \
 void
 val_iic_imsic_eix_array_update (uint32_t base_id, uint32_t num_id, bool pend, bool val)
 {
-	uint32_t i, isel, ireg;
+	uint32_t i, isel;
+	unsigned long ireg;
 	uint32_t id = base_id, last_id = base_id + num_id;
 
 	while (id < last_id) {
@@ -71,7 +72,8 @@ val_iic_imsic_eix_array_update (uint32_t base_id, uint32_t num_id, bool pend, bo
 void
 val_iic_imsic_eix_update (uint32_t id, bool pend, bool val)
 {
-	uint32_t isel, ireg;
+	uint32_t isel;
+	unsigned long ireg;
 
     isel = id / __riscv_xlen;
     isel *= __riscv_xlen / IMSIC_EIPx_BITS;
@@ -102,6 +104,61 @@ val_iic_imsic_eix_read (uint32_t id, bool pend)
     return imsic_csr_read(isel);
 }
 
+/**
+  @brief  Check that the EIE (or EIP) bit of every interrupt identity from 1 to
+          num_id can be set and cleared. Each register is swept as a whole with
+          val_iic_imsic_eix_array_update and read back once per step, and its
+          previous contents are restored afterwards.
+
+  @param  num_id  highest interrupt identity to check
+  @param  pend    check the EIP bits when true, the EIE bits otherwise
+
+  @return 0 if all bits work, otherwise the first identity whose bit failed
+**/
+uint32_t
+val_iic_imsic_eix_array_check (uint32_t num_id, bool pend)
+{
+	uint32_t id = 1, last_id = num_id + 1;
+	uint32_t i, cnt, isel, fail_id = 0;
+	unsigned long span, bad, orig, reg;
+
+	while ((id < last_id) && !fail_id) {
+		isel = id / __riscv_xlen;
+		isel *= __riscv_xlen / IMSIC_EIPx_BITS;
+		isel += (pend) ? IMSIC_EIP0 : IMSIC_EIE0;
+
+		span = 0;
+		cnt = 0;
+		for (i = id & (__riscv_xlen - 1);
+		     (id + cnt < last_id) && (i < __riscv_xlen); i++, cnt++)
+			span |= BIT(i);
+
+		orig = imsic_csr_read(isel);
+
+		val_iic_imsic_eix_array_update(id, cnt, pend, 1);
+		reg = imsic_csr_read(isel);
+		bad = span & ~reg;
+		if (!bad) {
+			val_iic_imsic_eix_array_update(id, cnt, pend, 0);
+			reg = imsic_csr_read(isel);
+			bad = span & reg;
+		}
+
+		for (i = 0; bad && (i < __riscv_xlen); i++) {
+			if (bad & BIT(i)) {
+				fail_id = (id & ~(__riscv_xlen - 1)) + i;
+				break;
+			}
+		}
+
+		imsic_csr_clear(isel, span & ~orig);
+		imsic_csr_set(isel, span & orig);
+		id += cnt;
+	}
+
+	return fail_id;
+}
+
 uint32_t
 val_iic_imsic_eidelivery_update (uint32_t val)
 {
@@ -76,79 +76,143 @@ static int smmu_cmdq_build_cmd(uint64_t *cmd, uint8_t opcode)
     return 0;
 }
 
-static int smmu_cmdq_write_cmd(smmu_dev_t *smmu, uint64_t *cmd)
+static uint32_t smmu_queue_ptr_mask(smmu_queue_t *q)
 {
-    uint32_t timeout = SMMU_CMDQ_POLL_TIMEOUT;
-    int ret = 0, i;
-    uint64_t *cmd_dst;
-    smmu_cmd_queue_t *cmdq = &smmu->cmdq;
-    smmu_queue_t
-        queue =
-            {
-                .log2nent = cmdq->queue.log2nent,
-            };
-
-    while (smmu_queue_full(&cmdq->queue) && timeout) {
-        timeout--;
-    }
-
-    if (!timeout) {
-        val_print(ACS_PRINT_ERR, "\n       SMMU CMD queue is full     ", 0);
-        return -1;
-    }
-
-    queue.prod = val_mmio_read((uint64_t)cmdq->prod_reg);
-    cmd_dst = (uint64_t *)(cmdq->base + ((queue.prod & ((0x1ull << queue.log2nent) - 1)) * (cmdq->entry_size)));
-    for (i = 0; i < CMDQ_DWORDS_PER_ENT; ++i)
-        cmd_dst[i] = cmd[i];
-    queue.prod = smmu_inc_prod(&queue);
+    return (0x1ul << (q->log2nent + 1)) - 1;
+}
 
+static void smmu_cmdq_publish(smmu_cmd_queue_t *cmdq)
+{
 #ifndef TARGET_LINUX
     ArmExecuteMemoryBarrier();
 #endif
-    val_mmio_write((uint64_t)cmdq->prod_reg, queue.prod);
-
-    return ret;
+    val_mmio_write((uint64_t)cmdq->prod_reg, cmdq->queue.prod);
 }
 
-static int smmu_cmdq_issue_cmd(smmu_dev_t *smmu,
-                   uint8_t opcode)
+/**
+  @brief   Write a run of commands to the command queue. As many commands as
+           there are free slots are written before PROD is published, and
+           CONS is only read back from the SMMU when the cached copy says the
+           queue is full.
+  @param   smmu - SMMU the commands are written to
+  @param   cmds - commands, CMDQ_DWORDS_PER_ENT dwords each
+  @param   num  - number of commands
+  @return  0 on success, -1 if the queue stays full
+**/
+static int smmu_cmdq_write_batch(smmu_dev_t *smmu, uint64_t *cmds, uint32_t num)
 {
-    uint64_t cmd[CMDQ_DWORDS_PER_ENT];
+    uint32_t timeout;
+    uint32_t i, j;
+    uint32_t published;
+    uint64_t *cmd_dst;
+    smmu_cmd_queue_t *cmdq = &smmu->cmdq;
+    smmu_queue_t *queue = &cmdq->queue;
+
+    published = queue->prod;
+    for (i = 0; i < num; i++) {
+        if (smmu_queue_full(queue)) {
+            /* The SMMU can only free slots for commands it has been given */
+            if (queue->prod != published) {
+                smmu_cmdq_publish(cmdq);
+                published = queue->prod;
+            }
 
-    if (smmu_cmdq_build_cmd(cmd, opcode)) {
-        return -1;
+            timeout = SMMU_CMDQ_POLL_TIMEOUT;
+            do {
+                queue->cons = val_mmio_read((uint64_t)cmdq->cons_reg) & smmu_queue_ptr_mask(queue);
+            } while (smmu_queue_full(queue) && --timeout);
+
+            if (!timeout) {
+                val_print(ACS_PRINT_ERR, "\n       SMMU CMD queue is full     ", 0);
+                return -1;
+            }
+        }
+
+        cmd_dst = (uint64_t *)(cmdq->base +
+                  ((queue->prod & ((0x1ull << queue->log2nent) - 1)) * (cmdq->entry_size)));
+        for (j = 0; j < CMDQ_DWORDS_PER_ENT; ++j)
+            cmd_dst[j] = cmds[(i * CMDQ_DWORDS_PER_ENT) + j];
+        queue->prod = smmu_inc_prod(queue);
     }
 
-    return smmu_cmdq_write_cmd(smmu, cmd);
+    if (queue->prod != published)
+        smmu_cmdq_publish(cmdq);
+
+    return 0;
 }
 
-static void smmu_cmdq_poll_until_consumed(smmu_dev_t *smmu)
+static int smmu_cmdq_poll_until_consumed(smmu_dev_t *smmu)
 {
     uint32_t timeout = SMMU_CMDQ_POLL_TIMEOUT;
     smmu_cmd_queue_t *cmdq = &smmu->cmdq;
-    smmu_queue_t queue = {
-                .log2nent = smmu->cmdq.queue.log2nent,
-                .prod = val_mmio_read((uint64_t)smmu->cmdq.prod_reg),
-                .cons = val_mmio_read((uint64_t)smmu->cmdq.cons_reg)
-            };
+    smmu_queue_t *queue = &cmdq->queue;
 
     while (timeout > 0) {
-        if (smmu_queue_empty(&queue))
+        queue->cons = val_mmio_read((uint64_t)cmdq->cons_reg) & smmu_queue_ptr_mask(queue);
+        if (smmu_queue_empty(queue))
             break;
-        queue.cons = val_mmio_read((uint64_t)cmdq->cons_reg);
         timeout--;
     }
 
     if (!timeout) {
-        val_print(ACS_PRINT_ERR, "\n       CMDQ poll timeout at 0x%08x", queue.prod);
+        val_print(ACS_PRINT_ERR, "\n       CMDQ poll timeout at 0x%08x", queue->prod);
         val_print(ACS_PRINT_ERR, "\n       prod_reg = 0x%08x,",
 val_mmio_read((uint64_t)smmu->cmdq.prod_reg));
         val_print(ACS_PRINT_ERR, "\n       cons_reg = 0x%08x",
 val_mmio_read((uint64_t)smmu->cmdq.cons_reg));
         val_print(ACS_PRINT_ERR, "\n       gerror   = 0x%08x     ",
 val_mmio_read(smmu->base + SMMU_GERROR_OFFSET));
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+  @brief   Queue a command in a batch. A full batch is written out to the
+           command queue without a CMD_SYNC, the sync closing the batch
+           covers it.
+  @param   smmu   - SMMU the batch is for
+  @param   batch  - batch the command is added to
+  @param   opcode - command opcode
+  @return  0 on success, -1 on failure
+**/
+static int smmu_cmdq_batch_add(smmu_dev_t *smmu, smmu_cmdq_batch_t *batch, uint8_t opcode)
+{
+    /* Keep the last slot for the CMD_SYNC */
+    if (batch->num == SMMU_CMDQ_BATCH_MAX - 1) {
+        if (smmu_cmdq_write_batch(smmu, batch->cmds, batch->num))
+            return -1;
+        batch->num = 0;
     }
+
+    if (smmu_cmdq_build_cmd(&batch->cmds[batch->num * CMDQ_DWORDS_PER_ENT], opcode))
+        return -1;
+
+    batch->num++;
+    return 0;
+}
+
+/**
+  @brief   Close a batch with one CMD_SYNC, write it to the command queue and
+           wait until the SMMU has consumed it.
+  @param   smmu  - SMMU the batch is for
+  @param   batch - batch to submit, empty on return
+  @return  0 on success, -1 on failure
+**/
+static int smmu_cmdq_batch_submit(smmu_dev_t *smmu, smmu_cmdq_batch_t *batch)
+{
+    int ret;
+
+    smmu_cmdq_build_cmd(&batch->cmds[batch->num * CMDQ_DWORDS_PER_ENT], CMDQ_OP_CMD_SYNC);
+    batch->num++;
+
+    ret = smmu_cmdq_write_batch(smmu, batch->cmds, batch->num);
+    batch->num = 0;
+    if (ret)
+        return ret;
+
+    return smmu_cmdq_poll_until_consumed(smmu);
 }
 
 static void smmu_strtab_write_ste(smmu_master_t *master, uint64_t *ste)
@@ -654,16 +718,16 @@ static int smmu_dev_disable(smmu_dev_t *smmu)
 
 static void smmu_tlbi_cfgi(smmu_dev_t *smmu)
 {
+    smmu_cmdq_batch_t batch = { .num = 0 };
+
     /* Invalidate any cached configuration */
-    smmu_cmdq_issue_cmd(smmu, CMDQ_OP_CFGI_ALL);
+    smmu_cmdq_batch_add(smmu, &batch, CMDQ_OP_CFGI_ALL);
     if (smmu->supported.hyp) {
-        smmu_cmdq_issue_cmd(smmu, CMDQ_OP_TLBI_EL2_ALL);
+        smmu_cmdq_batch_add(smmu, &batch, CMDQ_OP_TLBI_EL2_ALL);
     }
 
-    smmu_cmdq_issue_cmd(smmu, CMDQ_OP_TLBI_NSNH_ALL);
-    smmu_cmdq_issue_cmd(smmu, CMDQ_OP_CMD_SYNC);
-
-    smmu_cmdq_poll_until_consumed(smmu);
+    smmu_cmdq_batch_add(smmu, &batch, CMDQ_OP_TLBI_NSNH_ALL);
+    smmu_cmdq_batch_submit(smmu, &batch);
 }
 
 static int smmu_reset(smmu_dev_t *smmu)
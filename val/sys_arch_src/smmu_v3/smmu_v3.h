@@ -56,6 +56,14 @@ typedef struct {
     uint32_t *cons_reg;
 } smmu_cmd_queue_t;
 
+/* Commands a batch holds, including the CMD_SYNC that closes it */
+#define SMMU_CMDQ_BATCH_MAX 16
+
+typedef struct {
+    uint64_t cmds[SMMU_CMDQ_BATCH_MAX * CMDQ_DWORDS_PER_ENT];
+    uint32_t num;
+} smmu_cmdq_batch_t;
+
 typedef struct {
     smmu_queue_t queue;
     void    *base_ptr;
@@ -0,0 +1,34 @@
+## @file
+ # Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ # SPDX-License-Identifier : Apache-2.0
+ #
+ # Licensed under the Apache License, Version 2.0 (the "License");
+ # you may not use this file except in compliance with the License.
+ # You may obtain a copy of the License at
+ #
+ #  http://www.apache.org/licenses/LICENSE-2.0
+ #
+ # Unless required by applicable law or agreed to in writing, software
+ # distributed under the License is distributed on an "AS IS" BASIS,
+ # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ # See the License for the specific language governing permissions and
+ # limitations under the License.
+ ##
+
+ # Only the architecture independent VAL sources are built for the host.
+ # The RISCV64 register accessors are provided by the host PAL.
+ file(GLOB VAL_SRC
+ "${ROOT_DIR}/val/src/*.c"
+)
+
+# Create VAL library
+add_library(${VAL_LIB} STATIC ${VAL_SRC})
+
+target_include_directories(${VAL_LIB} PRIVATE
+ ${ROOT_DIR}/
+ ${ROOT_DIR}/val/
+ ${ROOT_DIR}/val/include/
+ ${ROOT_DIR}/platform/pal_host/include/
+)
+
+unset(VAL_SRC)